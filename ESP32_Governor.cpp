@@ -0,0 +1,453 @@
+/***************************************************************************************************/
+/*
+   This is a frame-rate governor for the "ESP32_WS281x" library. Background FreeRTOS task
+   sends committed frames of one or more strips at fixed intervals
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#include "ESP32_Governor.h"
+
+
+/************************************************************************************/
+/*
+   Constructor
+
+   NOTE:
+   - fps, target frame rate 1..1000 frames per second, or GOVERNOR_FREE_RUN
+     (see "setFPS()")
+*/
+/************************************************************************************/
+ESP32_Governor::ESP32_Governor(uint16_t fps) : _isStarted(false), _numStrips(0), _timer(NULL), _task(NULL), _vsync(NULL), _listMutex(NULL), _frameCount(0), _missedFrames(0), _showTime(0)
+{
+  setFPS(fps);
+}
+
+
+/************************************************************************************/
+/*
+   Destructor
+
+   Stop governor task & release timer
+*/
+/************************************************************************************/
+ESP32_Governor::~ESP32_Governor()
+{
+  end();
+
+  for (uint8_t i = 0; i < _numStrips; i++) {_strips[i]->_governor = NULL;}
+
+  if (_vsync != NULL)     {vSemaphoreDelete(_vsync);}
+  if (_listMutex != NULL) {vSemaphoreDelete(_listMutex);}
+}
+
+
+/************************************************************************************/
+/*
+   begin()
+
+   Start periodic timer & governor task
+
+   NOTE:
+   - core, CPU core to pin the governor task to, use "tskNO_AFFINITY" to let
+     scheduler decide. Default is core 1 (same as Arduino "loop()")
+   - priority, governor task priority. Should be above render task priority
+     so frames are sent on time
+
+   - all strips must be constructed and "begin()" called before starting
+     the governor, see "espInit()"
+
+   - return true on success, false otherwise
+*/
+/************************************************************************************/
+bool ESP32_Governor::begin(BaseType_t core, UBaseType_t priority)
+{
+  if (_isStarted == true) {return true;}
+
+  if ((_vsync == NULL) && ((_vsync = xSemaphoreCreateBinary()) == NULL))         {return false;}
+  if ((_listMutex == NULL) && ((_listMutex = xSemaphoreCreateMutex()) == NULL)) {return false;}
+
+  esp_timer_create_args_t timerArgs;
+
+  timerArgs.callback              = &ESP32_Governor::timerCallback;
+  timerArgs.arg                   = this;
+  timerArgs.dispatch_method       = ESP_TIMER_TASK;
+  timerArgs.name                  = "ws281x_vsync";
+  timerArgs.skip_unhandled_events = false;                               //missed ticks are counted by governor task
+
+  if (esp_timer_create(&timerArgs, &_timer) != ESP_OK) {return false;}
+
+  _isStarted = true;
+
+  if (xTaskCreatePinnedToCore(&ESP32_Governor::governorTask, "ws281x_gov", GOVERNOR_STACK_SIZE, this, priority, &_task, core) != pdPASS)
+  {
+    log_e("Failed to create governor task");
+
+    _isStarted = false;
+    _task      = NULL;
+
+    esp_timer_delete(_timer);
+
+    _timer = NULL;
+
+    return false;
+  }
+
+  if (_fps != GOVERNOR_FREE_RUN) {esp_timer_start_periodic(_timer, 1000000UL / _fps);}
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   end()
+
+   Stop periodic timer & governor task
+
+   NOTE:
+   - frame currently being sent is completed before the task exits
+*/
+/************************************************************************************/
+void ESP32_Governor::end()
+{
+  if (_isStarted != true) {return;}
+
+  esp_timer_stop(_timer);
+  esp_timer_delete(_timer);
+
+  _timer     = NULL;
+  _isStarted = false;
+
+  xTaskNotifyGive(_task);                    //wake up task to let it exit
+
+  while (_task != NULL) {vTaskDelay(1);}     //task clears handle before deleting itself
+}
+
+
+/************************************************************************************/
+/*
+   addStrip()
+
+   Add "ESP32_WS281x" strip to the list of strips sent on every tick
+
+   NOTE:
+   - call before "begin()", strips can't be added while governor runs (they
+     can be removed, see "removeStrip()")
+
+   - strips are sent one after another in order they were added. Strips sharing
+     RMT channel (see "espShow()") are serialized by the RMT mutex, so sum of
+     their wire times must fit into the frame period
+
+   - return true on success, false if governor is running or list is full
+*/
+/************************************************************************************/
+bool ESP32_Governor::addStrip(ESP32_WS281x *strip)
+{
+  if ((_isStarted == true) || (strip == NULL) || (_numStrips >= GOVERNOR_MAX_STRIPS)) {return false;}
+
+  _strips[_numStrips++] = strip;
+
+  strip->_governor = this;                 //see "wakeUp()"
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   removeStrip()
+
+   Remove "ESP32_WS281x" strip from the list of strips sent on every tick
+
+   NOTE:
+   - safe while governor runs, waits until governor task is done with current
+     tick (frames on the wire included), so strip is never touched by the task
+     after return. Called by "ESP32_WS281x" destructor
+
+   - don't call from governor task itself
+
+   - return true on success, false if strip not found
+*/
+/************************************************************************************/
+bool ESP32_Governor::removeStrip(ESP32_WS281x *strip)
+{
+  bool result = false;
+  bool locked = (_listMutex != NULL) && (xSemaphoreTake(_listMutex, portMAX_DELAY) == pdTRUE); //mutex exists once "begin()" was called
+
+  for (uint8_t i = 0; i < _numStrips; i++)
+  {
+    if (_strips[i] == strip)
+    {
+      _numStrips--;
+
+      strip->_governor = NULL;
+
+      for (uint8_t j = i; j < _numStrips; j++) {_strips[j] = _strips[j + 1];} //keep sending order
+
+      result = true;
+
+      break;
+    }
+  }
+
+  if (locked == true) {xSemaphoreGive(_listMutex);}
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   setFPS()
+
+   Set target frame rate
+
+   NOTE:
+   - fps, frames per second 1..1000. Wire time of 1 RGB LED is 30 microseconds,
+     e.g. 300 LEDs strip can't be sent faster than ~110 fps
+
+   - GOVERNOR_FREE_RUN, no timer. Every "ESP32_WS281x::commit()" wakes up governor
+     task & committed strips are sent as soon as previous frames are on the wire.
+     Commits made meanwhile are coalesced, only the newest frame is sent (see
+     "ESP32_WS281x::getDroppedFrames()"). Useful if frames come from network
+     at their own rate, producer never blocks on the wire
+*/
+/************************************************************************************/
+void ESP32_Governor::setFPS(uint16_t fps)
+{
+  if (fps > 1000) {fps = 1000;}
+
+  _fps = fps;
+
+  if (_isStarted == true)
+  {
+    esp_timer_stop(_timer);
+
+    if (_fps != GOVERNOR_FREE_RUN) {esp_timer_start_periodic(_timer, 1000000UL / _fps);}
+  }
+}
+
+
+/************************************************************************************/
+/*
+   getFPS()
+
+   Retrieve target frame rate
+
+   NOTE:
+   - return frames per second 1..1000, GOVERNOR_FREE_RUN if sent on commit
+*/
+/************************************************************************************/
+const uint16_t ESP32_Governor::getFPS()
+{
+  return _fps;
+}
+
+
+/************************************************************************************/
+/*
+   waitFrame()
+
+   Block render task until governor has sent the next frame
+
+   NOTE:
+   - typical render loop: draw frame, call "commit()" on every strip, then call
+     "waitFrame()" to pace rendering at target frame rate
+
+   - only one task should wait, the vsync event is not broadcast
+
+   - timeoutMs, maximum time to wait, in milliseconds
+
+   - return true if frame was sent, false on timeout
+*/
+/************************************************************************************/
+bool ESP32_Governor::waitFrame(uint32_t timeoutMs)
+{
+  if (_vsync == NULL) {return false;}
+
+  return (xSemaphoreTake(_vsync, timeoutMs / portTICK_PERIOD_MS) == pdTRUE);
+}
+
+
+/************************************************************************************/
+/*
+   getFrameCount()
+
+   Retrieve number of ticks processed by governor task since "begin()"
+*/
+/************************************************************************************/
+const uint32_t ESP32_Governor::getFrameCount()
+{
+  return _frameCount;
+}
+
+
+/************************************************************************************/
+/*
+   getMissedFrames()
+
+   Retrieve number of missed deadlines since "begin()"
+
+   NOTE:
+   - tick is missed when previous tick is still sending, e.g. sum of wire times
+     of all strips exceeds the frame period, or governor task was starved by a
+     higher priority task
+
+   - not counted in free-run mode, see "ESP32_WS281x::getDroppedFrames()"
+*/
+/************************************************************************************/
+const uint32_t ESP32_Governor::getMissedFrames()
+{
+  return _missedFrames;
+}
+
+
+/************************************************************************************/
+/*
+   getShowTime()
+
+   Retrieve how long the last tick took to send all strips
+
+   NOTE:
+   - return time in microseconds
+*/
+/************************************************************************************/
+const uint32_t ESP32_Governor::getShowTime()
+{
+  return _showTime;
+}
+
+
+/************************************************************************************/
+/*
+   timerCallback()
+
+   Periodic timer callback, wakes up governor task
+
+   NOTE:
+   - runs in "esp_timer" task context. Notifications accumulate, so if governor
+     task is still busy the pending count tells how many ticks were missed
+*/
+/************************************************************************************/
+void ESP32_Governor::timerCallback(void *arg)
+{
+  ESP32_Governor *governor = (ESP32_Governor *)arg;
+
+  xTaskNotifyGive(governor->_task);
+}
+
+
+/************************************************************************************/
+/*
+   wakeUp()
+
+   Wake up governor task in free-run mode, called by "ESP32_WS281x::commit()"
+
+   NOTE:
+   - notifications accumulate while task is sending, task takes all of them at
+     once, so commits during wire time are coalesced into one send
+*/
+/************************************************************************************/
+void ESP32_Governor::wakeUp()
+{
+  TaskHandle_t task = _task;
+
+  if ((_isStarted == true) && (_fps == GOVERNOR_FREE_RUN) && (task != NULL)) {xTaskNotifyGive(task);}
+}
+
+
+/************************************************************************************/
+/*
+   governorTask()
+
+   Governor task, sends committed frames of all strips on every tick
+
+   NOTE:
+   - strip is sent only if application called "commit()" since last tick, strips
+     with dithering enabled are sent on every tick (see "setDithering()"). With
+     triple buffering committed frame is the fresh ready frame itself, so a
+     commit can't be lost between the check & "show()"
+
+   - in free-run mode task is woken up by "commit()" instead of timer, see
+     "setFPS()"
+
+   - all strips are started first & waited for once, so "getShowTime()"
+     includes wire time of the longest strip
+*/
+/************************************************************************************/
+void ESP32_Governor::governorTask(void *arg)
+{
+  ESP32_Governor *governor = (ESP32_Governor *)arg;
+  uint32_t        ticks    = 0;
+  uint32_t        start    = 0;
+
+  for (;;)
+  {
+    ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    if (governor->_isStarted != true) {break;}
+
+    if ((ticks > 1) && (governor->_fps != GOVERNOR_FREE_RUN)) {governor->_missedFrames += ticks - 1;} //see NOTE in "timerCallback()"
+
+    start = micros();
+
+    xSemaphoreTake(governor->_listMutex, portMAX_DELAY); //see "removeStrip()"
+
+    for (uint8_t i = 0; i < governor->_numStrips; i++)
+    {
+      ESP32_WS281x *strip = governor->_strips[i];
+
+      bool isCommitted = (strip->_frames != NULL) ? ((__atomic_load_n(&strip->_readyFrame, __ATOMIC_ACQUIRE) & LED_FRAME_FRESH) != 0) : strip->_isCommitted; //triple buffering, ready frame not picked up yet
+
+      if ((isCommitted == true) || (strip->getDithering() == true))
+      {
+        strip->_isCommitted = false;   //cleared before "show()", "commit()" landing meanwhile is sent on next tick
+
+        strip->show();
+      }
+    }
+
+    ESP32_WS281x::waitShow(governor->_strips, governor->_numStrips); //one wait for all strips, frames are on LEDs before vsync
+
+    xSemaphoreGive(governor->_listMutex);
+
+    governor->_showTime = micros() - start;
+    governor->_frameCount++;
+
+    xSemaphoreGive(governor->_vsync);
+  }
+
+  governor->_task = NULL;
+
+  vTaskDelete(NULL);
+}
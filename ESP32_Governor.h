@@ -0,0 +1,95 @@
+/***************************************************************************************************/
+/*
+   This is a frame-rate governor for the "ESP32_WS281x" library. Background FreeRTOS task
+   sends committed frames of one or more strips at fixed intervals
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+#ifndef ESP32_Governor_H
+#define ESP32_Governor_H
+
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+#include "ESP32_WS281x.h"
+
+
+#define GOVERNOR_MAX_STRIPS  8    //maximum number of strips driven by one governor
+#define GOVERNOR_STACK_SIZE  4096 //governor task stack size, in bytes
+#define GOVERNOR_FREE_RUN    0    //"fps" value, strips are sent on every "commit()" instead of timer ticks
+
+
+class ESP32_Governor
+{
+  friend class ESP32_WS281x;
+
+  public:
+  ESP32_Governor(uint16_t fps = 60);
+ ~ESP32_Governor();
+
+  bool                begin(BaseType_t core = 1, UBaseType_t priority = 2);
+  void                end();
+
+  bool                addStrip(ESP32_WS281x *strip);
+  bool                removeStrip(ESP32_WS281x *strip);
+  void                setFPS(uint16_t fps);
+  const  uint16_t     getFPS();
+  bool                waitFrame(uint32_t timeoutMs = 1000);
+
+  const  uint32_t     getFrameCount();
+  const  uint32_t     getMissedFrames();
+  const  uint32_t     getShowTime();
+
+
+private:
+  static void         timerCallback(void *arg);
+  static void         governorTask(void *arg);
+  void                wakeUp();
+
+protected:
+  volatile bool       _isStarted;                    //true if "begin()" previously called
+  uint16_t            _fps;                          //target frame rate, frames per second, GOVERNOR_FREE_RUN if sent on commit
+  uint8_t             _numStrips;                    //number of strips in "_strips" below
+  ESP32_WS281x*       _strips[GOVERNOR_MAX_STRIPS];  //strips sent on every tick
+  esp_timer_handle_t  _timer;                        //periodic tick source
+  TaskHandle_t        _task;                         //governor task handle, NULL if not running
+  SemaphoreHandle_t   _vsync;                        //given after every tick, see "waitFrame()"
+  SemaphoreHandle_t   _listMutex;                    //held by governor task while strips are sent, see "removeStrip()"
+  uint32_t            _frameCount;                   //number of ticks processed
+  uint32_t            _missedFrames;                 //number of ticks missed (previous tick still transmitting)
+  uint32_t            _showTime;                     //duration of last tick, in microseconds
+
+};
+
+#endif
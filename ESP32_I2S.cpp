@@ -0,0 +1,805 @@
+/***************************************************************************************************/
+/*
+   This is an I2S/LCD parallel output backend for the "ESP32_WS281x" library. It
+   clocks out up to 16 strips at once by one DMA transfer over I2S (ESP32) or
+   LCD_CAM (ESP32-S3) peripheral in Intel 8080 (i80) mode
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_I2S.h"
+#include "ESP32_Transpose.h"
+
+#if SOC_LCD_I80_SUPPORTED
+#include <esp_lcd_panel_io.h>
+#endif
+
+
+/************************************************************************************/
+/*
+   Local defines & variables
+*/
+/************************************************************************************/
+#define SEMAPHORE_TIMEOUT_MS 50
+#define ESP_I2S_PCLK_HZ      2400000 //3 slots per bit, 1 slot = 417ns, see "espI2sEncode()"
+#define ESP_I2S_SLOTS        24      //slots per byte, 8 bits * 3 slots
+#define ESP_I2S_LATCH_SLOTS  720     //300us low after frame, 720 * 417ns
+
+static int8_t _i2sClockPin = -1;     //pin of WR (pixel clock) signal, see "espI2sSetClockPin()"
+static int8_t _i2sDcPin    = -1;     //pin of D/C signal & unused data lines, see "espI2sSetDcPin()"
+static bool   _i2sIncremental = false; //encode only changed bytes, see "espI2sSetIncremental()"
+
+#if SOC_LCD_I80_SUPPORTED
+static SemaphoreHandle_t         _i2sMutex    = NULL;
+static esp_lcd_i80_bus_handle_t  _i2sBus      = NULL;         //i80 bus, NULL if not attached
+static esp_lcd_panel_io_handle_t _i2sIo       = NULL;         //panel IO of "_i2sBus", sends the slots
+static uint8_t                   _i2sPins[ESP_I2S_MAX_PINS];  //data pins of attached bus, bus line = index in list
+static uint8_t                   _i2sNumPins  = 0;            //number of pins in "_i2sPins"
+static uint8_t                   _i2sOwners   = 0;            //number of owners of attached bus, see "espI2sAcquireChannel()", 0 if time-shared
+static uint32_t                  _i2sBusSize  = 0;            //maximum transfer size of attached bus, in bytes
+static uint8_t*                  _i2sData     = NULL;         //DMA buffer with slots of all pins, shared between all instances
+static uint32_t                  _i2sDataSize = 0;            //size of "_i2sData", in bytes
+static uint16_t                  _i2sDataRefs = 0;            //number of "espI2sAcquire()" calls without "espI2sRelease()"
+static uint32_t                  _i2sWireTimeMs = 0;          //wire time of last "espI2sShow()", in milliseconds
+static const uint8_t*            _i2sLastPixels = NULL;       //pixel buffer of frame in "_i2sData", see "espI2sSetIncremental()"
+static espEncoder_t              _i2sLastEncoder;             //encoder settings of frame in "_i2sData"
+static uint32_t                  _i2sLastBytes[ESP_I2S_MAX_PINS]; //part sizes of frame in "_i2sData"
+static uint8_t                   _i2sLastPins = 0;            //number of parts of frame in "_i2sData", 0 if slots are not valid
+
+
+/************************************************************************************/
+/*
+   espI2sDoneCallback()
+
+   i80 "color transfer done" interrupt handler, marks I2S output as idle
+
+   NOTE:
+   - DMA transfer includes latch, see "espI2sEncode()"
+*/
+/************************************************************************************/
+static bool IRAM_ATTR espI2sDoneCallback(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *eventData, void *userCtx)
+{
+  BaseType_t taskWoken = pdFALSE;
+
+  xEventGroupSetBitsFromISR(espGetDoneEvents(), ESP_DONE_BIT_I2S, &taskWoken);
+
+  return (taskWoken == pdTRUE);
+}
+
+
+/************************************************************************************/
+/*
+   espI2sSize()
+
+   Size of DMA buffer for parts of given size
+
+   NOTE:
+   - all parts are sent in parallel, so buffer follows the longest part. Bus
+     word is 8-bit for up to 8 pins & 16-bit for more pins
+
+   - return size in bytes, 0xFFFFFFFF if parts are too long
+*/
+/************************************************************************************/
+static uint32_t espI2sSize(const uint32_t *numBytes, uint8_t numPins)
+{
+  uint32_t maxBytes = 0;
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    if (numBytes[i] > maxBytes) {maxBytes = numBytes[i];}
+  }
+
+  uint64_t size = ((uint64_t)maxBytes * ESP_I2S_SLOTS + ESP_I2S_LATCH_SLOTS) * ((numPins > 8) ? 2 : 1);
+
+  return (size > 0xFFFFFFFF) ? 0xFFFFFFFF : size;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sWaitIdle()
+
+   Wait until I2S output is idle, so DMA buffer is not read
+
+   NOTE:
+   - timeout follows wire time of the last "espI2sShow()"
+
+   - return true if output is idle, false on timeout
+*/
+/************************************************************************************/
+static bool espI2sWaitIdle()
+{
+  return espWaitDone(ESP_DONE_BIT_I2S, _i2sWireTimeMs + SEMAPHORE_TIMEOUT_MS);
+}
+
+
+/************************************************************************************/
+/*
+   espI2sResize()
+
+   Grow DMA buffer
+
+   NOTE:
+   - buffer only grows & is replaced only after output is idle, old slots are
+     not kept
+
+   - call with "_i2sMutex" taken
+
+   - requiredSize, size in bytes
+*/
+/************************************************************************************/
+static void espI2sResize(uint32_t requiredSize)
+{
+  if (requiredSize <= _i2sDataSize) {return;}
+
+  if (espI2sWaitIdle() != true) {return;}            //buffer is still in use, keep it
+
+  heap_caps_free(_i2sData);
+
+  _i2sLastPins = 0;                                  //slots are lost
+
+  if ((_i2sData = (uint8_t *)heap_caps_malloc(requiredSize, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)) != NULL)
+  {
+    _i2sDataSize = requiredSize;
+  }
+  else
+  {
+    _i2sDataSize = 0;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espI2sDetach()
+
+   Release i80 bus
+
+   NOTE:
+   - waits until output is idle, frame on the wire is never cut off
+*/
+/************************************************************************************/
+static void espI2sDetach()
+{
+  if (_i2sBus == NULL) {return;}
+
+  espWaitDone(ESP_DONE_BIT_I2S, portMAX_DELAY);      //teardown must not be skipped
+
+  esp_lcd_panel_io_del(_i2sIo);
+  esp_lcd_del_i80_bus(_i2sBus);
+
+  _i2sIo      = NULL;
+  _i2sBus     = NULL;
+  _i2sBusSize = 0;
+  _i2sNumPins = 0;
+  _i2sOwners  = 0;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sAttach()
+
+   Create i80 bus for the pins
+
+   NOTE:
+   - bus with the same pins is kept, otherwise time-shared bus is released
+     first. Bus is created again if DMA buffer has grown, bus transfer size
+     is fixed
+
+   - pins, list of data pins, bus line = index in list. Bus is 8 bits wide for
+     up to 8 pins & 16 bits wide for more pins, unused lines are routed to D/C
+     pin, see "espI2sSetDcPin()"
+   - numPins, number of pins in list
+
+   - return true on success, false if bus is owned by other pins, clock or D/C
+     pin is not set or bus can't be initialized
+*/
+/************************************************************************************/
+static bool espI2sAttach(const uint8_t *pins, uint8_t numPins)
+{
+  bool samePins = (_i2sBus != NULL) && (numPins == _i2sNumPins);
+
+  for (uint8_t i = 0; (samePins == true) && (i < numPins); i++)
+  {
+    if (_i2sPins[i] != pins[i]) {samePins = false;}
+  }
+
+  if ((samePins == true) && (_i2sBusSize >= _i2sDataSize)) {return true;}
+
+  if ((_i2sOwners > 0) && (samePins != true)) {return false;} //bus is owned by other strip
+
+  if (_i2sClockPin < 0)
+  {
+    log_e("I2S clock pin is not set, see espI2sSetClockPin()");
+
+    return false;
+  }
+
+  if (_i2sDcPin < 0)
+  {
+    log_e("I2S D/C pin is not set, see espI2sSetDcPin()");
+
+    return false;
+  }
+
+  uint8_t owners = (samePins == true) ? _i2sOwners : 0;
+
+  espI2sDetach();
+
+  esp_lcd_i80_bus_config_t      busConfig = {};
+  esp_lcd_panel_io_i80_config_t ioConfig  = {};
+
+  busConfig.dc_gpio_num        = _i2sDcPin;          //required by driver, frame is sent as color data
+  busConfig.wr_gpio_num        = _i2sClockPin;
+  busConfig.clk_src            = LCD_CLK_SRC_DEFAULT;
+  busConfig.bus_width          = (numPins > 8) ? 16 : 8;
+  busConfig.max_transfer_bytes = _i2sDataSize;
+
+  for (uint8_t i = 0; i < busConfig.bus_width; i++)
+  {
+    busConfig.data_gpio_nums[i] = (i < numPins) ? pins[i] : _i2sDcPin; //driver rejects unrouted lines, D/C is routed last & keeps the pin
+  }
+
+  ioConfig.cs_gpio_num         = -1;
+  ioConfig.pclk_hz             = ESP_I2S_PCLK_HZ;
+  ioConfig.trans_queue_depth   = 1;                  //one transaction per "espI2sShow()"
+  ioConfig.on_color_trans_done = espI2sDoneCallback;
+  ioConfig.lcd_cmd_bits        = 8;
+  ioConfig.lcd_param_bits      = 8;
+
+  if (esp_lcd_new_i80_bus(&busConfig, &_i2sBus) != ESP_OK)
+  {
+    _i2sBus = NULL;
+
+    log_e("Failed to init I2S/LCD bus");
+
+    return false;
+  }
+
+  if (esp_lcd_new_panel_io_i80(_i2sBus, &ioConfig, &_i2sIo) != ESP_OK)
+  {
+    esp_lcd_del_i80_bus(_i2sBus);
+
+    _i2sBus = NULL;
+    _i2sIo  = NULL;
+
+    log_e("Failed to init I2S/LCD panel IO");
+
+    return false;
+  }
+
+  for (uint8_t i = 0; i < numPins; i++) {_i2sPins[i] = pins[i];}
+
+  _i2sNumPins = numPins;
+  _i2sOwners  = owners;
+  _i2sBusSize = _i2sDataSize;
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sEncode()
+
+   Convert parts of pixel color buffer to bus slots, one bus line per part
+
+   NOTE:
+   - every bit takes 3 slots (1 slot = 417ns): high, data, low. So bit 0 =
+     417ns high & 833ns low, bit 1 = 833ns high & 417ns low
+
+   - slot word has one bit per line, so data slots are bytes of all parts
+     transposed to bit planes, see "espTransposeParts()". Part shorter than
+     the longest one stays low after its end (high slot is not set), frame
+     ends with latch slots
+
+   - high, low & latch slots follow sizes of parts only. With dirtyOnly =
+     true they are kept & only data slots of bytes in dirty range of encoder
+     (see "espEncoder_t") are written
+
+   - every part must start at pixel boundary, see "espShow()"
+
+   - out, DMA buffer, see "espI2sSize()"
+   - wordSize, 1 for 8-bit bus, 2 for 16-bit bus
+   - dirtyOnly, true if out holds previous frame of the same pixel buffer,
+     sizes of parts & encoder settings. Encoder must not be NULL
+*/
+/************************************************************************************/
+static void espI2sEncode(uint8_t *out, uint8_t wordSize, const uint8_t *pixels, const uint32_t *numBytes, uint8_t numPins, const espEncoder_t *encoder, bool dirtyOnly)
+{
+  const uint8_t *parts[ESP_I2S_MAX_PINS];
+  uint32_t       maxBytes = 0;
+  uint32_t       offset   = 0;                       //offset of part in pixel buffer
+  uint32_t       first    = (dirtyOnly == true) ? 0xFFFFFFFF : 0; //dirty byte indices of all parts, see "espTransposeParts()"
+  uint32_t       last     = (dirtyOnly == true) ? 0 : 0xFFFFFFFF;
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    parts[i] = pixels;
+    pixels  += numBytes[i];
+
+    if (numBytes[i] > maxBytes) {maxBytes = numBytes[i];}
+
+    if ((dirtyOnly == true) && (numBytes[i] > 0) && (encoder->dirtyFirst < (offset + numBytes[i])) && (encoder->dirtyLast >= offset) && (encoder->dirtyFirst <= encoder->dirtyLast)) //part overlaps dirty range
+    {
+      uint32_t partFirst = (encoder->dirtyFirst > offset) ? (encoder->dirtyFirst - offset) : 0;
+      uint32_t partLast  = ((encoder->dirtyLast - offset) < numBytes[i]) ? (encoder->dirtyLast - offset) : (numBytes[i] - 1);
+
+      if (partFirst < first) {first = partFirst;}
+      if (partLast  > last)  {last  = partLast;}
+    }
+
+    offset += numBytes[i];
+  }
+
+  if (dirtyOnly != true)
+  {
+    uint32_t slot = 0;
+
+    for (uint32_t b = 0; b < maxBytes; b++)
+    {
+      uint16_t active = 0;                           //lines with data, high slot
+
+      for (uint8_t i = 0; i < numPins; i++)
+      {
+        if (b < numBytes[i]) {active |= (1 << i);}
+      }
+
+      for (uint8_t bit = 0; bit < 8; bit++, slot += 3) //data slot is written by "espTransposeParts()"
+      {
+        if (wordSize == 1)
+        {
+          out[slot]     = active;
+          out[slot + 2] = 0;
+        }
+        else
+        {
+          ((uint16_t *)out)[slot]     = active;
+          ((uint16_t *)out)[slot + 2] = 0;
+        }
+      }
+    }
+
+    memset(&out[slot * wordSize], 0, ESP_I2S_LATCH_SLOTS * wordSize); //latch
+  }
+
+  espTransposeParts(&out[wordSize], wordSize, 3, parts, numBytes, numPins, encoder, first, last);
+}
+
+
+/************************************************************************************/
+/*
+   espI2sReserve()
+
+   Allocate DMA buffer for parts of given size in advance, see "espReserve()"
+
+   NOTE:
+   - owned bus is created again if DMA buffer has grown, "espI2sShow()" of
+     realtime strip never attaches the bus, see "espI2sAttach()"
+
+   - return true on success, false if out of memory, buffer is still in use,
+     owned bus can't be created again or mutex is not available
+*/
+/************************************************************************************/
+static bool espI2sReserve(const uint32_t *numBytes, uint8_t numPins)
+{
+  bool     result       = false;
+  uint32_t requiredSize = espI2sSize(numBytes, numPins);
+
+  if (requiredSize == 0xFFFFFFFF) {return false;}
+
+  if (_i2sMutex && xSemaphoreTake(_i2sMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    espI2sResize(requiredSize);
+
+    result = (_i2sDataSize >= requiredSize);
+
+    if ((result == true) && (_i2sOwners > 0) && (_i2sBusSize < _i2sDataSize)) //same pins, owners are kept
+    {
+      result = espI2sAttach(_i2sPins, _i2sNumPins);
+    }
+
+    xSemaphoreGive(_i2sMutex);
+  }
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sAcquire()
+
+   Take reference to shared DMA buffer & allocate it for parts of given size,
+   see "espAcquire()"
+
+   NOTE:
+   - mutex is created on first call, so all instances using I2S output must
+     be started before launching child threads, see "espInit()"
+*/
+/************************************************************************************/
+static bool espI2sAcquire(const uint32_t *numBytes, uint8_t numPins)
+{
+  espInit();                                         //"transaction done" event group
+
+  if (_i2sMutex == NULL) {_i2sMutex = xSemaphoreCreateMutex();}
+
+  if (_i2sMutex && xSemaphoreTake(_i2sMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    _i2sDataRefs++;
+
+    xSemaphoreGive(_i2sMutex);
+  }
+  else
+  {
+    return false;
+  }
+
+  return espI2sReserve(numBytes, numPins);
+}
+
+
+/************************************************************************************/
+/*
+   espI2sRelease()
+
+   Give back reference to shared DMA buffer, see "espRelease()"
+
+   NOTE:
+   - last reference frees DMA buffer & time-shared bus, owned bus stays until
+     its owners release it
+*/
+/************************************************************************************/
+static void espI2sRelease()
+{
+  if (_i2sMutex && xSemaphoreTake(_i2sMutex, portMAX_DELAY) == pdTRUE) //teardown must not be skipped
+  {
+    if (_i2sDataRefs > 0) {_i2sDataRefs--;}
+
+    if (_i2sDataRefs == 0)
+    {
+      if (_i2sOwners == 0) {espI2sDetach();}
+
+      espWaitDone(ESP_DONE_BIT_I2S, portMAX_DELAY);
+
+      heap_caps_free(_i2sData);
+
+      _i2sData      = NULL;
+      _i2sDataSize  = 0;
+      _i2sLastPins  = 0;
+    }
+
+    xSemaphoreGive(_i2sMutex);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espI2sAcquireChannel()
+
+   Attach i80 bus to the pins & keep it until "espI2sReleaseChannel()"
+
+   NOTE:
+   - there is only one bus, so only strips with the same pins may own it &
+     bus is released by last owner. Other strips can't use I2S output while
+     bus is owned
+
+   - return true on success, false if bus can't be attached or mutex is not
+     available
+*/
+/************************************************************************************/
+static bool espI2sAcquireChannel(const uint8_t *pins, uint8_t numPins)
+{
+  bool result = false;
+
+  if (numPins > ESP_I2S_MAX_PINS) {return false;}
+
+  if (_i2sMutex && xSemaphoreTake(_i2sMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    if ((result = espI2sAttach(pins, numPins)) == true) {_i2sOwners++;}
+
+    xSemaphoreGive(_i2sMutex);
+  }
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sReleaseChannel()
+
+   Give back i80 bus owned by "espI2sAcquireChannel()"
+*/
+/************************************************************************************/
+static void espI2sReleaseChannel(const uint8_t *pins, uint8_t numPins)
+{
+  if (_i2sMutex && xSemaphoreTake(_i2sMutex, portMAX_DELAY) == pdTRUE) //teardown must not be skipped
+  {
+    if (_i2sOwners > 0) {_i2sOwners--;}            //all owners have the same pins, see "espI2sAcquireChannel()"
+
+    if ((_i2sOwners == 0) && (_i2sDataRefs == 0)) {espI2sDetach();}
+
+    xSemaphoreGive(_i2sMutex);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espI2sGetDoneBits()
+
+   Get "transaction done" bit of the pins, see "espGetDoneBits()"
+
+   NOTE:
+   - return ESP_DONE_BIT_I2S if bus is attached to the pins, 0 otherwise
+*/
+/************************************************************************************/
+static EventBits_t espI2sGetDoneBits(const uint8_t *pins, uint8_t numPins)
+{
+  for (uint8_t i = 0; i < _i2sNumPins; i++)
+  {
+    for (uint8_t j = 0; j < numPins; j++)
+    {
+      if (_i2sPins[i] == pins[j]) {return ESP_DONE_BIT_I2S;}
+    }
+  }
+
+  return 0;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sShow()
+
+   Send consecutive parts of pixel color buffer (data) to several pins in
+   parallel via I2S/LCD peripheral
+
+   NOTE:
+   - same as "espShow()", but all parts are sent by one DMA transfer & wire
+     time is the wire time of the longest part
+
+   - returns as soon as transfer is started, output is marked idle by
+     "espI2sDoneCallback()" after latch
+
+   - return true if frame is started, false if frame is dropped
+*/
+/************************************************************************************/
+static bool espI2sShow(const uint8_t *pins, uint8_t numPins, uint8_t *pixels, const uint32_t *numBytes, const espEncoder_t *encoder, bool realtime)
+{
+  bool     result       = false;
+  uint32_t maxBytes     = 0;
+  uint32_t requiredSize = 0;
+
+  if (numPins > ESP_I2S_MAX_PINS) {numPins = ESP_I2S_MAX_PINS;}
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    if (numBytes[i] > maxBytes) {maxBytes = numBytes[i];}
+  }
+
+  if (maxBytes == 0) {return true;}                 //nothing to send
+
+  if ((requiredSize = espI2sSize(numBytes, numPins)) == 0xFFFFFFFF) {return false;}
+
+  if (_i2sMutex && xSemaphoreTake(_i2sMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    if (realtime != true)                            //strip wasn't reserved, see "espI2sReserve()"
+    {
+      espI2sResize(requiredSize);
+    }
+
+    bool attached = (_i2sBus != NULL) && (_i2sNumPins == numPins) && (_i2sBusSize >= requiredSize);
+
+    for (uint8_t i = 0; (attached == true) && (i < numPins); i++)
+    {
+      if (_i2sPins[i] != pins[i]) {attached = false;}
+    }
+
+    if ((requiredSize <= _i2sDataSize) && (espI2sWaitIdle() == true) && ((attached == true) || ((realtime != true) && (espI2sAttach(pins, numPins) == true))))
+    {
+      bool dirtyOnly = (_i2sIncremental == true) && (encoder != NULL) && (_i2sLastPins == numPins) && (_i2sLastPixels == pixels) &&
+                       (_i2sLastEncoder.lut == encoder->lut) && (_i2sLastEncoder.bytesPerPixel == encoder->bytesPerPixel) && (_i2sLastEncoder.scale == encoder->scale) &&
+                       (memcmp(_i2sLastBytes, numBytes, numPins * sizeof(uint32_t)) == 0); //slots hold previous frame of this buffer
+
+      espI2sEncode(_i2sData, (numPins > 8) ? 2 : 1, pixels, numBytes, numPins, encoder, dirtyOnly);
+
+      _i2sLastPins   = (encoder != NULL) ? numPins : 0;  //dirty range needs encoder, see "espEncoder_t"
+      _i2sLastPixels = pixels;
+
+      if (encoder != NULL) {_i2sLastEncoder = *encoder;}
+
+      memcpy(_i2sLastBytes, numBytes, numPins * sizeof(uint32_t));
+
+      xEventGroupClearBits(espGetDoneEvents(), ESP_DONE_BIT_I2S);
+
+      if (esp_lcd_panel_io_tx_color(_i2sIo, -1, _i2sData, requiredSize) == ESP_OK) //-1 = no command phase
+      {
+        _i2sWireTimeMs = (uint32_t)(((uint64_t)maxBytes * 8 * 12 + 3000) / 10000) + 1; //same as RMT, 1.2us per bit + 300us latch
+        result         = true;
+      }
+      else
+      {
+        xEventGroupSetBits(espGetDoneEvents(), ESP_DONE_BIT_I2S);
+
+        log_e("Failed to send I2S/LCD data");
+      }
+    }
+
+    xSemaphoreGive(_i2sMutex);
+  }
+
+  return result;
+}
+
+#else //no i80 bus on this chip, every call fails
+
+static bool        espI2sAcquire(const uint32_t *numBytes, uint8_t numPins) {return false;}
+static void        espI2sRelease() {}
+static bool        espI2sReserve(const uint32_t *numBytes, uint8_t numPins) {return false;}
+static bool        espI2sAcquireChannel(const uint8_t *pins, uint8_t numPins) {return false;}
+static void        espI2sReleaseChannel(const uint8_t *pins, uint8_t numPins) {}
+static bool        espI2sShow(const uint8_t *pins, uint8_t numPins, uint8_t *pixels, const uint32_t *numBytes, const espEncoder_t *encoder, bool realtime) {return false;}
+static EventBits_t espI2sGetDoneBits(const uint8_t *pins, uint8_t numPins) {return 0;}
+
+#endif
+
+
+/************************************************************************************/
+/*
+   espI2sSetClockPin()
+
+   Set pin of WR (pixel clock) signal of i80 bus
+
+   NOTE:
+   - peripheral can't run without clock pin, so one spare pin is required
+     besides D/C pin (see "espI2sSetDcPin()"). Don't connect it to strips
+
+   - call before first "show()" of strip with I2S output, new pin is used when
+     bus is created next time
+
+   - pin, Arduino pin number
+*/
+/************************************************************************************/
+void espI2sSetClockPin(int8_t pin)
+{
+  _i2sClockPin = pin;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sGetClockPin()
+
+   Retrieve pin of WR (pixel clock) signal, -1 if not set
+*/
+/************************************************************************************/
+const int8_t espI2sGetClockPin()
+{
+  return _i2sClockPin;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sSetDcPin()
+
+   Set pin of D/C (data/command) signal of i80 bus
+
+   NOTE:
+   - i80 driver can't run without D/C pin & routes every line of the bus to
+     a pin, so one more spare pin is required next to the clock pin. Unused
+     data lines of 8/16-bit bus are routed to it as well, D/C signal takes
+     over the pin. Don't connect it to strips
+
+   - call before first "show()" of strip with I2S output, new pin is used when
+     bus is created next time
+
+   - pin, Arduino pin number
+*/
+/************************************************************************************/
+void espI2sSetDcPin(int8_t pin)
+{
+  _i2sDcPin = pin;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sGetDcPin()
+
+   Retrieve pin of D/C signal, -1 if not set
+*/
+/************************************************************************************/
+const int8_t espI2sGetDcPin()
+{
+  return _i2sDcPin;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sSetIncremental()
+
+   Turn incremental encoding on/off
+
+   NOTE:
+   - only bytes of pixels changed since previous frame (see "ESP32_WS281x::getDirtyRange()")
+     are transposed to DMA buffer, clean spans are skipped without reading
+     them, see "espTransposeParts()". Saves CPU time when only few pixels
+     change between frames, no extra RAM
+
+   - whole frame is encoded if DMA buffer holds frame of another strip, sizes
+     of parts or encoder settings (e.g. power limiter scale) changed, & with
+     dithering, 16-bit channels or triple buffering
+
+   - pixels written directly via "getRibbonColor()" pointer are not in dirty
+     range, mark them with "ESP32_WS281x::setDirtyRange()"
+
+   - off by default
+*/
+/************************************************************************************/
+void espI2sSetIncremental(bool incremental)
+{
+  _i2sIncremental = incremental;
+}
+
+
+/************************************************************************************/
+/*
+   espI2sGetIncremental()
+
+   Retrieve incremental encoding state
+*/
+/************************************************************************************/
+const bool espI2sGetIncremental()
+{
+  return _i2sIncremental;
+}
+
+
+/* I2S/LCD parallel output backend, see "ESP32_WS281x::setOutput()" */
+const espOutput_t espOutputI2S =
+{
+  espI2sAcquire,
+  espI2sRelease,
+  espI2sReserve,
+  espI2sAcquireChannel,
+  espI2sReleaseChannel,
+  espI2sShow,
+  espI2sGetDoneBits,
+  ESP_I2S_MAX_PINS
+};
@@ -0,0 +1,61 @@
+/***************************************************************************************************/
+/*
+   This is an I2S/LCD parallel output backend for the "ESP32_WS281x" library. It
+   clocks out up to 16 strips at once by one DMA transfer over I2S (ESP32) or
+   LCD_CAM (ESP32-S3) peripheral in Intel 8080 (i80) mode
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef ESP32_I2S_H
+#define ESP32_I2S_H
+
+
+#include <Arduino.h>
+
+#include "ESP32_RMT.h"
+
+
+#define ESP_I2S_MAX_PINS ESP_OUTPUT_MAX_PINS //maximum number of pins, width of i80 data bus 8 or 16 bits
+
+
+void espI2sSetClockPin(int8_t pin);
+const int8_t espI2sGetClockPin();
+void espI2sSetDcPin(int8_t pin);
+const int8_t espI2sGetDcPin();
+void espI2sSetIncremental(bool incremental);
+const bool espI2sGetIncremental();
+
+extern const espOutput_t espOutputI2S; //I2S/LCD parallel backend, see "ESP32_WS281x::setOutput()"
+
+#endif
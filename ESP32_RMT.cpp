@@ -44,136 +44,1470 @@
 */
 /************************************************************************************/
 #define SEMAPHORE_TIMEOUT_MS 50
+#define ESP_RMT_DONE_BIT(slot) ((EventBits_t)1 << (slot))                 //"_doneEvents" bit of channel slot
+#define ESP_RMT_DONE_ALL       (((EventBits_t)1 << ESP_RMT_MAX_PINS) - 1) //"_doneEvents" bits of all channel slots
+#define ESP_RMT_CACHE_BITS     4                                          //encoder cache holds 2^bits pixels, up to 5 (32-bit "valid" mask), see "espSetCache()"
+#define ESP_RMT_CACHE_SIZE     (1 << ESP_RMT_CACHE_BITS)
+#define ESP_RMT_CACHE_BYTES    5                                          //largest pixel kept in encoder cache, bytes (LED_MAX_CHANNELS)
+#define ESP_RMT_CACHE_MISSES   (2 * ESP_RMT_CACHE_SIZE)                   //consecutive misses that turn cache off for rest of the part, see "espEncodeCached()"
+#define ESP_RLE_CHUNK_PIXELS   4                                          //pixels of one run handed to copy encoder at once, see "espRleEncode()"
 
-static SemaphoreHandle_t _showMutex = NULL;
+typedef struct
+{
+  rmt_encoder_t        base;          //encoder interface, must be first, see "__containerof()"
+  rmt_encoder_handle_t copy;          //copy encoder of chunk & latch symbols, keeps its position between RMT memory refills
+  espRun_t*            runs;          //runs of current frame, read from RMT ISR until transaction is done
+  uint32_t             runsSize;      //size of "runs", in runs
+  uint8_t              bytesPerPixel; //bytes per pixel of current frame
+  uint32_t             run;           //index of run being sent
+  uint32_t             sent;          //pixels of run already sent
+  uint32_t             pending;       //pixels of chunk handed to "copy" & not completed yet, 0 if none
+  uint8_t              chunkFill;     //pixels encoded in "chunk", 0 if empty
+  uint8_t              chunkPixel[ESP_RLE_MAX_BYTES];                      //pixel encoded in "chunk"
+  rmt_symbol_word_t    chunk[ESP_RLE_CHUNK_PIXELS * ESP_RLE_MAX_BYTES * 8]; //RMT symbols of one pixel repeated "chunkFill" times
+  rmt_symbol_word_t    latch;         //latch symbol sent after last run
+} espRleEncoder_t;
+
+typedef struct
+{
+  int                  pin;     //GPIO number of attached channel
+  uint8_t              owners;  //number of owners, see "espAcquireChannel()", 0 if time-shared
+  rmt_channel_handle_t channel; //RMT TX channel, NULL if slot is free
+  rmt_encoder_handle_t encoder; //copy encoder of the channel, copy encoder keeps transaction state & can't be shared
+  rmt_encoder_handle_t rle;     //run-length encoder of the channel, NULL until first "espShowRLE()"
+} espChannel_t;
+
+static SemaphoreHandle_t  _showMutex  = NULL;
+static EventGroupHandle_t _doneEvents = NULL;                //one bit per channel slot, set while slot is idle
+
+static rmt_symbol_word_t* _ledData     = NULL;               //RMT symbols of all pins, shared between all instances
+static uint32_t           _ledDataSize = 0;                  //size of "_ledData", in symbols
+static uint16_t           _ledDataRefs = 0;                  //number of "espAcquire()" calls without "espRelease()"
+static uint32_t           _wireTimeMs  = 0;                  //wire time of the longest part sent by last "espShow()", in milliseconds
+static espChannel_t       _rmtChannels[ESP_RMT_MAX_PINS];    //attached RMT TX channels, slot index = "_doneEvents" bit
+
+static bool               _cacheEnabled = true;              //see "espSetCache()"
+static uint64_t           _cacheKeys[ESP_RMT_CACHE_SIZE];    //pixel bytes of cached entry, MSB first
+static rmt_symbol_word_t  _cacheSymbols[ESP_RMT_CACHE_SIZE][ESP_RMT_CACHE_BYTES * 8]; //RMT symbols of cached pixel
+static uint32_t           _cacheHits    = 0;                 //pixels copied from encoder cache, see "espGetCacheStats()"
+static uint32_t           _cacheMisses  = 0;                 //pixels encoded bit by bit
+
+
+/************************************************************************************/
+/*
+   espEncodeByte()
+
+   Convert one byte to 8 RMT symbols, MSB first
+
+   NOTE:
+   - RMT resolution 10MHz, 1 tick = 100ns
+   - bit 0 = 400ns high & 800ns low, bit 1 = 800ns high & 400ns low
+*/
+/************************************************************************************/
+static inline rmt_symbol_word_t* espEncodeByte(rmt_symbol_word_t *ledData, uint8_t value)
+{
+  for (uint8_t bit = 0; bit < 8; bit++)
+  {
+    if (value & (0x80 >> bit))
+    {
+      ledData->level0    = 1;
+      ledData->duration0 = 8;
+      ledData->level1    = 0;
+      ledData->duration1 = 4;
+    }
+    else
+    {
+      ledData->level0    = 1;
+      ledData->duration0 = 4;
+      ledData->level1    = 0;
+      ledData->duration1 = 8;
+    }
+
+    ledData++;
+  }
+
+  return ledData;
+}
+
+
+/************************************************************************************/
+/*
+   espEncodeColor()
+
+   Convert one pixel to RMT symbols, e.g. to build palette of pre-encoded colors
+   for "espShowIndexed()"
+
+   NOTE:
+   - symbols, buffer for "bytesPerPixel * 8" RMT symbols
+   - pixel, color bytes in device order
+   - bytesPerPixel, number of color bytes
+   - encoder, optional per-frame settings (see "espEncoder_t"), applied once
+     here instead of every frame
+*/
+/************************************************************************************/
+void espEncodeColor(rmt_symbol_word_t *symbols, const uint8_t *pixel, uint8_t bytesPerPixel, const espEncoder_t *encoder)
+{
+  for (uint8_t i = 0; i < bytesPerPixel; i++)
+  {
+    symbols = espEncodeByte(symbols, espEncodeValue(encoder, pixel[i], i));
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espEncodeCached()
+
+   Convert pixel color buffer to RMT symbols, copy symbols of recently seen
+   pixels from direct-mapped cache
+
+   NOTE:
+   - cache is keyed by pixel bytes before correction, so it's flushed at the
+     start of every part: correction tables may be rebuilt in place between
+     frames & encoder scale changes from frame to frame
+
+   - hit is one "memcpy()" of "bytesPerPixel * 8" symbols instead of per-bit
+     work, miss costs hash, encode & copy to cache. Pays off on frames made of
+     few colors (fills, two-tone patterns), see "espSetCache()"
+
+   - after ESP_RMT_CACHE_MISSES misses in a row (e.g. gradient, "rainbow()")
+     rest of the part is encoded straight to "ledData" without hash & copy, so
+     parts that don't repeat colors pay for a few dozen misses only
+
+   - last incomplete pixel (if any) is encoded without cache
+
+   - "ledData" must have space for "numBytes * 8" symbols
+*/
+/************************************************************************************/
+static void espEncodeCached(rmt_symbol_word_t *ledData, const uint8_t *pixels, uint32_t numBytes, const espEncoder_t *encoder, uint8_t bytesPerPixel)
+{
+  const uint8_t *end       = pixels + numBytes;
+  uint32_t       blockSize = bytesPerPixel * 8 * sizeof(rmt_symbol_word_t); //bytes of symbols per pixel
+  uint32_t       valid     = 0;                                            //bit per cache entry, set if entry holds pixel of this part
+  uint32_t       hits      = 0;
+  uint32_t       misses    = 0;
+  uint32_t       streak    = 0;                                            //consecutive misses
+
+  while (((end - pixels) >= bytesPerPixel) && (streak < ESP_RMT_CACHE_MISSES))
+  {
+    uint64_t key = 0;
+
+    for (uint8_t i = 0; i < bytesPerPixel; i++) {key = (key << 8) | pixels[i];}
+
+    uint8_t slot = (((uint32_t)key ^ (uint32_t)(key >> 32)) * 0x9E3779B1) >> (32 - ESP_RMT_CACHE_BITS); //Fibonacci hashing, top bits
+
+    if ((valid & (1UL << slot)) && (_cacheKeys[slot] == key))
+    {
+      memcpy(ledData, _cacheSymbols[slot], blockSize);
+
+      hits++;
+      streak = 0;
+    }
+    else
+    {
+      espEncodeColor(_cacheSymbols[slot], pixels, bytesPerPixel, encoder);
+      memcpy(ledData, _cacheSymbols[slot], blockSize);
+
+      _cacheKeys[slot]  = key;
+      valid            |= (1UL << slot);
+
+      misses++;
+      streak++;
+    }
+
+    ledData += bytesPerPixel * 8;
+    pixels  += bytesPerPixel;
+  }
+
+  while ((end - pixels) >= bytesPerPixel)        //cache is off for the rest of the part, see NOTE
+  {
+    espEncodeColor(ledData, pixels, bytesPerPixel, encoder);
+
+    ledData += bytesPerPixel * 8;
+    pixels  += bytesPerPixel;
+
+    misses++;
+  }
+
+  for (uint8_t i = 0; pixels < end; i++) //incomplete pixel
+  {
+    ledData = espEncodeByte(ledData, espEncodeValue(encoder, *pixels++, i));
+  }
+
+  _cacheHits   += hits;
+  _cacheMisses += misses;
+}
+
+
+/************************************************************************************/
+/*
+   espEncode()
+
+   Convert pixel color buffer to RMT symbols
+
+   NOTE:
+   - with correction table each byte is passed through the table of its
+     position in pixel, so correction costs one table load per byte & the
+     pixel buffer in RAM stays linear. Table holds 8.8 fixed-point values,
+     encoder sends rounded integer part
+
+   - scale (e.g. from power limiter) is one multiply per byte, applied after
+     correction table
+
+   - with encoder cache enabled pixels are encoded by "espEncodeCached()"
+
+   - "ledData" must have space for "numBytes * 8" symbols
+*/
+/************************************************************************************/
+static void espEncode(rmt_symbol_word_t *ledData, const uint8_t *pixels, uint32_t numBytes, const espEncoder_t *encoder)
+{
+  uint8_t bytesPerPixel = (encoder != NULL) ? encoder->bytesPerPixel : 3; //without encoder any group of bytes may be cached
+
+  if ((_cacheEnabled == true) && (bytesPerPixel <= ESP_RMT_CACHE_BYTES)) //see "espSetCache()"
+  {
+    espEncodeCached(ledData, pixels, numBytes, encoder, bytesPerPixel);
+
+    return;
+  }
+
+  if ((encoder == NULL) || ((encoder->lut == NULL) && (encoder->scale >= 256))) //send as is
+  {
+    for (uint32_t b = 0; b < numBytes; b++)
+    {
+      ledData = espEncodeByte(ledData, pixels[b]);
+    }
+
+    return;
+  }
+
+  const uint8_t *end           = pixels + numBytes;
+  uint16_t       scale         = encoder->scale;
+  uint16_t       value         = 0;
+
+  while (pixels < end)
+  {
+    const uint16_t *lut = encoder->lut;
+
+    for (uint8_t i = 0; (i < bytesPerPixel) && (pixels < end); i++)
+    {
+      value = *pixels++;
+
+      if (lut != NULL)
+      {
+        value = (lut[value] + 0x80) >> 8;
+
+        lut += 256;                                   //table of next byte position
+      }
+
+      if (scale < 256) {value = (value * scale) >> 8;}
+
+      ledData = espEncodeByte(ledData, value);
+    }
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espEncodeIndexed()
+
+   Convert indexed pixels to RMT symbols by copying pre-encoded colors
+
+   NOTE:
+   - one "memcpy()" of "bytesPerPixel * 8" symbols per pixel, no per-bit work,
+     see "espEncodeColor()"
+
+   - "ledData" must have space for "numPixels * bytesPerPixel * 8" symbols
+*/
+/************************************************************************************/
+static void espEncodeIndexed(rmt_symbol_word_t *ledData, const uint8_t *indices, uint32_t numPixels, const espPalette_t *palette)
+{
+  uint32_t blockSize = palette->bytesPerPixel * 8; //symbols per color
+  uint8_t  index     = 0;
+
+  for (uint32_t i = 0; i < numPixels; i++)
+  {
+    if (palette->bitsPerIndex == 8) {index = indices[i];}
+    else                            {index = (i & 1) ? (indices[i >> 1] & 0x0F) : (indices[i >> 1] >> 4);} //high nibble first
+
+    memcpy(ledData, &palette->symbols[index * blockSize], blockSize * sizeof(rmt_symbol_word_t));
+
+    ledData += blockSize;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espRleEncode()
+
+   Encode runs of identical pixels straight to RMT memory, see "espShowRLE()"
+
+   NOTE:
+   - called by RMT driver every time RMT memory needs a refill, so every call
+     continues where the previous one stopped
+
+   - pixel of a run is converted to RMT symbols once & repeated up to
+     ESP_RLE_CHUNK_PIXELS times in "chunk", then chunk is copied to RMT memory
+     until run is over. Long runs (e.g. black background) never read pixel
+     memory & cost one copy per ESP_RLE_CHUNK_PIXELS pixels. Consecutive runs
+     of the same pixel reuse the chunk
+
+   - copy encoder may stop in the middle of chunk when RMT memory is full, same
+     chunk is passed again on next call, so chunk is changed only after copy is
+     completed
+
+   - primaryData, runs of the frame, none is empty
+   - dataSize, size of runs, in bytes
+*/
+/************************************************************************************/
+static size_t IRAM_ATTR espRleEncode(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primaryData, size_t dataSize, rmt_encode_state_t *retState)
+{
+  espRleEncoder_t   *rle       = __containerof(encoder, espRleEncoder_t, base);
+  const espRun_t    *runs      = (const espRun_t *)primaryData;
+  uint32_t           numRuns   = dataSize / sizeof(espRun_t);
+  uint32_t           blockSize = rle->bytesPerPixel * 8; //symbols per pixel
+  uint32_t           state     = RMT_ENCODING_RESET;
+  rmt_encode_state_t session   = RMT_ENCODING_RESET;
+  size_t             encoded   = 0;
+
+  while (rle->run < numRuns)
+  {
+    const espRun_t *run = &runs[rle->run];
+
+    if (rle->pending == 0)                         //start next chunk of the run
+    {
+      rle->pending = run->count - rle->sent;
+
+      if (rle->pending > ESP_RLE_CHUNK_PIXELS) {rle->pending = ESP_RLE_CHUNK_PIXELS;}
+
+      if ((rle->chunkFill == 0) || (memcmp(rle->chunkPixel, run->pixel, rle->bytesPerPixel) != 0))
+      {
+        rmt_symbol_word_t *symbols = rle->chunk;
+
+        for (uint8_t i = 0; i < rle->bytesPerPixel; i++) {symbols = espEncodeByte(symbols, run->pixel[i]);}
+
+        memcpy(rle->chunkPixel, run->pixel, rle->bytesPerPixel);
+
+        rle->chunkFill = 1;
+      }
+
+      while (rle->chunkFill < rle->pending)        //repeat pixel only as far as the run needs it
+      {
+        memcpy(&rle->chunk[rle->chunkFill * blockSize], rle->chunk, blockSize * sizeof(rmt_symbol_word_t));
+
+        rle->chunkFill++;
+      }
+    }
+
+    session  = RMT_ENCODING_RESET;
+    encoded += rle->copy->encode(rle->copy, channel, rle->chunk, rle->pending * blockSize * sizeof(rmt_symbol_word_t), &session);
+
+    if (session & RMT_ENCODING_COMPLETE)
+    {
+      rle->sent   += rle->pending;
+      rle->pending = 0;
+
+      if (rle->sent >= run->count)
+      {
+        rle->run++;
+        rle->sent = 0;
+      }
+    }
+
+    if (session & RMT_ENCODING_MEM_FULL)
+    {
+      *retState = (rmt_encode_state_t)(state | RMT_ENCODING_MEM_FULL); //yield, RMT memory is sent & refilled
+
+      return encoded;
+    }
+  }
+
+  session  = RMT_ENCODING_RESET;
+  encoded += rle->copy->encode(rle->copy, channel, &rle->latch, sizeof(rmt_symbol_word_t), &session);
+
+  if (session & RMT_ENCODING_COMPLETE)
+  {
+    rle->run  = 0;                                 //ready for next frame
+    rle->sent = 0;
+    state    |= RMT_ENCODING_COMPLETE;
+  }
+
+  if (session & RMT_ENCODING_MEM_FULL) {state |= RMT_ENCODING_MEM_FULL;}
+
+  *retState = (rmt_encode_state_t)state;
+
+  return encoded;
+}
+
+
+/************************************************************************************/
+/*
+   espRleReset()
+
+   Reset run-length encoder to the start of frame, called by RMT driver
+*/
+/************************************************************************************/
+static esp_err_t espRleReset(rmt_encoder_t *encoder)
+{
+  espRleEncoder_t *rle = __containerof(encoder, espRleEncoder_t, base);
+
+  rle->run     = 0;
+  rle->sent    = 0;
+  rle->pending = 0;
+
+  return rmt_encoder_reset(rle->copy);
+}
+
+
+/************************************************************************************/
+/*
+   espRleDelete()
+
+   Free run-length encoder & its runs, called by "rmt_del_encoder()"
+*/
+/************************************************************************************/
+static esp_err_t espRleDelete(rmt_encoder_t *encoder)
+{
+  espRleEncoder_t *rle = __containerof(encoder, espRleEncoder_t, base);
+
+  rmt_del_encoder(rle->copy);
+  free(rle->runs);
+  free(rle);
+
+  return ESP_OK;
+}
+
+
+/************************************************************************************/
+/*
+   espNewRleEncoder()
+
+   Create run-length encoder, see "espRleEncode()"
+
+   NOTE:
+   - encoder keeps transaction state & runs of current frame, so every channel
+     slot has its own one
+
+   - return true on success, false if out of memory
+*/
+/************************************************************************************/
+static bool espNewRleEncoder(rmt_encoder_handle_t *encoder)
+{
+  espRleEncoder_t          *rle       = (espRleEncoder_t *)calloc(1, sizeof(espRleEncoder_t));
+  rmt_copy_encoder_config_t encConfig = {};
+
+  if (rle == NULL) {return false;}
+
+  if (rmt_new_copy_encoder(&encConfig, &rle->copy) != ESP_OK)
+  {
+    free(rle);
+
+    return false;
+  }
+
+  rle->base.encode = espRleEncode;
+  rle->base.reset  = espRleReset;
+  rle->base.del    = espRleDelete;
+
+  rle->latch.level0    = 0;                        //latch, 150us + 150us low
+  rle->latch.duration0 = 1500;
+  rle->latch.level1    = 0;
+  rle->latch.duration1 = 1500;
+
+  *encoder = &rle->base;
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   espDoneCallback()
+
+   RMT "transaction done" interrupt handler, marks channel slot as idle
+
+   NOTE:
+   - called from ISR after last symbol (latch) is sent, "userCtx" holds
+     "_doneEvents" bit of the slot
+
+   - "xEventGroupSetBitsFromISR()" defers setting bits to the timer service
+     task, so waiting task is woken up shortly after
+*/
+/************************************************************************************/
+static bool IRAM_ATTR espDoneCallback(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *eventData, void *userCtx)
+{
+  BaseType_t taskWoken = pdFALSE;
+
+  xEventGroupSetBitsFromISR(_doneEvents, (EventBits_t)(uintptr_t)userCtx, &taskWoken);
+
+  return (taskWoken == pdTRUE);
+}
+
+
+/************************************************************************************/
+/*
+   espWaitIdle()
+
+   Wait until all channels are idle, so shared symbol buffer is not read by RMT
+
+   NOTE:
+   - timeout follows wire time of the last "espShow()", see "_wireTimeMs"
+
+   - return true if all channels are idle, false on timeout
+*/
+/************************************************************************************/
+static bool espWaitIdle()
+{
+  return espWaitDone(ESP_RMT_DONE_ALL, _wireTimeMs + SEMAPHORE_TIMEOUT_MS);
+}
+
+
+/************************************************************************************/
+/*
+   espFindSlot()
+
+   Find channel slot attached to the pin
+
+   NOTE:
+   - return slot index, ESP_RMT_MAX_PINS if pin has no channel attached
+*/
+/************************************************************************************/
+static uint8_t espFindSlot(int pin)
+{
+  for (uint8_t slot = 0; slot < ESP_RMT_MAX_PINS; slot++)
+  {
+    if ((_rmtChannels[slot].channel != NULL) && (_rmtChannels[slot].pin == pin)) {return slot;}
+  }
+
+  return ESP_RMT_MAX_PINS;
+}
+
+
+/************************************************************************************/
+/*
+   espDetachSlot()
+
+   Release RMT TX channel & encoders of the slot
+
+   NOTE:
+   - waits until channel is idle, symbols on the wire are never cut off
+*/
+/************************************************************************************/
+static void espDetachSlot(uint8_t slot)
+{
+  espChannel_t *rmt = &_rmtChannels[slot];
+
+  rmt_tx_wait_all_done(rmt->channel, -1);        //-1 = wait forever, teardown must not be skipped
+  rmt_disable(rmt->channel);
+  rmt_del_channel(rmt->channel);
+  rmt_del_encoder(rmt->encoder);
+
+  if (rmt->rle != NULL) {rmt_del_encoder(rmt->rle);}
+
+  rmt->channel = NULL;
+  rmt->encoder = NULL;
+  rmt->rle     = NULL;
+  rmt->owners  = 0;
+
+  xEventGroupSetBits(_doneEvents, ESP_RMT_DONE_BIT(slot));
+}
+
+
+/************************************************************************************/
+/*
+   espAttachSlot()
+
+   Create RMT TX channel & copy encoder for the pin in free slot
+
+   NOTE:
+   - RMT resolution 10MHz, 1 tick = 100ns, see "espEncodeByte()"
+
+   - "espDoneCallback()" gets "_doneEvents" bit of the slot as user context
+
+   - return true on success, false if RMT channel can't be initialized (e.g.
+     more pins than RMT TX channels of the chip), nothing is kept
+*/
+/************************************************************************************/
+static bool espAttachSlot(uint8_t slot, int pin)
+{
+  espChannel_t             *rmt       = &_rmtChannels[slot];
+  rmt_tx_channel_config_t   txConfig  = {};
+  rmt_copy_encoder_config_t encConfig = {};
+  rmt_tx_event_callbacks_t  callbacks = {};
+
+  txConfig.gpio_num          = (gpio_num_t)pin;
+  txConfig.clk_src           = RMT_CLK_SRC_DEFAULT;
+  txConfig.resolution_hz     = 10000000;
+  txConfig.mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL; //one memory block, same as "RMT_MEM_NUM_BLOCKS_1"
+  txConfig.trans_queue_depth = 1;                             //one transaction per channel & "espShow()"
+
+  callbacks.on_trans_done = espDoneCallback;
+
+  if (rmt_new_tx_channel(&txConfig, &rmt->channel) != ESP_OK)
+  {
+    rmt->channel = NULL;
+
+    return false;
+  }
+
+  if ((rmt_new_copy_encoder(&encConfig, &rmt->encoder) != ESP_OK) ||
+      (rmt_tx_register_event_callbacks(rmt->channel, &callbacks, (void *)(uintptr_t)ESP_RMT_DONE_BIT(slot)) != ESP_OK) ||
+      (rmt_enable(rmt->channel) != ESP_OK))
+  {
+    if (rmt->encoder != NULL) {rmt_del_encoder(rmt->encoder);}
+
+    rmt_del_channel(rmt->channel);
+
+    rmt->channel = NULL;
+    rmt->encoder = NULL;
+
+    return false;
+  }
+
+  rmt->pin    = pin;
+  rmt->owners = 0;
+
+  xEventGroupSetBits(_doneEvents, ESP_RMT_DONE_BIT(slot)); //idle until first transaction
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   espDetach()
+
+   Release RMT channels of all pins that are not in the list
+
+   NOTE:
+   - owned channels (see "espAcquireChannel()") are never released here
+
+   - pins, list of pins to keep, NULL to release all time-shared channels
+   - numPins, number of pins in list
+*/
+/************************************************************************************/
+static void espDetach(const uint8_t *pins, uint8_t numPins)
+{
+  for (uint8_t slot = 0; slot < ESP_RMT_MAX_PINS; slot++)
+  {
+    if ((_rmtChannels[slot].channel == NULL) || (_rmtChannels[slot].owners > 0)) {continue;}
+
+    bool keep = false;
+
+    for (uint8_t j = 0; j < numPins; j++)
+    {
+      if (_rmtChannels[slot].pin == pins[j]) {keep = true;}
+    }
+
+    if (keep != true) {espDetachSlot(slot);}
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espAttach()
+
+   Attach RMT TX channel to every pin in the list
+
+   NOTE:
+   - time-shared channels of pins not in the list are released first, so every
+     call can use all RMT TX channels that are not owned. Pins already attached
+     keep their channels & slots
+
+   - pins, list of pins
+   - numPins, number of pins in list
+
+   - return true on success, false if RMT channel can't be initialized (e.g.
+     more pins than RMT TX channels)
+*/
+/************************************************************************************/
+static bool espAttach(const uint8_t *pins, uint8_t numPins)
+{
+  espDetach(pins, numPins);
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    if (espFindSlot(pins[i]) < ESP_RMT_MAX_PINS) {continue;} //already attached
+
+    uint8_t slot = 0;
+
+    while ((slot < ESP_RMT_MAX_PINS) && (_rmtChannels[slot].channel != NULL)) {slot++;}
+
+    if ((slot >= ESP_RMT_MAX_PINS) || (espAttachSlot(slot, pins[i]) != true))
+    {
+      log_e("Failed to init RMT TX mode on pin %d", pins[i]);
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   espResize()
+
+   Grow RMT symbol buffer
+
+   NOTE:
+   - buffer is shared between all instances & only grows, so it follows the
+     capacity of the largest strip. Old symbols are not kept
+
+   - buffer is replaced only after all channels are idle, RMT reads symbols
+     until the end of transaction
+
+   - call with "_showMutex" taken
+
+   - requiredSize, number of RMT symbols
+*/
+/************************************************************************************/
+static void espResize(uint32_t requiredSize)
+{
+  if (requiredSize <= _ledDataSize) {return;}
+
+  if (espWaitIdle() != true) {return;}           //buffer is still in use, keep it
+
+  free(_ledData);
+
+  if ((_ledData = (rmt_symbol_word_t *)malloc(requiredSize * sizeof(rmt_symbol_word_t))) != NULL)
+  {
+    _ledDataSize = requiredSize;
+  }
+  else
+  {
+    _ledDataSize = 0;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espWireTime()
+
+   Wire time of one part, including latch
+
+   NOTE:
+   - 1 bit = 1.2 microseconds, latch = 300 microseconds, see "espEncodeByte()"
+
+   - numBytes, size of part, in bytes
+
+   - return time in milliseconds, rounded up
+*/
+/************************************************************************************/
+static uint32_t espWireTime(uint32_t numBytes)
+{
+  return (uint32_t)(((uint64_t)numBytes * 8 * 12 + 3000) / 10000) + 1;
+}
+
+
+/************************************************************************************/
+/*
+   espInit()
+
+   Initializing the mutex & "transaction done" event group shared by all
+   output backends, see "espGetDoneEvents()"
+
+   NOTE:
+    - to avoid race condition initializing the mutex, all instances of
+      "ESP32_WS281x" must be constructed before launching and child threads
+
+    - mutex is created only after event group, so every function guarded by
+      mutex may use "_doneEvents"
+*/
+/************************************************************************************/
+void espInit()
+{
+  if ((_doneEvents == NULL) && ((_doneEvents = xEventGroupCreate()) != NULL))
+  {
+    xEventGroupSetBits(_doneEvents, ESP_DONE_ALL); //all outputs idle
+  }
+
+  if ((_showMutex == NULL) && (_doneEvents != NULL)) {_showMutex = xSemaphoreCreateMutex();}
+}
+
+
+/************************************************************************************/
+/*
+   espReserve()
+
+   Allocate RMT symbol buffer for strip of given size in advance
+
+   NOTE:
+   - called by "ESP32_WS281x::reserve()" & "begin()", so "espShow()" never
+     allocates memory for strips within their capacity
+
+   - buffer holds 8 symbols per byte + one latch symbol per pin
+
+   - numBytes, size of pixel buffer, in bytes
+
+   - return true on success, false if out of memory, buffer is still in use or
+     mutex is not available
+*/
+/************************************************************************************/
+bool espReserve(uint32_t numBytes)
+{
+  bool result = false;
+
+  if (numBytes > ESP_RMT_MAX_BYTES) {return false;}
+
+  if (_showMutex && xSemaphoreTake(_showMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    espResize(numBytes * 8 + ESP_RMT_MAX_PINS);
+
+    result = (_ledDataSize >= (numBytes * 8 + ESP_RMT_MAX_PINS));
+
+    xSemaphoreGive(_showMutex);
+  }
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espAcquire()
+
+   Take reference to shared RMT symbol buffer & allocate it for strip of given
+   size
+
+   NOTE:
+   - every "ESP32_WS281x::begin()" takes one reference, "end()" gives it back.
+     Buffer is freed when last reference is given back, see "espRelease()"
+
+   - numBytes, size of pixel buffer, in bytes
+
+   - return true on success, false if out of memory or mutex is not available
+     (reference is taken anyway, so every call must be paired with "espRelease()")
+*/
+/************************************************************************************/
+bool espAcquire(uint32_t numBytes)
+{
+  if (_showMutex && xSemaphoreTake(_showMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    _ledDataRefs++;
+
+    xSemaphoreGive(_showMutex);
+  }
+  else
+  {
+    return false;
+  }
+
+  return espReserve(numBytes);
+}
+
+
+/************************************************************************************/
+/*
+   espRelease()
+
+   Give back reference to shared RMT symbol buffer
+
+   NOTE:
+   - last reference frees symbol buffer & all time-shared RMT channels, owned
+     channels stay until their owners release them, see "espReleaseChannel()"
+
+   - buffer is freed after all channels are idle, including owned ones
+*/
+/************************************************************************************/
+void espRelease()
+{
+  if (_showMutex && xSemaphoreTake(_showMutex, portMAX_DELAY) == pdTRUE) //teardown must not be skipped
+  {
+    if (_ledDataRefs > 0) {_ledDataRefs--;}
+
+    if (_ledDataRefs == 0)
+    {
+      espDetach(NULL, 0);
+      espWaitDone(ESP_RMT_DONE_ALL, portMAX_DELAY);
+
+      free(_ledData);
+
+      _ledData     = NULL;
+      _ledDataSize = 0;
+    }
+
+    xSemaphoreGive(_showMutex);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espAcquireChannel()
+
+   Attach RMT TX channel to every pin in the list & keep it until
+   "espReleaseChannel()"
+
+   NOTE:
+   - owned channel is never released by "espShow()" of other pins, so strip with
+     owned channels is sent without RMT channel reconfiguration. Number of
+     channels is limited, other strips time-share remaining channels
+
+   - several strips may own the same pin, channel is released by last owner
+
+   - pins, list of pins
+   - numPins, number of pins in list, 1..ESP_RMT_MAX_PINS
+
+   - return true on success, false if RMT channel can't be initialized or
+     mutex is not available (no channel is owned)
+*/
+/************************************************************************************/
+bool espAcquireChannel(const uint8_t *pins, uint8_t numPins)
+{
+  bool result = false;
+
+  if (numPins > ESP_RMT_MAX_PINS) {return false;}
+
+  if (_showMutex && xSemaphoreTake(_showMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    if ((result = espAttach(pins, numPins)) == true)
+    {
+      for (uint8_t i = 0; i < numPins; i++)
+      {
+        _rmtChannels[espFindSlot(pins[i])].owners++;
+      }
+    }
+
+    xSemaphoreGive(_showMutex);
+  }
+
+  return result;
+}
 
 
 /************************************************************************************/
 /*
-   espInit()
+   espReleaseChannel()
 
-   Initializing the mutex
+   Give back RMT TX channels owned by "espAcquireChannel()"
 
    NOTE:
-    - to avoid race condition initializing the mutex, all instances of
-      "ESP32_WS281x" must be constructed before launching and child threads
+   - channel is released when last owner gives it back
+
+   - pins, list of pins, same as in "espAcquireChannel()"
+   - numPins, number of pins in list
 */
 /************************************************************************************/
-void espInit()
+void espReleaseChannel(const uint8_t *pins, uint8_t numPins)
 {
-  if (_showMutex == NULL) {_showMutex = xSemaphoreCreateMutex();}
+  if (_showMutex && xSemaphoreTake(_showMutex, portMAX_DELAY) == pdTRUE) //teardown must not be skipped
+  {
+    for (uint8_t i = 0; i < numPins; i++)
+    {
+      uint8_t slot = espFindSlot(pins[i]);
+
+      if ((slot < ESP_RMT_MAX_PINS) && (_rmtChannels[slot].owners > 0)) {_rmtChannels[slot].owners--;}
+    }
+
+    espDetach(NULL, 0);                          //release channels without owners
+
+    xSemaphoreGive(_showMutex);
+  }
 }
 
 
 /************************************************************************************/
 /*
-   espShow()
+   espGetDoneBits()
 
-   Send pixel color buffer (data) to LED drivers via ESP32 RMT peripheral
+   Get "transaction done" bits of the pins, see "espWaitDone()"
+
+   NOTE:
+   - bits of several strips may be combined with "|" & waited for at once
+
+   - pin without attached channel has no bit, nothing to wait for. Time-shared
+     slot may be taken over by another pin later, then waiting on its bit
+     waits for the other pin, never longer than its wire time
+
+   - pins, list of pins
+   - numPins, number of pins in list
+*/
+/************************************************************************************/
+EventBits_t espGetDoneBits(const uint8_t *pins, uint8_t numPins)
+{
+  EventBits_t doneBits = 0;
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    uint8_t slot = espFindSlot(pins[i]);
+
+    if (slot < ESP_RMT_MAX_PINS) {doneBits |= ESP_RMT_DONE_BIT(slot);}
+  }
+
+  return doneBits;
+}
+
+
+/************************************************************************************/
+/*
+   espWaitDone()
+
+   Wait until all transactions of the channels are done (latch included)
+
+   NOTE:
+   - waiting task is blocked, no CPU time is spent
+
+   - doneBits, see "espGetDoneBits()"
+   - timeoutMs, maximum waiting time in milliseconds, 0 to only check
+
+   - return true if channels are idle, false on timeout
+*/
+/************************************************************************************/
+bool espWaitDone(EventBits_t doneBits, uint32_t timeoutMs)
+{
+  if ((_doneEvents == NULL) || (doneBits == 0)) {return true;}
+
+  TickType_t timeout = (timeoutMs == portMAX_DELAY) ? portMAX_DELAY : (timeoutMs / portTICK_PERIOD_MS);
+
+  return (xEventGroupWaitBits(_doneEvents, doneBits, pdFALSE, pdTRUE, timeout) & doneBits) == doneBits; //pdFALSE = don't clear bits on exit, pdTRUE = wait for all bits
+}
+
+
+/************************************************************************************/
+/*
+   espGetDoneEvents()
+
+   Get "transaction done" event group shared by all output backends
 
    NOTE:
-   - because RTM pin is shared between all instances, we will end up
-     releasing/initializing the RMT channels each time we invoke on different pins.
-     This is OK, but not efficient. "ledData" is shared between all instances
-     but will be allocated with enough space for the largest instance, data is not
-     used beyond the mutex lock so this should be fine
+   - every backend owns its bits (see ESP_DONE_BIT_I2S), bit is cleared when
+     transaction starts & set from ISR when it's done, so "espWaitDone()"
+     waits for strips of any backend at once
+
+   - return NULL if "espInit()" wasn't called
+*/
+/************************************************************************************/
+EventGroupHandle_t espGetDoneEvents()
+{
+  return _doneEvents;
+}
+
+
+/************************************************************************************/
+/*
+   espTransmit()
 
-   - to release RMT resources (RMT channels and "ledData"):
-     - call "updateLength(0)" to set number of pixels/bytes to zero
-     - then call "show()" to invoke this code and free resources
+   Encode parts of a frame to shared RMT symbol buffer & start them, see
+   "espShow()"
+
+   NOTE:
+   - data, pixel buffer or pixel indexes if palette is not NULL
+   - numBytes, list of part sizes in bytes on the wire
+   - palette, pre-encoded colors for indexed frame, NULL for pixel buffer
 */
 /************************************************************************************/
-void espShow(uint8_t pin, uint8_t *pixels, uint32_t numBytes)
+static bool espTransmit(const uint8_t *pins, uint8_t numPins, const uint8_t *data, const uint32_t *numBytes, const espEncoder_t *encoder, const espPalette_t *palette, bool realtime)
 {
-  static rmt_data_t* ledData     = NULL;
-  static uint32_t    ledDataSize = 0;
-  static int         rmtPin      = -1;
+  uint32_t requiredSize = 0;
+  bool     result       = false;
+
+  if (numPins > ESP_RMT_MAX_PINS) {numPins = ESP_RMT_MAX_PINS;}
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    if (numBytes[i] != 0) {requiredSize += numBytes[i] * 8 + 1;} //+1 latch symbol
+  }
+
+  if (requiredSize == 0) {return true;} //see NOTE
 
   if (_showMutex && xSemaphoreTake(_showMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
   {
-    uint32_t requiredSize = numBytes * 8;
+    bool attached = true;
 
-    if (requiredSize > ledDataSize)
+    for (uint8_t i = 0; i < numPins; i++)
     {
-      free(ledData);
-
-      if ((ledData = (rmt_data_t *)malloc(requiredSize * sizeof(rmt_data_t)))!= NULL)
-      {
-        ledDataSize = requiredSize;
-      }
-      else
-      {
-        ledDataSize = 0;
-      }
+      if (espFindSlot(pins[i]) >= ESP_RMT_MAX_PINS) {attached = false;}
     }
-    else if (requiredSize == 0) //see NOTE
+
+    if ((requiredSize > _ledDataSize) && (realtime != true)) {espResize(requiredSize);} //strip wasn't reserved, see "espReserve()"
+
+    if ((requiredSize <= _ledDataSize) && (espWaitIdle() == true) && ((attached == true) || ((realtime != true) && (espAttach(pins, numPins) == true)))) //wait first, released channels must be idle
     {
-      free(ledData);
+      rmt_symbol_word_t*    ledData  = _ledData;
+      rmt_transmit_config_t txConfig = {};          //no loop, line stays low after last symbol
 
-      ledData = NULL;
+      _wireTimeMs = 0;
+      result      = true;
 
-      if (rmtPin >= 0)
+      for (uint8_t i = 0; i < numPins; i++)
       {
-        rmtDeinit(rmtPin);
+        if (numBytes[i] == 0) {continue;}
 
-        rmtPin = -1;
-      }
+        uint8_t  slot       = espFindSlot(pins[i]);
+        uint32_t numSymbols = numBytes[i] * 8;
+
+        uint32_t numPixels = (palette != NULL) ? (numBytes[i] / palette->bytesPerPixel) : 0;
+
+        if (palette != NULL) {espEncodeIndexed(ledData, data, numPixels, palette);}
+        else                 {espEncode(ledData, data, numBytes[i], encoder);}
+
+        ledData[numSymbols].level0    = 0;          //latch, 150us + 150us low
+        ledData[numSymbols].duration0 = 1500;
+        ledData[numSymbols].level1    = 0;
+        ledData[numSymbols].duration1 = 1500;
+
+        numSymbols++;
+
+        xEventGroupClearBits(_doneEvents, ESP_RMT_DONE_BIT(slot));
+
+        if (rmt_transmit(_rmtChannels[slot].channel, _rmtChannels[slot].encoder, ledData, numSymbols * sizeof(rmt_symbol_word_t), &txConfig) != ESP_OK) //start part & encode next one meanwhile
+        {
+          xEventGroupSetBits(_doneEvents, ESP_RMT_DONE_BIT(slot));
+
+          log_e("Failed to send RMT data on pin %d", pins[i]);
+
+          result = false;
+        }
+
+        if (espWireTime(numBytes[i]) > _wireTimeMs) {_wireTimeMs = espWireTime(numBytes[i]);}
 
-      ledDataSize = 0;
+        data    += (palette != NULL) ? ((numPixels * palette->bitsPerIndex + 7) / 8) : numBytes[i];
+        ledData += numSymbols;
+      }
     }
 
-    if ((ledDataSize > 0) && (requiredSize <= ledDataSize))
+    xSemaphoreGive(_showMutex);
+  }
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espShow()
+
+   Send pixel color buffer (data) to LED drivers via ESP32 RMT peripheral
+
+   NOTE:
+   - see "espShow()" below for details
+*/
+/************************************************************************************/
+bool espShow(uint8_t pin, uint8_t *pixels, uint32_t numBytes, const espEncoder_t *encoder, bool realtime)
+{
+  return espShow(&pin, 1, pixels, &numBytes, encoder, realtime);
+}
+
+
+/************************************************************************************/
+/*
+   espShow()
+
+   Send consecutive parts of pixel color buffer (data) to several pins in
+   parallel via ESP32 RMT peripheral
+
+   NOTE:
+   - every pin gets its own RMT TX channel, part of next pin is encoded while
+     previous parts are already on the wire, so total wire time is close to the
+     wire time of the longest part
+
+   - returns as soon as all parts are started, mutex is released before the
+     wire time. Every part ends with 300 microseconds low (latch), channel is
+     marked idle by "espDoneCallback()" after latch, see "espWaitDone()"
+
+   - because RTM channels are shared between all instances, if some pin has no
+     channel, time-shared channels of pins not used by current call are released
+     & channels of new pins are initialized. This is OK, but not efficient, see
+     "espAcquireChannel()". Call with all channels attached changes nothing. "_ledData" is shared between all instances
+     but will be allocated with enough space for the largest instance. RMT reads
+     symbols until the end of transaction, so next call waits until all channels
+     are idle before encoding (never longer than wire time of previous call)
+
+   - every part must start at pixel boundary, encoder tables restart with
+     every part
+
+   - pins, list of data pins, 1..ESP_RMT_MAX_PINS & not more than number of RMT
+     TX channels of the chip
+   - numPins, number of pins
+   - pixels, buffer with parts of all pins one after another, not used after return
+   - numBytes, list of part sizes, in bytes
+   - encoder, optional per-frame settings (see "espEncoder_t"), NULL to send
+     pixel buffer as is
+   - realtime, true to never allocate memory or reconfigure RMT channels, frame
+     is dropped if symbol buffer is not reserved (see "espReserve()") or some pin
+     has no channel (see "espAcquireChannel()"). Every wait is bounded, mutex by
+     SEMAPHORE_TIMEOUT_MS, previous frames by their wire time
+
+   - nothing to send if all parts are empty, mutex is not taken. RMT resources
+     are released by "espRelease()" & "espReleaseChannel()"
+
+   - return true if all parts are started, false if frame is dropped
+*/
+/************************************************************************************/
+bool espShow(const uint8_t *pins, uint8_t numPins, uint8_t *pixels, const uint32_t *numBytes, const espEncoder_t *encoder, bool realtime)
+{
+  return espTransmit(pins, numPins, pixels, numBytes, encoder, NULL, realtime);
+}
+
+
+/************************************************************************************/
+/*
+   espShowIndexed()
+
+   Send indexed pixels to LED drivers via ESP32 RMT peripheral
+
+   NOTE:
+   - same as "espShow()", but every pixel is an index into palette of colors
+     pre-encoded to RMT symbols by "espEncodeColor()", so encoding is a copy of
+     symbol blocks & pixel buffer is 1 or 1/2 byte per pixel
+
+   - shares RMT symbol buffer & channels with "espShow()", symbol buffer size
+     is the same as for "numPixels * bytesPerPixel" bytes, see "espReserve()"
+
+   - pin, data pin
+   - indices, 1 byte per pixel with 8-bit indexes, 2 pixels per byte (high
+     nibble first) with 4-bit indexes, not used after return
+   - numPixels, number of pixels
+   - palette, pre-encoded colors, every index used by pixels must be valid
+   - realtime, see "espShow()"
+
+   - return true if frame is started, false if frame is dropped
+*/
+/************************************************************************************/
+bool espShowIndexed(uint8_t pin, const uint8_t *indices, uint32_t numPixels, const espPalette_t *palette, bool realtime)
+{
+  if ((palette == NULL) || (palette->symbols == NULL) || ((uint64_t)numPixels * palette->bytesPerPixel > ESP_RMT_MAX_BYTES)) {return false;}
+
+  uint32_t numBytes = numPixels * palette->bytesPerPixel;
+
+  return espTransmit(&pin, 1, indices, &numBytes, NULL, palette, realtime);
+}
+
+
+/************************************************************************************/
+/*
+   espShowRLE()
+
+   Send run-length encoded frame to LED drivers via ESP32 RMT peripheral
+
+   NOTE:
+   - frame is a list of runs of identical pixels, e.g. mostly black status
+     display with few lit segments is a handful of runs. Runs are encoded
+     straight to RMT memory while frame is on the wire (see "espRleEncode()"),
+     so neither pixel buffer nor RMT symbol buffer of full length is used
+
+   - runs are copied to run buffer of the pin's channel with encoder settings
+     applied, 12 bytes per run. RMT symbol buffer shared with "espShow()" is
+     not used, so frame waits only for previous frame of the same pin
+
+   - same as "espShow()" function returns as soon as frame is started & pin
+     without channel takes time-shared one
+
+   - pin, data pin
+   - runs, list of runs, not used after return
+   - numRuns, number of runs
+   - bytesPerPixel, bytes per pixel on the wire, 1..ESP_RLE_MAX_BYTES
+   - encoder, optional per-frame settings (see "espEncoder_t"), NULL to send
+     runs as is
+   - realtime, true to never allocate memory or reconfigure RMT channels, frame
+     is dropped if pin has no channel (see "espAcquireChannel()") or run buffer
+     is smaller than "numRuns" (it grows with previous non-realtime frames)
+
+   - return true if frame is started or empty, false if frame is dropped
+*/
+/************************************************************************************/
+bool espShowRLE(uint8_t pin, const espRun_t *runs, uint32_t numRuns, uint8_t bytesPerPixel, const espEncoder_t *encoder, bool realtime)
+{
+  uint64_t numBytes = 0;
+  bool     result   = false;
+
+  if ((runs == NULL) || (bytesPerPixel == 0) || (bytesPerPixel > ESP_RLE_MAX_BYTES)) {return false;}
+
+  for (uint32_t i = 0; i < numRuns; i++) {numBytes += (uint64_t)runs[i].count * bytesPerPixel;}
+
+  if (numBytes == 0)                {return true;}  //nothing to send, mutex is not taken
+  if (numBytes > ESP_RMT_MAX_BYTES) {return false;}
+
+  if (_showMutex && xSemaphoreTake(_showMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    uint8_t slot = espFindSlot(pin);
+
+    if ((slot >= ESP_RMT_MAX_PINS) && (realtime != true) && (espAttach(&pin, 1) == true)) {slot = espFindSlot(pin);}
+
+    if ((slot < ESP_RMT_MAX_PINS) && (espWaitDone(ESP_RMT_DONE_BIT(slot), _wireTimeMs + SEMAPHORE_TIMEOUT_MS) == true) &&
+        ((_rmtChannels[slot].rle != NULL) || ((realtime != true) && (espNewRleEncoder(&_rmtChannels[slot].rle) == true))))
     {
-      if (pin != rmtPin)
+      espRleEncoder_t *rle = __containerof(_rmtChannels[slot].rle, espRleEncoder_t, base);
+
+      if ((numRuns > rle->runsSize) && (realtime != true))
       {
-        if (rmtPin >= 0)
-        {
-          rmtDeinit(rmtPin);
+        espRun_t *newRuns = (espRun_t *)realloc(rle->runs, numRuns * sizeof(espRun_t));
 
-          rmtPin = -1;
+        if (newRuns != NULL)
+        {
+          rle->runs     = newRuns;
+          rle->runsSize = numRuns;
         }
+      }
+
+      if (numRuns <= rle->runsSize)
+      {
+        rmt_transmit_config_t txConfig = {};       //no loop, line stays low after last symbol
+        uint32_t              count    = 0;        //number of non-empty runs
 
-        if (rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, 10000000) != true) //rmtInit(int pin, rmt_ch_dir_t channel_direction, rmt_reserve_memsize_t memsize, uint32_t frequency_Hz)
+        for (uint32_t i = 0; i < numRuns; i++)
         {
-          log_e("Failed to init RMT TX mode on pin %d", pin);
+          if (runs[i].count == 0) {continue;}
 
-          return;
+          rle->runs[count].count = runs[i].count;
+
+          for (uint8_t j = 0; j < bytesPerPixel; j++) {rle->runs[count].pixel[j] = espEncodeValue(encoder, runs[i].pixel[j], j);}
+
+          count++;
         }
 
-        rmtPin = pin;
-      }
+        rle->bytesPerPixel = bytesPerPixel;
+        rle->chunkFill     = 0;                    //chunk may hold pixel of other size
 
-      if (rmtPin >= 0)
-      {
-        int i=0;
+        xEventGroupClearBits(_doneEvents, ESP_RMT_DONE_BIT(slot));
 
-        for (int b=0; b < numBytes; b++)
+        if (rmt_transmit(_rmtChannels[slot].channel, _rmtChannels[slot].rle, rle->runs, count * sizeof(espRun_t), &txConfig) != ESP_OK)
         {
-          for (int bit=0; bit<8; bit++)
-          {
-            if (pixels[b] & (1<<(7-bit)))
-            {
-              ledData[i].level0    = 1;
-              ledData[i].duration0 = 8;
-              ledData[i].level1    = 0;
-              ledData[i].duration1 = 4;
-            }
-            else
-            {
-              ledData[i].level0    = 1;
-              ledData[i].duration0 = 4;
-              ledData[i].level1    = 0;
-              ledData[i].duration1 = 8;
-            }
-
-            i++;
-          }
+          xEventGroupSetBits(_doneEvents, ESP_RMT_DONE_BIT(slot));
+
+          log_e("Failed to send RMT data on pin %d", pin);
+        }
+        else
+        {
+          result = true;
         }
 
-        rmtWrite(pin, ledData, numBytes * 8, RMT_WAIT_FOR_EVER);
+        if (espWireTime(numBytes) > _wireTimeMs) {_wireTimeMs = espWireTime(numBytes);} //other pins may still be on the wire
       }
     }
 
     xSemaphoreGive(_showMutex);
   }
-}
\ No newline at end of file
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espSetCache()
+
+   Enable/disable encoder cache of RMT symbols of recently seen pixels
+
+   NOTE:
+   - frames dominated by few colors are encoded mostly by copying cached
+     symbols, see "espEncodeCached()". In parts where nearly every pixel
+     differs from the ones before it (e.g. gradients) cache turns itself off
+     after ESP_RMT_CACHE_MISSES misses in a row, check hit rate with
+     "espGetCacheStats()" & disable cache if even that costs too much
+
+   - cache holds ESP_RMT_CACHE_SIZE pixels of up to ESP_RMT_CACHE_BYTES bytes,
+     it's shared by all strips. Enabled by default
+
+   - enable, true to enable cache
+*/
+/************************************************************************************/
+void espSetCache(bool enable)
+{
+  _cacheEnabled = enable;
+}
+
+
+/************************************************************************************/
+/*
+   espGetCache()
+
+   Retrieve encoder cache state, see "espSetCache()"
+*/
+/************************************************************************************/
+const bool espGetCache()
+{
+  return _cacheEnabled;
+}
+
+
+/************************************************************************************/
+/*
+   espGetCacheStats()
+
+   Retrieve encoder cache counters since start or last reset
+
+   NOTE:
+   - hit rate = hits / (hits + misses). Counters are 32-bit & wrap around
+
+   - hits, returned number of pixels copied from cache
+   - misses, returned number of pixels encoded bit by bit (& stored to cache)
+   - reset, true to reset counters after reading
+*/
+/************************************************************************************/
+void espGetCacheStats(uint32_t &hits, uint32_t &misses, bool reset)
+{
+  hits   = _cacheHits;
+  misses = _cacheMisses;
+
+  if (reset == true)
+  {
+    _cacheHits   = 0;
+    _cacheMisses = 0;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espRmtBytes()
+
+   Total size of all parts, see "espOutputRMT"
+
+   NOTE:
+   - return ESP_RMT_MAX_BYTES + 1 if parts are too long
+*/
+/************************************************************************************/
+static uint32_t espRmtBytes(const uint32_t *numBytes, uint8_t numPins)
+{
+  uint64_t total = 0;
+
+  for (uint8_t i = 0; i < numPins; i++) {total += numBytes[i];}
+
+  return (total > ESP_RMT_MAX_BYTES) ? (ESP_RMT_MAX_BYTES + 1) : total;
+}
+
+
+/************************************************************************************/
+/*
+   espRmtAcquire()
+
+   "espAcquire()" for parts of given size, see "espOutputRMT"
+*/
+/************************************************************************************/
+static bool espRmtAcquire(const uint32_t *numBytes, uint8_t numPins)
+{
+  return espAcquire(espRmtBytes(numBytes, numPins));
+}
+
+
+/************************************************************************************/
+/*
+   espRmtReserve()
+
+   "espReserve()" for parts of given size, see "espOutputRMT"
+*/
+/************************************************************************************/
+static bool espRmtReserve(const uint32_t *numBytes, uint8_t numPins)
+{
+  return espReserve(espRmtBytes(numBytes, numPins));
+}
+
+
+/* RMT output backend, parts of all pins are kept in one shared symbol buffer */
+const espOutput_t espOutputRMT =
+{
+  espRmtAcquire,
+  espRelease,
+  espRmtReserve,
+  espAcquireChannel,
+  espReleaseChannel,
+  espShow,
+  espGetDoneBits,
+  ESP_RMT_MAX_PINS
+};
@@ -40,13 +40,117 @@
 
 
 #include <Arduino.h>
+#include <freertos/event_groups.h>
+#include <driver/rmt_tx.h>
+#include <soc/soc_caps.h>
 
 #if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
 #error "The 'ESP32_WS281x' library requires arduino-esp32 version greater than 3.0.0"
 #endif
 
 
+#define ESP_RMT_MAX_PINS 8 //maximum number of pins sent in parallel by one "espShow()" call, limited by number of RMT TX channels
+#define ESP_RMT_MAX_BYTES ((0xFFFFFFFF / sizeof(rmt_symbol_word_t) - ESP_RMT_MAX_PINS) / 8) //maximum number of pixel bytes per "espShow()" call, size of RMT symbols + latch symbols must fit 32-bit
+#define ESP_OUTPUT_MAX_PINS 16 //maximum number of pins of any output backend, see "espOutput_t"
+
+#define ESP_DONE_ALL     ((EventBits_t)0x00FFFFFF)               //all "transaction done" bits, upper 8 bits of event group are reserved by FreeRTOS
+#define ESP_DONE_BIT_I2S ((EventBits_t)1 << ESP_RMT_MAX_PINS)    //"transaction done" bit of I2S/LCD output, bits 0..ESP_RMT_MAX_PINS-1 are RMT channels
+#define ESP_DONE_BIT_SPI ((EventBits_t)1 << (ESP_RMT_MAX_PINS + 1)) //"transaction done" bit of SPI output
+
+
+/*
+   Per-frame encoder settings, applied to every byte while it's converted to
+   RMT symbols so the pixel buffer in RAM is never modified
+*/
+typedef struct
+{
+  const uint16_t* lut;          //256-entry 8.8 fixed-point correction table per byte position in pixel (device order), NULL if not used
+  uint8_t         bytesPerPixel; //3 for RGB-type, 4 for RGBW-type strip, up to LED_MAX_CHANNELS (see "setPixelFormat()")
+  uint16_t        scale;         //uniform scale applied after correction 0..256, 256 = no scaling
+  uint32_t        dirtyFirst;    //first byte of pixel buffer changed since previous frame of the same buffer, see "espI2sSetIncremental()"
+  uint32_t        dirtyLast;     //last changed byte, dirtyFirst > dirtyLast if nothing changed. 0..0xFFFFFFFF if not known
+} espEncoder_t;
+
+
+/*
+   Palette of pre-encoded colors for indexed frames, see "espShowIndexed()"
+*/
+typedef struct
+{
+  const rmt_symbol_word_t* symbols;      //"bytesPerPixel * 8" RMT symbols per color, colors one after another
+  uint8_t                  bytesPerPixel; //bytes per color on the wire, 3..LED_MAX_CHANNELS
+  uint8_t                  bitsPerIndex;  //4 (2 pixels per byte, high nibble first) or 8
+} espPalette_t;
+
+
+/*
+   Run of identical pixels for run-length encoded frames, see "espShowRLE()"
+*/
+#define ESP_RLE_MAX_BYTES 5 //largest pixel of run, bytes (LED_MAX_CHANNELS)
+
+typedef struct
+{
+  uint32_t count;                    //number of pixels in run, 0 is skipped
+  uint8_t  pixel[ESP_RLE_MAX_BYTES]; //color bytes in device order, first "bytesPerPixel" are used
+} espRun_t;
+
+
+/*
+   Output backend, every strip sends its frames through one of them (see
+   "ESP32_WS281x::setOutput()"). Functions follow RMT ones, e.g. "acquire" is
+   "espAcquire()". Buffer sizes are given per part (pin), as in "espShow()"
+*/
+typedef struct
+{
+  bool        (*acquire)(const uint32_t *numBytes, uint8_t numPins);        //take reference to backend & reserve its buffer, see "espAcquire()"
+  void        (*release)();                                                 //give reference back, see "espRelease()"
+  bool        (*reserve)(const uint32_t *numBytes, uint8_t numPins);        //reserve buffer in advance, see "espReserve()"
+  bool        (*acquireChannel)(const uint8_t *pins, uint8_t numPins);      //own output of the pins, see "espAcquireChannel()"
+  void        (*releaseChannel)(const uint8_t *pins, uint8_t numPins);      //see "espReleaseChannel()"
+  bool        (*show)(const uint8_t *pins, uint8_t numPins, uint8_t *pixels, const uint32_t *numBytes, const espEncoder_t *encoder, bool realtime); //see "espShow()"
+  EventBits_t (*getDoneBits)(const uint8_t *pins, uint8_t numPins);         //see "espGetDoneBits()", bits are waited by "espWaitDone()"
+  uint8_t     maxPins;                                                      //maximum number of pins per "show()", up to ESP_OUTPUT_MAX_PINS
+} espOutput_t;
+
+
+/*
+   Apply per-frame encoder settings to one byte, see "espEncoder_t"
+
+   NOTE:
+   - position, byte position in pixel 0..bytesPerPixel-1
+*/
+static inline uint8_t espEncodeValue(const espEncoder_t *encoder, uint8_t value, uint8_t position)
+{
+  if (encoder == NULL) {return value;}
+
+  uint16_t result = value;
+
+  if (encoder->lut != NULL) {result = (encoder->lut[(position << 8) + value] + 0x80) >> 8;}
+  if (encoder->scale < 256) {result = (result * encoder->scale) >> 8;}
+
+  return result;
+}
+
+
+extern const espOutput_t espOutputRMT; //RMT backend, default output of every strip
+
+
 void espInit();
-void espShow(uint8_t pin, uint8_t *pixels, uint32_t numBytes);
+bool espReserve(uint32_t numBytes);
+bool espAcquire(uint32_t numBytes);
+void espRelease();
+bool espAcquireChannel(const uint8_t *pins, uint8_t numPins);
+void espReleaseChannel(const uint8_t *pins, uint8_t numPins);
+EventBits_t espGetDoneBits(const uint8_t *pins, uint8_t numPins);
+bool espWaitDone(EventBits_t doneBits, uint32_t timeoutMs);
+EventGroupHandle_t espGetDoneEvents();
+bool espShow(uint8_t pin, uint8_t *pixels, uint32_t numBytes, const espEncoder_t *encoder = NULL, bool realtime = false);
+bool espShow(const uint8_t *pins, uint8_t numPins, uint8_t *pixels, const uint32_t *numBytes, const espEncoder_t *encoder = NULL, bool realtime = false);
+void espEncodeColor(rmt_symbol_word_t *symbols, const uint8_t *pixel, uint8_t bytesPerPixel, const espEncoder_t *encoder = NULL);
+bool espShowIndexed(uint8_t pin, const uint8_t *indices, uint32_t numPixels, const espPalette_t *palette, bool realtime = false);
+void espSetCache(bool enable);
+const bool espGetCache();
+void espGetCacheStats(uint32_t &hits, uint32_t &misses, bool reset = false);
+bool espShowRLE(uint8_t pin, const espRun_t *runs, uint32_t numRuns, uint8_t bytesPerPixel, const espEncoder_t *encoder = NULL, bool realtime = false);
 
 #endif
\ No newline at end of file
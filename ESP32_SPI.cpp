@@ -0,0 +1,650 @@
+/***************************************************************************************************/
+/*
+   This is an SPI output backend for the "ESP32_WS281x" library. It sends one
+   strip by DMA over SPI peripheral, every data bit is sent as 3 or 4 SPI bits
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_SPI.h"
+
+
+/************************************************************************************/
+/*
+   Local defines & variables
+*/
+/************************************************************************************/
+#define SEMAPHORE_TIMEOUT_MS 50
+
+static SemaphoreHandle_t   _spiMutex    = NULL;
+static spi_host_device_t   _spiHost     = SPI2_HOST;   //SPI host used for output, see "espSpiSetHost()"
+static spi_device_handle_t _spiDevice   = NULL;        //device on "_spiHost", NULL if bus is not attached
+static spi_transaction_t   _spiTrans;                  //transaction in flight, must stay valid until it's done
+static int                 _spiPin      = -1;          //MOSI pin of attached bus
+static uint8_t             _spiOwners   = 0;           //number of owners of attached bus, see "espSpiAcquireChannel()", 0 if time-shared
+static uint32_t            _spiBusSize  = 0;           //maximum transfer size of attached bus, in bytes
+static uint8_t             _spiBits     = 4;           //SPI bits per data bit 3 or 4, see "espSpiSetPattern()"
+static uint16_t            _spiLut[16];                //SPI pattern of every nibble, "_spiBits * 4" bits each
+static uint8_t*            _spiData     = NULL;        //DMA buffer, shared between all instances
+static uint32_t            _spiDataSize = 0;           //size of "_spiData", in bytes
+static uint16_t            _spiDataRefs = 0;           //number of "espSpiAcquire()" calls without "espSpiRelease()"
+static uint32_t            _spiWireTimeMs = 0;         //wire time of last "espSpiShow()", in milliseconds
+
+
+/************************************************************************************/
+/*
+   espSpiDoneCallback()
+
+   SPI "transaction done" interrupt handler, marks SPI output as idle
+
+   NOTE:
+   - transaction includes latch, see "espSpiEncode()"
+*/
+/************************************************************************************/
+static void IRAM_ATTR espSpiDoneCallback(spi_transaction_t *trans)
+{
+  BaseType_t taskWoken = pdFALSE;
+
+  xEventGroupSetBitsFromISR(espGetDoneEvents(), ESP_DONE_BIT_SPI, &taskWoken);
+
+  portYIELD_FROM_ISR(taskWoken);                     //no return value to request context switch, unlike RMT & LCD callbacks
+}
+
+
+/************************************************************************************/
+/*
+   espSpiUpdateLUT()
+
+   Build SPI pattern of every nibble
+
+   NOTE:
+   - 4 SPI bits @ 3.2MHz, 1 SPI bit = 312ns. Bit 0 = 1000 (312ns high & 937ns
+     low), bit 1 = 1110 (937ns high & 312ns low)
+
+   - 3 SPI bits @ 2.4MHz, 1 SPI bit = 417ns. Bit 0 = 100 (417ns high & 833ns
+     low), bit 1 = 110 (833ns high & 417ns low)
+*/
+/************************************************************************************/
+static void espSpiUpdateLUT()
+{
+  uint8_t bit0 = (_spiBits == 3) ? 0b100 : 0b1000;
+  uint8_t bit1 = (_spiBits == 3) ? 0b110 : 0b1110;
+
+  for (uint8_t nibble = 0; nibble < 16; nibble++)
+  {
+    uint16_t pattern = 0;
+
+    for (uint8_t bit = 0; bit < 4; bit++)            //MSB first
+    {
+      pattern = (pattern << _spiBits) | ((nibble & (0x08 >> bit)) ? bit1 : bit0);
+    }
+
+    _spiLut[nibble] = pattern;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espSpiSize()
+
+   Size of DMA buffer for strip of given size
+
+   NOTE:
+   - every byte takes "_spiBits" bytes, latch (300us low) takes "_spiBits * 30"
+     bytes
+
+   - return size in bytes, 0xFFFFFFFF if strip is too long
+*/
+/************************************************************************************/
+static uint32_t espSpiSize(uint32_t numBytes)
+{
+  uint64_t size = ((uint64_t)numBytes + 30) * _spiBits;
+
+  return (size > 0xFFFFFFFF) ? 0xFFFFFFFF : size;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiWaitIdle()
+
+   Wait until SPI output is idle, so DMA buffer is not read
+
+   NOTE:
+   - timeout follows wire time of the last "espSpiShow()"
+
+   - return true if output is idle, false on timeout
+*/
+/************************************************************************************/
+static bool espSpiWaitIdle()
+{
+  return espWaitDone(ESP_DONE_BIT_SPI, _spiWireTimeMs + SEMAPHORE_TIMEOUT_MS);
+}
+
+
+/************************************************************************************/
+/*
+   espSpiResize()
+
+   Grow DMA buffer
+
+   NOTE:
+   - buffer only grows & is replaced only after output is idle, old data is
+     not kept
+
+   - call with "_spiMutex" taken
+
+   - requiredSize, size in bytes
+*/
+/************************************************************************************/
+static void espSpiResize(uint32_t requiredSize)
+{
+  if (requiredSize <= _spiDataSize) {return;}
+
+  if (espSpiWaitIdle() != true) {return;}            //buffer is still in use, keep it
+
+  heap_caps_free(_spiData);
+
+  if ((_spiData = (uint8_t *)heap_caps_malloc(requiredSize, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)) != NULL)
+  {
+    _spiDataSize = requiredSize;
+  }
+  else
+  {
+    _spiDataSize = 0;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espSpiDetach()
+
+   Release SPI bus
+
+   NOTE:
+   - waits until output is idle, frame on the wire is never cut off
+*/
+/************************************************************************************/
+static void espSpiDetach()
+{
+  if (_spiDevice == NULL) {return;}
+
+  spi_transaction_t *done = NULL;
+
+  espWaitDone(ESP_DONE_BIT_SPI, portMAX_DELAY);      //teardown must not be skipped
+
+  spi_device_get_trans_result(_spiDevice, &done, 0); //device with unread result can't be removed
+  spi_bus_remove_device(_spiDevice);
+  spi_bus_free(_spiHost);
+
+  _spiDevice  = NULL;
+  _spiPin     = -1;
+  _spiBusSize = 0;
+  _spiOwners  = 0;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiAttach()
+
+   Initialize SPI bus with MOSI on the pin
+
+   NOTE:
+   - bus on the same pin is kept, otherwise time-shared bus is released first.
+     Bus is initialized again if DMA buffer has grown, bus transfer size is fixed
+
+   - pin, data pin
+
+   - return true on success, false if bus is owned by other pin or can't be
+     initialized (e.g. SPI host is used by other driver)
+*/
+/************************************************************************************/
+static bool espSpiAttach(uint8_t pin)
+{
+  bool samePin = (_spiDevice != NULL) && (_spiPin == pin);
+
+  if ((samePin == true) && (_spiBusSize >= _spiDataSize)) {return true;}
+
+  if ((_spiOwners > 0) && (samePin != true)) {return false;} //bus is owned by other strip
+
+  uint8_t owners = (samePin == true) ? _spiOwners : 0;
+
+  espSpiDetach();
+
+  spi_bus_config_t              busConfig = {};
+  spi_device_interface_config_t devConfig = {};
+
+  busConfig.mosi_io_num     = pin;
+  busConfig.miso_io_num     = -1;
+  busConfig.sclk_io_num     = -1;                    //clock is not needed, timing is encoded in data
+  busConfig.quadwp_io_num   = -1;
+  busConfig.quadhd_io_num   = -1;
+  busConfig.max_transfer_sz = _spiDataSize;
+
+  devConfig.clock_speed_hz  = _spiBits * 800000;     //800kHz data rate, see "espSpiUpdateLUT()"
+  devConfig.mode            = 0;
+  devConfig.spics_io_num    = -1;
+  devConfig.queue_size      = 1;                     //one transaction per "espSpiShow()"
+  devConfig.post_cb         = espSpiDoneCallback;
+
+  if (spi_bus_initialize(_spiHost, &busConfig, SPI_DMA_CH_AUTO) != ESP_OK)
+  {
+    log_e("Failed to init SPI bus on pin %d", pin);
+
+    return false;
+  }
+
+  if (spi_bus_add_device(_spiHost, &devConfig, &_spiDevice) != ESP_OK)
+  {
+    spi_bus_free(_spiHost);
+
+    _spiDevice = NULL;
+
+    log_e("Failed to add SPI device on pin %d", pin);
+
+    return false;
+  }
+
+  _spiPin     = pin;
+  _spiOwners  = owners;
+  _spiBusSize = _spiDataSize;
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiEncode()
+
+   Convert pixel color buffer to SPI bitstream
+
+   NOTE:
+   - every nibble is one table load, see "espSpiUpdateLUT()". SPI sends MSB
+     first, so patterns are stored big-endian
+
+   - out, DMA buffer, see "espSpiSize()"
+*/
+/************************************************************************************/
+static void espSpiEncode(uint8_t *out, const uint8_t *pixels, uint32_t numBytes, const espEncoder_t *encoder)
+{
+  uint8_t bytesPerPixel = (encoder != NULL) ? encoder->bytesPerPixel : 3;
+  uint8_t position      = 0;                         //byte position in pixel
+
+  for (uint32_t b = 0; b < numBytes; b++)
+  {
+    uint8_t  value = espEncodeValue(encoder, pixels[b], position);
+    uint16_t hi    = _spiLut[value >> 4];
+    uint16_t lo    = _spiLut[value & 0x0F];
+
+    if (_spiBits == 3)                               //2 * 12 bits
+    {
+      *out++ = hi >> 4;
+      *out++ = (hi << 4) | (lo >> 8);
+      *out++ = lo;
+    }
+    else                                             //2 * 16 bits
+    {
+      *out++ = hi >> 8;
+      *out++ = hi;
+      *out++ = lo >> 8;
+      *out++ = lo;
+    }
+
+    if (++position >= bytesPerPixel) {position = 0;}
+  }
+
+  memset(out, 0, _spiBits * 30);                     //latch
+}
+
+
+/************************************************************************************/
+/*
+   espSpiReserve()
+
+   Allocate DMA buffer for strip of given size in advance, see "espReserve()"
+
+   NOTE:
+   - owned bus is initialized again if DMA buffer has grown, "espSpiShow()" of
+     realtime strip never attaches the bus, see "espSpiAttach()"
+
+   - return true on success, false if out of memory, buffer is still in use,
+     owned bus can't be initialized again or mutex is not available
+*/
+/************************************************************************************/
+static bool espSpiReserve(const uint32_t *numBytes, uint8_t numPins)
+{
+  bool     result       = false;
+  uint32_t requiredSize = (numPins > 0) ? espSpiSize(numBytes[0]) : 0;
+
+  if ((numPins > ESP_SPI_MAX_PINS) || (requiredSize == 0xFFFFFFFF)) {return false;}
+
+  if (_spiMutex && xSemaphoreTake(_spiMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    espSpiResize(requiredSize);
+
+    result = (_spiDataSize >= requiredSize);
+
+    if ((result == true) && (_spiOwners > 0) && (_spiBusSize < _spiDataSize)) //same pin, owners are kept
+    {
+      result = espSpiAttach(_spiPin);
+    }
+
+    xSemaphoreGive(_spiMutex);
+  }
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiAcquire()
+
+   Take reference to shared DMA buffer & allocate it for strip of given size,
+   see "espAcquire()"
+
+   NOTE:
+   - mutex is created on first call, so all instances using SPI output must be
+     started before launching child threads, see "espInit()"
+*/
+/************************************************************************************/
+static bool espSpiAcquire(const uint32_t *numBytes, uint8_t numPins)
+{
+  espInit();                                         //"transaction done" event group
+
+  if (_spiMutex == NULL)
+  {
+    espSpiUpdateLUT();
+
+    _spiMutex = xSemaphoreCreateMutex();
+  }
+
+  if (_spiMutex && xSemaphoreTake(_spiMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    _spiDataRefs++;
+
+    xSemaphoreGive(_spiMutex);
+  }
+  else
+  {
+    return false;
+  }
+
+  return espSpiReserve(numBytes, numPins);
+}
+
+
+/************************************************************************************/
+/*
+   espSpiRelease()
+
+   Give back reference to shared DMA buffer, see "espRelease()"
+
+   NOTE:
+   - last reference frees DMA buffer & time-shared bus, owned bus stays until
+     its owners release it
+*/
+/************************************************************************************/
+static void espSpiRelease()
+{
+  if (_spiMutex && xSemaphoreTake(_spiMutex, portMAX_DELAY) == pdTRUE) //teardown must not be skipped
+  {
+    if (_spiDataRefs > 0) {_spiDataRefs--;}
+
+    if (_spiDataRefs == 0)
+    {
+      if (_spiOwners == 0) {espSpiDetach();}
+
+      espWaitDone(ESP_DONE_BIT_SPI, portMAX_DELAY);
+
+      heap_caps_free(_spiData);
+
+      _spiData     = NULL;
+      _spiDataSize = 0;
+    }
+
+    xSemaphoreGive(_spiMutex);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espSpiAcquireChannel()
+
+   Initialize SPI bus on the pin & keep it until "espSpiReleaseChannel()"
+
+   NOTE:
+   - there is only one bus, so only strips on the same pin may own it & bus is
+     released by last owner. Other strips can't use SPI output while bus is
+     owned
+
+   - return true on success, false if bus can't be initialized or mutex is not
+     available
+*/
+/************************************************************************************/
+static bool espSpiAcquireChannel(const uint8_t *pins, uint8_t numPins)
+{
+  bool result = false;
+
+  if (numPins != ESP_SPI_MAX_PINS) {return false;}
+
+  if (_spiMutex && xSemaphoreTake(_spiMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    if ((result = espSpiAttach(pins[0])) == true) {_spiOwners++;}
+
+    xSemaphoreGive(_spiMutex);
+  }
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiReleaseChannel()
+
+   Give back SPI bus owned by "espSpiAcquireChannel()"
+*/
+/************************************************************************************/
+static void espSpiReleaseChannel(const uint8_t *pins, uint8_t numPins)
+{
+  if (_spiMutex && xSemaphoreTake(_spiMutex, portMAX_DELAY) == pdTRUE) //teardown must not be skipped
+  {
+    if (_spiOwners > 0) {_spiOwners--;}              //all owners have the same pin, see "espSpiAcquireChannel()"
+
+    if ((_spiOwners == 0) && (_spiDataRefs == 0)) {espSpiDetach();}
+
+    xSemaphoreGive(_spiMutex);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   espSpiGetDoneBits()
+
+   Get "transaction done" bit of the pin, see "espGetDoneBits()"
+
+   NOTE:
+   - return ESP_DONE_BIT_SPI if bus is attached to the pin, 0 otherwise
+*/
+/************************************************************************************/
+static EventBits_t espSpiGetDoneBits(const uint8_t *pins, uint8_t numPins)
+{
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    if ((_spiDevice != NULL) && (_spiPin == pins[i])) {return ESP_DONE_BIT_SPI;}
+  }
+
+  return 0;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiShow()
+
+   Send pixel color buffer (data) to LED drivers via SPI peripheral
+
+   NOTE:
+   - same as "espShow()" for one pin, frame is sent by one DMA transaction.
+     Returns as soon as transaction is queued, output is marked idle by
+     "espSpiDoneCallback()" after latch
+
+   - maximum strip length is limited by DMA transfer size of the chip
+
+   - return true if frame is started, false if frame is dropped
+*/
+/************************************************************************************/
+static bool espSpiShow(const uint8_t *pins, uint8_t numPins, uint8_t *pixels, const uint32_t *numBytes, const espEncoder_t *encoder, bool realtime)
+{
+  bool     result       = false;
+  uint32_t requiredSize = 0;
+
+  if ((numPins != ESP_SPI_MAX_PINS) || (numBytes[0] == 0)) {return (numPins == ESP_SPI_MAX_PINS);} //nothing to send or too many pins
+
+  if ((requiredSize = espSpiSize(numBytes[0])) == 0xFFFFFFFF) {return false;}
+
+  if (_spiMutex && xSemaphoreTake(_spiMutex, SEMAPHORE_TIMEOUT_MS / portTICK_PERIOD_MS) == pdTRUE)
+  {
+    if ((requiredSize > _spiDataSize) && (realtime != true)) {espSpiResize(requiredSize);} //strip wasn't reserved, see "espSpiReserve()"
+
+    bool attached = (_spiDevice != NULL) && (_spiPin == pins[0]) && (_spiBusSize >= requiredSize);
+
+    if ((requiredSize <= _spiDataSize) && (espSpiWaitIdle() == true) && ((attached == true) || ((realtime != true) && (espSpiAttach(pins[0]) == true))))
+    {
+      espSpiEncode(_spiData, pixels, numBytes[0], encoder);
+
+      memset(&_spiTrans, 0, sizeof(_spiTrans));
+
+      _spiTrans.length    = requiredSize * 8;       //in bits
+      _spiTrans.tx_buffer = _spiData;
+
+      xEventGroupClearBits(espGetDoneEvents(), ESP_DONE_BIT_SPI);
+
+      spi_transaction_t *done = NULL;
+
+      spi_device_get_trans_result(_spiDevice, &done, 0); //take result of previous transaction, result queue holds one
+
+      if (spi_device_queue_trans(_spiDevice, &_spiTrans, 0) == ESP_OK)
+      {
+        _spiWireTimeMs = (uint32_t)(((uint64_t)numBytes[0] * 8 * 12 + 3000) / 10000) + 1; //same as RMT, 1.2us per bit + 300us latch
+        result         = true;
+      }
+      else
+      {
+        xEventGroupSetBits(espGetDoneEvents(), ESP_DONE_BIT_SPI);
+
+        log_e("Failed to send SPI data on pin %d", pins[0]);
+      }
+    }
+
+    xSemaphoreGive(_spiMutex);
+  }
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiSetHost()
+
+   Set SPI host used for output
+
+   NOTE:
+   - SPI2_HOST by default, SPI3_HOST is available on ESP32 & ESP32-S2/S3. Host
+     must not be used by other drivers (e.g. SD card, display)
+
+   - call before "begin()" of strips with SPI output
+*/
+/************************************************************************************/
+void espSpiSetHost(spi_host_device_t host)
+{
+  _spiHost = host;
+}
+
+
+/************************************************************************************/
+/*
+   espSpiSetPattern()
+
+   Set number of SPI bits per data bit
+
+   NOTE:
+   - 4 bits (default) has better timing margins, 3 bits takes 25% less memory
+     & DMA bandwidth. See "espSpiUpdateLUT()"
+
+   - call before "begin()" of strips with SPI output
+
+   - bitsPerBit, 3 or 4
+*/
+/************************************************************************************/
+void espSpiSetPattern(uint8_t bitsPerBit)
+{
+  _spiBits = (bitsPerBit == 3) ? 3 : 4;
+
+  espSpiUpdateLUT();
+}
+
+
+/************************************************************************************/
+/*
+   espSpiGetPattern()
+
+   Retrieve number of SPI bits per data bit 3 or 4
+*/
+/************************************************************************************/
+const uint8_t espSpiGetPattern()
+{
+  return _spiBits;
+}
+
+
+/* SPI output backend, one strip, see "ESP32_WS281x::setOutput()" */
+const espOutput_t espOutputSPI =
+{
+  espSpiAcquire,
+  espSpiRelease,
+  espSpiReserve,
+  espSpiAcquireChannel,
+  espSpiReleaseChannel,
+  espSpiShow,
+  espSpiGetDoneBits,
+  ESP_SPI_MAX_PINS
+};
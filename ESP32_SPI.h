@@ -0,0 +1,58 @@
+/***************************************************************************************************/
+/*
+   This is an SPI output backend for the "ESP32_WS281x" library. It sends one
+   strip by DMA over SPI peripheral, every data bit is sent as 3 or 4 SPI bits
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef ESP32_SPI_H
+#define ESP32_SPI_H
+
+
+#include <Arduino.h>
+#include <driver/spi_master.h>
+
+#include "ESP32_RMT.h"
+
+
+#define ESP_SPI_MAX_PINS 1 //one strip per SPI host, data is sent on MOSI pin
+
+
+void espSpiSetHost(spi_host_device_t host);
+void espSpiSetPattern(uint8_t bitsPerBit);
+const uint8_t espSpiGetPattern();
+
+extern const espOutput_t espOutputSPI; //SPI backend, see "ESP32_WS281x::setOutput()"
+
+#endif
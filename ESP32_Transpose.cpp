@@ -0,0 +1,127 @@
+/***************************************************************************************************/
+/*
+   This is a bit-plane transposition engine for the "ESP32_WS281x" library.
+   It turns bytes of up to 16 strips into bus words with one bit per strip,
+   as parallel outputs send them
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_Transpose.h"
+
+
+/************************************************************************************/
+/*
+   espTransposeParts()
+
+   Transpose parts of pixel color buffers to bit planes, one line per part
+
+   NOTE:
+   - parts may be parts of one strip or buffers of different strips, every
+     part must start at pixel boundary. Part shorter than the longest one is
+     sent as 0 after its end
+
+   - plane "k" of byte "b" is written to word "(b * 8 + k) * stride" of out,
+     so planes can be interleaved with other words (e.g. I2S slots). Words
+     between planes are not touched
+
+   - only byte indices first..last are transposed, planes of other indices
+     are kept in out. Caller narrows the range to bytes changed since the
+     previous frame of the same layout (see "espI2sSetIncremental()"), so
+     clean spans cost nothing
+
+   - out, first plane word
+   - wordSize, 1 for up to 8 parts, 2 for up to 16 parts
+   - stride, distance between plane words, in words
+   - parts, pointer to every part
+   - numBytes, size of every part, in bytes
+   - encoder, per-frame encoder settings, see "espEncodeValue()". NULL if not
+     used
+   - first, first byte index to transpose, 0 for whole frame
+   - last, last byte index to transpose, clipped to the longest part
+
+   - return number of transposed byte indices
+*/
+/************************************************************************************/
+uint32_t espTransposeParts(uint8_t *out, uint8_t wordSize, uint8_t stride, const uint8_t *const *parts, const uint32_t *numBytes, uint8_t numParts, const espEncoder_t *encoder, uint32_t first, uint32_t last)
+{
+  uint32_t maxBytes      = 0;
+  uint8_t  bytesPerPixel = (encoder != NULL) ? encoder->bytesPerPixel : 3;
+  uint8_t  values[ESP_TRANSPOSE_MAX_LINES];
+
+  if (numParts > ESP_TRANSPOSE_MAX_LINES) {numParts = ESP_TRANSPOSE_MAX_LINES;}
+
+  for (uint8_t i = 0; i < numParts; i++)
+  {
+    if (numBytes[i] > maxBytes) {maxBytes = numBytes[i];}
+  }
+
+  if (maxBytes == 0)    {return 0;}
+  if (last >= maxBytes) {last = maxBytes - 1;}
+  if (first > last)     {return 0;}                  //nothing changed
+
+  uint8_t position = first % bytesPerPixel;          //byte position in pixel, same for all parts
+
+  memset(values, 0, sizeof(values));                 //unused lines stay 0
+
+  for (uint32_t b = first; b <= last; b++)
+  {
+    for (uint8_t i = 0; i < numParts; i++)
+    {
+      values[i] = (b < numBytes[i]) ? espEncodeValue(encoder, parts[i][b], position) : 0;
+    }
+
+    if (++position >= bytesPerPixel) {position = 0;}
+
+    if (wordSize == 1)
+    {
+      uint8_t  planes[8];
+      uint8_t *word = &out[b * 8 * stride];
+
+      espTranspose8x8(planes, values);
+
+      for (uint8_t k = 0; k < 8; k++, word += stride) {*word = planes[k];}
+    }
+    else
+    {
+      uint16_t  planes[8];
+      uint16_t *word = &((uint16_t *)out)[b * 8 * stride];
+
+      espTranspose16x8(planes, values);
+
+      for (uint8_t k = 0; k < 8; k++, word += stride) {*word = planes[k];}
+    }
+  }
+
+  return last - first + 1;
+}
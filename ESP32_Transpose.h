@@ -0,0 +1,110 @@
+/***************************************************************************************************/
+/*
+   This is a bit-plane transposition engine for the "ESP32_WS281x" library.
+   It turns bytes of up to 16 strips into bus words with one bit per strip,
+   as parallel outputs send them
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef ESP32_TRANSPOSE_H
+#define ESP32_TRANSPOSE_H
+
+
+#include <Arduino.h>
+
+#include "ESP32_RMT.h"
+
+
+#define ESP_TRANSPOSE_MAX_LINES 16 //maximum number of lines (strips), bus word is 8 or 16 bits
+
+
+/*
+   Transpose 8 bytes to 8 bit planes, 8x8 bit matrix
+
+   NOTE:
+   - planes[k] has bit "7 - k" of every value (MSB first), bit "i" of plane is
+     line "i" (values[i])
+
+   - matrix is kept in two 32-bit words & transposed by three delta swaps
+     (2x2, 4x4 & 8x8 blocks). Little-endian load puts line 0 at the lowest
+     bit of every plane
+*/
+static inline void espTranspose8x8(uint8_t *planes, const uint8_t *values)
+{
+  uint32_t x;                                        //lines 4..7
+  uint32_t y;                                        //lines 0..3
+  uint32_t t;
+
+  memcpy(&y, &values[0], 4);                         //values may be unaligned
+  memcpy(&x, &values[4], 4);
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+
+  t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+
+  planes[0] = t >> 24; planes[1] = t >> 16; planes[2] = t >> 8; planes[3] = t;
+  planes[4] = y >> 24; planes[5] = y >> 16; planes[6] = y >> 8; planes[7] = y;
+}
+
+
+/*
+   Transpose 16 bytes to 8 bit planes, 16x8 bit matrix
+
+   NOTE:
+   - same as "espTranspose8x8()", lines 0..7 go to low byte & lines 8..15 to
+     high byte of every plane
+*/
+static inline void espTranspose16x8(uint16_t *planes, const uint8_t *values)
+{
+  uint8_t lo[8];
+  uint8_t hi[8];
+
+  espTranspose8x8(lo, &values[0]);
+  espTranspose8x8(hi, &values[8]);
+
+  for (uint8_t k = 0; k < 8; k++)
+  {
+    planes[k] = ((uint16_t)hi[k] << 8) | lo[k];
+  }
+}
+
+
+uint32_t espTransposeParts(uint8_t *out, uint8_t wordSize, uint8_t stride, const uint8_t *const *parts, const uint32_t *numBytes, uint8_t numParts, const espEncoder_t *encoder = NULL, uint32_t first = 0, uint32_t last = 0xFFFFFFFF);
+
+#endif
@@ -36,6 +36,13 @@
 /***************************************************************************************************/
 
 #include "ESP32_WS281x.h"
+#include "ESP32_Governor.h"
+
+
+/* generated at compile time, exactly one copy in flash */
+constexpr std::array<uint8_t, 256> _ledPixelGammaTable = ledGammaTable<uint8_t>(2.6);
+
+static_assert((_ledPixelGammaTable[24] == 1) && (_ledPixelGammaTable[128] == 42) && (_ledPixelGammaTable[254] == 252) && (_ledPixelGammaTable[255] == 255), "gamma table doesn't match Adafruit_NeoPixel table");
 
 
 /************************************************************************************/
@@ -50,13 +57,25 @@
    - dataPin  Arduino pin number which will drive the LED data in
    - ledType, pixel type
 
-   - to release RMT resources (RMT channels and "led_data"):
-     - call "updateLength(0)" to set number of pixels/bytes to zero
-     - then call "show()" to invoke this code and free resources
+   - RMT resources (RMT channels and symbol buffer) are taken by "begin()" &
+     "acquireChannel()", and released by "end()" or destructor
 */
 /************************************************************************************/
-ESP32_WS281x::ESP32_WS281x(uint16_t ledQnt, int8_t dataPin, ledPixelType ledType) : _isStarted(false), _brightness(0), _pixels(NULL), _endTime(0)
+ESP32_WS281x::ESP32_WS281x(ledIndexType ledQnt, int8_t dataPin, ledPixelType ledType) : _isStarted(false), _brightness(0), _bytesPerPixel(3), _numLEDs(0), _numBytes(0), _pixels(NULL), _pixelsHi(NULL), _ditherErr(NULL), _pixelsWide(NULL), _isCommitted(false), _frames(NULL), _backFrame(0), _frontFrame(1), _readyFrame(2), _modes(0), _lut(NULL), _correction(0xFFFFFFFF), _temperature(0xFFFFFFFF), _whiteColor(LED_WHITE_NONE), _maxCurrent(0), _idleCurrent(1), _dirtyFirst(LED_INDEX_NONE), _dirtyLast(0), _numPins(0), _capacity(0), _isAcquired(false), _governor(NULL), _droppedFrames(0), _isRealtime(false), _output(&espOutputRMT)
 {
+  for (uint8_t i = 0; i < LED_MAX_CHANNELS; i++)
+  {
+    _gamma[i]   = 1.0;
+    _curve[i]   = NULL;
+    _curve16[i] = NULL;
+
+    _channelCurrent[i] = 20; //typical WS2812B & SK6812
+  }
+
+  memset(_powerSum, 0, sizeof(_powerSum));
+
+  updateUnscale();
+
   setPixelType(ledType);  //call before 'setLength()'!!!
   setLength(ledQnt);
 
@@ -78,9 +97,20 @@ ESP32_WS281x::ESP32_WS281x(uint16_t ledQnt, int8_t dataPin, ledPixelType ledType
      "ESP32_WS281x(length, pin, type)"
 */
 /************************************************************************************/
-ESP32_WS281x::ESP32_WS281x() :  _isStarted(false), _pin(-1), _brightness(0), _rOffset(1), _gOffset(0), _bOffset(2), _wOffset(1), _numLEDs(0), _numBytes(0), _pixels(NULL), _endTime(0)
+ESP32_WS281x::ESP32_WS281x() :  _isStarted(false), _pin(-1), _brightness(0), _rOffset(1), _gOffset(0), _bOffset(2), _wOffset(1), _cOffset(1), _bytesPerPixel(3), _numLEDs(0), _numBytes(0), _pixels(NULL), _pixelsHi(NULL), _ditherErr(NULL), _pixelsWide(NULL), _isCommitted(false), _frames(NULL), _backFrame(0), _frontFrame(1), _readyFrame(2), _modes(0), _lut(NULL), _correction(0xFFFFFFFF), _temperature(0xFFFFFFFF), _whiteColor(LED_WHITE_NONE), _maxCurrent(0), _idleCurrent(1), _dirtyFirst(LED_INDEX_NONE), _dirtyLast(0), _numPins(0), _capacity(0), _isAcquired(false), _governor(NULL), _droppedFrames(0), _isRealtime(false), _output(&espOutputRMT)
 {
-  //empty
+  for (uint8_t i = 0; i < LED_MAX_CHANNELS; i++)
+  {
+    _gamma[i]   = 1.0;
+    _curve[i]   = NULL;
+    _curve16[i] = NULL;
+
+    _channelCurrent[i] = 20; //typical WS2812B & SK6812
+  }
+
+  memset(_powerSum, 0, sizeof(_powerSum));
+
+  updateUnscale();
 }
 
 
@@ -88,20 +118,29 @@ ESP32_WS281x::ESP32_WS281x() :  _isStarted(false), _pin(-1), _brightness(0), _rO
 /*
    Destructor
 
-   Deallocate ESP32_WS281x object, set data pin back to INPUT
+   Deallocate ESP32_WS281x object, release RMT resources, set data pin back to
+   INPUT
+
+   NOTE:
+   - strip is removed from its governor first, governor task never touches
+     freed strip, see "ESP32_Governor::removeStrip()"
 */
 /************************************************************************************/
 ESP32_WS281x::~ESP32_WS281x()
 {
-  /* release RMT resources (RMT channels and "led_data") by indirectly calling into "espShow()" */
-  memset(_pixels, 0, _numBytes);
-  _numLEDs  = 0;
-  _numBytes = 0;
-  show();
+  if (_governor != NULL) {_governor->removeStrip(this);} //clears "_governor"
+
+  end();
 
-  free(_pixels);
+  if (_frames != NULL) {free(_frames);} //"_pixels" points into "_frames"
+  else                 {free(_pixels);}
 
-  if (_pin >= 0) {pinMode(_pin, INPUT);}
+  free(_pixelsHi);
+  free(_ditherErr);
+  free(_pixelsWide);
+  free(_lut);
+
+  setPinMode(false);
 }
 
 
@@ -110,493 +149,2785 @@ ESP32_WS281x::~ESP32_WS281x()
    begin()
 
    Configure "ESP32_WS281x" data pin for output
+
+   NOTE:
+   - takes reference to RMT symbol buffer shared by all strips, buffer is
+     allocated here, not on first "show()". Call "end()" to give it back
+
+   - in realtime mode RMT channel(s) are acquired here too, see "setRealtime()"
 */
 /************************************************************************************/
 void ESP32_WS281x::begin()
 {
+  if (_isStarted != true)
+  {
+    uint32_t numBytes[ESP_OUTPUT_MAX_PINS];
+    uint8_t  numParts = getPartCapacity(numBytes);
+
+    espInit();                             //initialize mutex
+    _output->acquire(numBytes, numParts);  //see NOTE
+  }
+
   _isStarted = true; //true if "begin()" called
 
-  setPin(_pin);      //set data pin as output, call after "_isStarted = true"
-  espInit();         //initialize mutex
+  setPinMode(true);  //set data pin(s) as output, call after "_isStarted = true"
+
+  if (_isRealtime == true) {acquireChannel();} //call after "setPinMode()", RMT takes over the pin(s)
 }
 
 
 /************************************************************************************/
 /*
-   canShow()
+   end()
 
-   check whether a call to "show()" will start sending data immediately or will
-   'block' for a required interval
+   Release RMT resources taken by "begin()" & "acquireChannel()", set data pin(s)
+   back to INPUT
 
    NOTE:
-   - LED driver require a short quiet time (about 300 microseconds) after the
-     last bit is received before the data 'latches' and new data can start being
-     received. Usually one's sketch is implicitly using this time to generate a
-     new frame of animation...but if it finishes very quickly, this function
-     could be used to see if there's some idle time available for some low-priority
-     concurrent task.
-
-   - return true if "show()" will start sending immediately, false if "show()"
-     would block (meaning some idle time is available for other tasks)
-
-
-   - it's normal and possible for "_endTime" to exceed "micros()" if the 32-bit
-     clock counter has rolled over (about every 70 minutes). The problem arises
-     if code invokes "show()" very infrequently...the "micros()" counter may roll
-     over MULTIPLE times in that interval, the delta calculation is no longer correct
-     and the next update may stall for a very long time. The check below resets the
-     latch counter if a rollover has occurred. This can cause an extra delay of up to
-     300 microseconds in the rare case where a "show()" call happens precisely around
-     the rollover, but that's neither likely nor especially harmful, vs. other code 
-     that might stall for 30+ minutes, or having to document and frequently remind
-     and/or provide tech support explaining an unintuitive need for "show()" calls at
-     least once an hour
+   - pixel buffers are kept, strip can be started again by "begin()"
+   - RMT symbol buffer is freed when last started strip calls "end()"
 */
-/************************************************************************************/ 
-bool ESP32_WS281x::canShow()
+/************************************************************************************/
+void ESP32_WS281x::end()
 {
-  uint32_t now = micros();
+  if (_isStarted != true) {return;}
 
-  if (_endTime > now) {_endTime = now;}
+  waitShow();
+  releaseChannel();
+  _output->release();
+  setPinMode(false);
 
-  return (now - _endTime) >= 300L; //300 microseconds
+  _isStarted = false;
 }
 
 
-/**************************************************************************/
+/************************************************************************************/
 /*
-   show()
+   acquireChannel()
 
-   Transmit pixel data in RAM to LED drivers
+   Attach RMT TX channel to the data pin(s) of strip & keep it until
+   "releaseChannel()" or "end()"
 
    NOTE:
-   - ESP32 may not disable interrupts because "espShow()" uses RMT which tries
-     to acquire locks
+   - without own channel all strips time-share RMT channels, "show()" of strip
+     on other pin releases channel & initializes a new one. Strip with own
+     channel is sent without RMT channel reconfiguration
+
+   - number of RMT TX channels is limited (8 on ESP32, 4 on ESP32-S2/S3, 2 on
+     ESP32-C3/C6/H2), other strips time-share remaining channels
 
-   - data latch = 300+ microsecond pause in the output stream. Rather than
-     put a delay at the end of the function, the ending time is noted and
-     the function will simply hold off (if needed) on issuing the
-     subsequent round of data until the latch time has elapsed. This
-     allows the mainline code to start generating the next frame of data
-     rather than stalling for the latch.
+   - "setPin()" & "setPins()" move owned channel(s) to the new pin(s)
 
-   - "_endTime" is a private member (rather than global var) so that
-     multiple class instances on different pins can be quickly issued in
-     succession (each instance doesn't delay the next)
+   - return true on success, false if strip is not started or RMT channel
+     can't be initialized
 */
-/**************************************************************************/ 
-void ESP32_WS281x::show()
+/************************************************************************************/
+bool ESP32_WS281x::acquireChannel()
 {
-  if (!_pixels) {return;}
+  if (_isStarted  != true) {return false;}
+  if (_isAcquired == true) {return true;}
 
-//while (canShow() != true){//empty}  //see NOTE
-  while (canShow() != true){yield();} //see NOTE
+  if (_numPins > 0)
+  {
+    _isAcquired = _output->acquireChannel(_pins, _numPins);
+  }
+  else if (_pin >= 0)
+  {
+    uint8_t pin = _pin;
 
-  espShow(_pin, _pixels, _numBytes);
+    _isAcquired = _output->acquireChannel(&pin, 1);
+  }
 
-  _endTime = micros(); // Save EOD time for latch on next call
+  return _isAcquired;
 }
 
 
 /************************************************************************************/
 /*
-   setPin()
-
-   Set (change) "ESP32_WS281x" output pin number on the fly
+   releaseChannel()
 
-   NOTE:
-   - previous pin (if any) is set to INPUT and the new pin is set to OUTPUT
-   - Arduino pin number -1=no pin
+   Give back RMT TX channel(s) taken by "acquireChannel()"
 */
 /************************************************************************************/
-void ESP32_WS281x::setPin(int8_t dataPin)
+void ESP32_WS281x::releaseChannel()
 {
-  if ((_isStarted == true) && (_pin >= 0)) {pinMode(_pin, INPUT);} //disable existing data output pin
-
-  _pin = dataPin;
+  if (_isAcquired != true) {return;}
 
-  if (_isStarted == true)
+  if (_numPins > 0)
   {
-    pinMode(_pin, OUTPUT);
-    digitalWrite(_pin, LOW);
+    _output->releaseChannel(_pins, _numPins);
   }
+  else
+  {
+    uint8_t pin = _pin;
+
+    _output->releaseChannel(&pin, 1);
+  }
+
+  _isAcquired = false;
 }
 
 
 /************************************************************************************/
 /*
-   getPin()
+   setRealtime()
 
-   Retrieve pin number used for "ESP32_WS281x" data output
+   Enable/disable deterministic "show()" timing
 
    NOTE:
-   - return pin number -1 if not set
+   - all resources are claimed in advance: symbol buffer for strip capacity (see
+     "reserve()") & own RMT channel(s) (see "acquireChannel()"). "show()" never
+     allocates memory or reconfigures RMT channels & every wait is bounded, see
+     "espShow()". Frame that can't be sent this way is dropped & counted, see
+     "getDroppedFrames()"
+
+   - call "reserve()" before, "setLength()" beyond capacity allocates memory
+
+   - may be called before "begin()", resources are claimed by "begin()". Call
+     after "begin()" to check the result
+
+   - enable, true to enable realtime mode
+
+   - return true on success, false if resources can't be claimed (realtime mode
+     is enabled anyway, "show()" drops frames until they are claimed)
 */
 /************************************************************************************/
-const int8_t ESP32_WS281x::getPin()
+bool ESP32_WS281x::setRealtime(bool enable)
 {
-  return _pin;
+  _isRealtime = enable;
+
+  if ((enable != true) || (_isStarted != true)) {return true;}
+
+  return (reserveOutput() == true) && (acquireChannel() == true);
 }
 
 
 /************************************************************************************/
 /*
-   setBrightness()
-
-   Adjust output brightness. Does not immediately affect what's currently displayed
-   on the LEDs. The next call to "show()" will refresh the LEDs at this level.
-
-   NOTE:
-   - brightness setting 0..255 (minimum/off to full brightest)
-   - this was intended for one-time use in one's setup() function not as an
-     animation effect in itself. Because of the way this library "pre-multiplies"
-     LED colors in RAM, changing the brightness is often a "lossy" operation what
-     you write to pixels isn't necessary the same as what you'll read back.
-
-
-   - stored brightness value is different than what's passed. This simplifies the
-     actual scaling math later, allowing a fast 8x8-bit multiply and taking the
-     MSB. 'brightness' is a uint8_t, adding 1 here may (intentionally) roll over...
-     so 0 = max brightness (color values are interpreted literally; no scaling),
-     1 = min brightness (off), 255 = just below max brightness.
+   getRealtime()
 
-   - re-scale brightness existing data in RAM is potentially "lossy" process
-     especially when increasing brightness. The tight timing in the WS2811/WS2812
-     code means there aren't enough free cycles to perform this scaling on the fly
-     as data is issued. So we make a pass through the existing color data in RAM and
-     scale it (subsequent graphics commands also work at this brightness level). If
-     there's a significant step up in brightness, the limited number of steps
-     (quantization) in the old data will be quite visible in the re-scaled version.
-     For a non-destructive change, you'll need to re-render the full strip data.
-     C'est la vie.
+   Retrieve realtime mode state, see "setRealtime()"
 */
 /************************************************************************************/
-void ESP32_WS281x::setBrightness(uint8_t brightness)
+const bool ESP32_WS281x::getRealtime()
 {
+  return _isRealtime;
+}
 
-  uint8_t newBrightness = brightness + 1; //see NOTE
 
-  if (newBrightness != _brightness) //see NOTE
-  {
-    uint8_t  c            = 0;
-    uint8_t* ptr          = _pixels;
-    uint8_t oldBrightness = _brightness - 1; //de-wrap old "_brightness" value
-    uint16_t scale        = 0;
+/************************************************************************************/
+/*
+   canShow()
 
-    if      (oldBrightness == 0) {scale = 0;}                     //avoid /0
-    else if (brightness == 255)  {scale = 65535 / oldBrightness;}
-    else                         {scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;}
+   check whether a call to "show()" will start sending data immediately or will
+   'block' for a required interval
 
-    for (uint16_t i = 0; i < _numBytes; i++)
-    {
-      c      = *ptr;
-      *ptr++ = (c * scale) >> 8;
-    }
+   NOTE:
+   - LED driver require a short quiet time (about 300 microseconds) after the
+     last bit is received before the data 'latches' and new data can start being
+     received. Latch is sent as part of the frame, channel becomes idle after it.
+     Usually one's sketch is implicitly using this time to generate a new frame
+     of animation...but if it finishes very quickly, this function could be used
+     to see if there's some idle time available for some low-priority concurrent
+     task.
 
-    _brightness = newBrightness;
-  }
+   - return true if previous frame (latch included) is done, false if "show()"
+     would block (meaning some idle time is available for other tasks)
+
+   - RMT symbol buffer is shared, so "show()" may still wait for frames of other
+     strips that are on the wire
+*/
+/************************************************************************************/ 
+bool ESP32_WS281x::canShow()
+{
+  return espWaitDone(getDoneBits(), 0);
 }
 
+
 /************************************************************************************/
 /*
-   getBrightness()
+   waitShow()
 
-   Retrieve the last-set brightness value for the LED drivers strip
+   Wait until previous frame (latch included) is sent
 
    NOTE:
-   - return 0..255 (minimum/off to full brightest)
+   - "show()" returns as soon as frame is started, waiting task is blocked
+     until RMT "transaction done" interrupt, no CPU time is spent
+
+   - timeoutMs, maximum waiting time in milliseconds
+
+   - return true if frame is sent, false on timeout
 */
 /************************************************************************************/
-const uint8_t ESP32_WS281x::getBrightness()
+bool ESP32_WS281x::waitShow(uint32_t timeoutMs)
 {
-  return (_brightness - 1);
+  return espWaitDone(getDoneBits(), timeoutMs);
 }
 
 
 /************************************************************************************/
 /*
-   setLength()
+   waitShow()
 
-   Change the length of a previously-declared "ESP32_WS281x" strip object. Old data
-   is deallocated and new data is cleared, pin number and pixel format are unchanged
+   Wait until previous frames of several strips are sent
 
    NOTE:
-   - ledQnt, new length of strip, in pixels
+   - one wait for all strips, e.g. after "show()" of every strip
 
-   - his function is deprecated, here only for old projects that may still be
-     calling it. New projects should instead use the constructor
-     "ESP32_WS281x(length, pin, type)"
+   - strips, list of strips, NULL entries are skipped
+   - numStrips, number of strips in list
+   - timeoutMs, maximum waiting time in milliseconds
+
+   - return true if all frames are sent, false on timeout
 */
 /************************************************************************************/
-void ESP32_WS281x::setLength(uint16_t ledQnt)
+bool ESP32_WS281x::waitShow(ESP32_WS281x *const *strips, uint8_t numStrips, uint32_t timeoutMs)
 {
-  free(_pixels); //free existing data, if any
-
-  _numBytes = ledQnt * ((_wOffset == _rOffset) ? 3 : 4); //recalculate size of "_pixels" buffer, ALL PIXELS ARE CLEARED
-
-  if ((_pixels = (uint8_t *)malloc(_numBytes)) != NULL)
-  {
-    memset(_pixels, 0, _numBytes);
+  EventBits_t doneBits = 0;
 
-    _numLEDs = ledQnt;
-  }
-  else
+  for (uint8_t i = 0; i < numStrips; i++)
   {
-    _numLEDs  = 0;
-    _numBytes = 0;
+    if (strips[i] != NULL) {doneBits |= strips[i]->getDoneBits();}
   }
+
+  return espWaitDone(doneBits, timeoutMs);
 }
 
 
 /************************************************************************************/
 /*
-   getLength()
-
-   Return the number of pixels/LEDs in an "ESP32_WS281x" strip object
+   getDoneBits()
 
-   NOTE:
-   - return pixel count (quantity), 0 if not set
+   Get "transaction done" bits of output of data pin(s), see "espGetDoneBits()"
 */
 /************************************************************************************/
-const uint16_t ESP32_WS281x::getLength()
+EventBits_t ESP32_WS281x::getDoneBits()
 {
-  return _numLEDs;
+  if (_numPins > 0) {return _output->getDoneBits(_pins, _numPins);}
+
+  if (_pin < 0) {return 0;}
+
+  uint8_t pin = _pin;
+
+  return _output->getDoneBits(&pin, 1);
 }
 
 
-/************************************************************************************/
+/**************************************************************************/
 /*
-   setPixelType()
+   show()
 
-   Change pixel format of a previously-declared "ESP32_WS281x" strip object.
+   Transmit pixel data in RAM to LED drivers
 
    NOTE:
-   - if format changes from one of the RGB variants to an RGBW variant
-     (or RGBW to RGB), the old data will be deallocated and new data is cleared.
-     Otherwise, the old data will remain in RAM and is not reordered to the new
-     format, so it's advisable to follow up with clear()
+   - ESP32 may not disable interrupts because "espShow()" uses RMT which tries
+     to acquire locks
 
-   - his function is deprecated, here only for old projects that may still be
-     calling it. New projects should instead use the constructor
-     "ESP32_WS281x(length, pin, type)"
+   - data latch = 300+ microsecond pause in the output stream, sent at the
+     end of the frame. Function returns as soon as frame is started, so the
+     mainline code starts generating the next frame of data rather than
+     stalling for the wire time & latch. See "waitShow()"
+
+   - frame is encoded before return, pixel buffer may be changed right away.
+     Next "show()" of any strip waits until previous frames are sent, RMT
+     symbol buffer is shared
+
+   - with dithering enabled every call sends the next dithered frame, so keep
+     calling "show()" at a steady high rate even if colors don't change
+
+   - with triple buffering enabled the latest frame published by "commit()" is
+     sent (or the last sent frame again if nothing new was committed), never
+     the frame being drawn. See "setTripleBuffering()"
+
+   - with power limiter enabled frame is scaled down by the encoder if its
+     estimated current exceeds the budget. See "setMaxCurrent()"
 */
-/************************************************************************************/
-void ESP32_WS281x::setPixelType(ledPixelType ledType)
+/**************************************************************************/ 
+void ESP32_WS281x::show()
 {
-  bool oldThreeBytesPerPixel = (_wOffset == _rOffset); //false if RGBW
+  if (!_pixels) {return;}
 
-  _wOffset = (ledType >> 6) & 0b11; //see notes in header file
-  _rOffset = (ledType >> 4) & 0b11; //regarding R/G/B/W offsets
-  _gOffset = (ledType >> 2) & 0b11;
-  _bOffset = (ledType & 0b11);
+  espEncoder_t encoder;
+  uint8_t*     pixels = _pixels;
+  uint8_t      frame  = _backFrame;         //0 without triple buffering
+
+  encoder.lut           = _lut;
+  encoder.bytesPerPixel = _bytesPerPixel;
+  encoder.scale         = 256;
+  encoder.dirtyFirst    = 0;                //not known, whole frame is encoded
+  encoder.dirtyLast     = 0xFFFFFFFF;
+
+  if ((_pixelsHi == NULL) && (_frames == NULL)) //sent bytes change only where pixels were written, see "getDirtyRange()"
+  {
+    encoder.dirtyFirst = (_dirtyFirst > _dirtyLast) ? 1 : ((uint32_t)_dirtyFirst * _bytesPerPixel); //1 > 0 if nothing changed
+    encoder.dirtyLast  = (_dirtyFirst > _dirtyLast) ? 0 : ((uint32_t)_dirtyLast * _bytesPerPixel + _bytesPerPixel - 1);
+  }
+
+  if (_pixelsWide != NULL)                  //16-bit channels, see "setChannelDepth()"
+  {
+    encodeFrame16((_maxCurrent != 0) ? powerScale(frame) : 256);
+
+    pixels                = _pixelsWide;
+    encoder.lut           = NULL;            //correction & power limit already applied by "encodeFrame16()"
+    encoder.bytesPerPixel = encoder.bytesPerPixel * 2;
+  }
+  else if (_pixelsHi != NULL)               //reduce 16-bit working buffer to 8-bit "_pixels"
+  {
+    ditherFrame();
+
+    encoder.lut = NULL;                     //correction already applied by "ditherFrame()"
+  }
+
+  if (_frames != NULL)                      //triple buffering enabled, send latest committed frame
+  {
+    if (__atomic_load_n(&_readyFrame, __ATOMIC_ACQUIRE) & LED_FRAME_FRESH)
+    {
+      _frontFrame = __atomic_exchange_n(&_readyFrame, _frontFrame, __ATOMIC_ACQ_REL) & LED_FRAME_INDEX_MASK;
+    }
 
-  //if bytes-per-pixel has changed (and pixel data was previously allocated), re-allocate to new size will clear any data
-  if (_pixels != NULL)
+    frame  = _frontFrame;
+    pixels = &_frames[_frontFrame * _capacity];
+  }
+
+  if ((_maxCurrent != 0) && (_pixelsWide == NULL)) {encoder.scale = powerScale(frame);} //see "setMaxCurrent()"
+
+  bool sent = false;
+
+  if (_numPins == 0)
   {
-    bool newThreeBytesPerPixel = (_wOffset == _rOffset);
+    uint8_t  pin      = _pin;
+    uint32_t numBytes = (_pixelsWide != NULL) ? (_numBytes * 2) : _numBytes;
+
+    sent = _output->show(&pin, 1, pixels, &numBytes, &encoder, _isRealtime);
+  }
+  else                                //virtual strip, send part of every pin in parallel, see "setPins()"
+  {
+    uint8_t  bytesPerPixel = encoder.bytesPerPixel;
+    ledIndexType ledIndex  = 0;
+    uint32_t numBytes[ESP_OUTPUT_MAX_PINS];
+
+    for (uint8_t i = 0; i < _numPins; i++)
+    {
+      ledIndexType numOfLEDs = (_pinLEDs[i] < (_numLEDs - ledIndex)) ? _pinLEDs[i] : (_numLEDs - ledIndex); //strip may be shortened by "setLength()"
+
+      numBytes[i] = (uint32_t)numOfLEDs * bytesPerPixel;
+      ledIndex   += numOfLEDs;
+    }
 
-    if (newThreeBytesPerPixel != oldThreeBytesPerPixel) {setLength(_numLEDs);}
+    sent = _output->show(_pins, _numPins, pixels, numBytes, &encoder, _isRealtime);
   }
+
+  if (sent != true) {__atomic_fetch_add(&_droppedFrames, 1, __ATOMIC_RELAXED);} //see "getDroppedFrames()", "commit()" may count on another core
+
+  if ((_frames == NULL) && (sent == true)) {_dirtyFirst = LED_INDEX_NONE; _dirtyLast = 0;} //frame is on LEDs, see "getDirtyRange()"
+
+  if (_governor == NULL) {_isCommitted = false;} //committed frame is sent. Governor clears flag before "show()", so "commit()" landing meanwhile is kept
 }
 
 
 /************************************************************************************/
 /*
-   strToPixelType()
+   commit()
 
-   Convert pixel color order from string (e.g. "BGR") to "ESP32_WS281x"
-   color order constant (e.g. LED_BGR). This may be helpful for code
-   that initializes from text configuration rather than compile-time
-   constants
+   Mark pixel data in RAM as a complete frame, ready to be sent by "show()" or
+   "ESP32_Governor"
 
    NOTE:
-   - strValue, input string. Should be reasonably sanitized (a 3..4 character
-     NUL-terminated string) or undefined behavior may result (output is still a
-     valid "ESP32_WS281x" order constant, but might not present as expected).
-     Garbage in, garbage out
+   - governor task sends strip on the next tick and clears the flag, call
+     "show()" directly if strip is not attached to the governor
 
-   - return "ESP32_WS281x" color order constants (e.g. LED_BGR)
+   - without triple buffering governor reads "_pixels" while sending, so don't
+     draw the next frame until "ESP32_Governor::waitFrame()" returns
 
-   - this function is declared static in the class so it can be called without a
-     "ESP32_WS281x" object (since it's not likely been declared in the code yet).
-     Use "ESP32_WS281x::str2order()"
+   - with triple buffering the drawn frame is published with a single atomic
+     exchange and drawing continues in another frame right away, no locks.
+     Power limiter sums (see "setMaxCurrent()") are kept per frame, so they
+     follow the frames without recalculation.
+     The new frame has stale content (frame sent 1..2 commits ago), pass
+     "copyFrame = true" to continue drawing on top of the committed frame
+
+   - ready frame is a queue of one frame that keeps only the newest frame. If
+     producer commits faster than strip is sent (e.g. network task receiving
+     frames), the previous unsent frame is dropped & counted, producer never
+     waits for the wire. See "getDroppedFrames()"
+
+   - with governor in free-run mode (see "ESP32_Governor::setFPS()") every
+     commit wakes up governor task, so frame is sent as soon as strip is idle
+
+   - copyFrame, true to copy committed frame to the new drawing frame
+*/
+/************************************************************************************/
+void ESP32_WS281x::commit(bool copyFrame)
+{
+  if (_frames != NULL) //triple buffering enabled, swap drawing frame with ready frame
+  {
+    uint8_t  committedFrame = _backFrame;
+    uint32_t readyFrame     = __atomic_exchange_n(&_readyFrame, committedFrame | LED_FRAME_FRESH, __ATOMIC_ACQ_REL);
+
+    if (readyFrame & LED_FRAME_FRESH) {__atomic_fetch_add(&_droppedFrames, 1, __ATOMIC_RELAXED);} //replaced before "show()" picked it up
+
+    _backFrame = readyFrame & LED_FRAME_INDEX_MASK;
+    _pixels    = &_frames[_backFrame * _capacity];
+
+    if (copyFrame == true)
+    {
+      memcpy(_pixels, &_frames[committedFrame * _capacity], _numBytes);
+      memcpy(_powerSum[_backFrame], _powerSum[committedFrame], sizeof(_powerSum[0]));
+    }
+
+    _dirtyFirst = LED_INDEX_NONE;  //new drawing frame, see "getDirtyRange()"
+    _dirtyLast  = 0;
+  }
+  else if (_isCommitted == true)   //previous commit is not sent yet & will be overwritten
+  {
+    __atomic_fetch_add(&_droppedFrames, 1, __ATOMIC_RELAXED);
+  }
+
+  _isCommitted = true;
+
+  if (_governor != NULL) {_governor->wakeUp();}
+}
+
+
+/************************************************************************************/
+/*
+   getDroppedFrames()
+
+   Retrieve number of committed frames that were never sent
+
+   NOTE:
+   - frame is dropped when "commit()" is called again before "show()" sent it,
+     only the newest frame is sent. Frame is dropped also if "show()" can't
+     send it (e.g. RMT mutex timeout, see "setRealtime()"). Counter wraps around
+     at 2^32
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x::getDroppedFrames()
+{
+  return __atomic_load_n(&_droppedFrames, __ATOMIC_RELAXED);
+}
+
+
+/************************************************************************************/
+/*
+   setPin()
+
+   Set (change) "ESP32_WS281x" output pin number on the fly
+
+   NOTE:
+   - previous pin (if any) is set to INPUT and the new pin is set to OUTPUT
+   - virtual strip (see "setPins()") becomes a regular strip on the new pin
+   - Arduino pin number -1=no pin
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPin(int8_t dataPin)
+{
+  bool acquired = _isAcquired;
+
+  waitShow();                                  //last frame must leave old pin(s) first
+  releaseChannel();                            //see "acquireChannel()"
+
+  if (_isStarted == true) {setPinMode(false);} //disable existing data output pin(s)
+
+  _numPins = 0;
+  _pin     = dataPin;
+
+  if (_isStarted == true) {setPinMode(true);}
+
+  if (acquired == true) {acquireChannel();}
+}
+
+
+/************************************************************************************/
+/*
+   getPin()
+
+   Retrieve pin number used for "ESP32_WS281x" data output
+
+   NOTE:
+   - return pin number -1 if not set
+*/
+/************************************************************************************/
+const int8_t ESP32_WS281x::getPin()
+{
+  return _pin;
+}
+
+
+/************************************************************************************/
+/*
+   setPins()
+
+   Turn strip into virtual strip spanning several physical strips on different
+   pins, sent in parallel by one "show()"
+
+   NOTE:
+   - index space of virtual strip is all physical strips one after another,
+     e.g. pins {5, 18} & lengths {100, 50} maps pixels 0..99 to pin 5 and
+     100..149 to pin 18. All drawing functions, segments, matrices, dithering,
+     triple buffering, correction & power limiter work on the whole strip
+
+   - every pin gets its own RMT TX channel, so number of pins is limited by
+     the chip (8 on ESP32, 4 on ESP32-S2/S3, 2 on ESP32-C3/C6/H2) & by
+     ESP_RMT_MAX_PINS. Other strips sent by "show()" share the same channels.
+     I2S output sends up to ESP_I2S_MAX_PINS pins by one DMA transfer, see
+     "setOutput()"
+
+   - strip length is set to the sum of lengths, ALL PIXELS ARE CLEARED
+   - "getPin()" returns first pin, "setPin()" turns strip back to regular one
+
+   - dataPins, list of Arduino pin numbers
+   - ledQnt, list of number of LEDs on every pin
+   - numOfPins, number of pins 1..maximum number of pins of output backend
+     (ESP_RMT_MAX_PINS for RMT)
+
+   - return true on success, false if list or any pin is invalid or total
+     length is out of range (strip is not changed)
+*/
+/************************************************************************************/
+bool ESP32_WS281x::setPins(const int8_t *dataPins, const ledIndexType *ledQnt, uint8_t numOfPins)
+{
+  if ((dataPins == NULL) || (ledQnt == NULL) || (numOfPins == 0) || (numOfPins > _output->maxPins)) {return false;}
+
+  uint64_t total = 0;
+
+  for (uint8_t i = 0; i < numOfPins; i++)
+  {
+    if (dataPins[i] < 0) {return false;}
+
+    total += ledQnt[i];
+  }
+
+  if (total > LED_INDEX_NONE) {return false;}
+
+  bool acquired = _isAcquired;
+
+  waitShow();                                  //last frame must leave old pin(s) first
+  releaseChannel();                            //see "acquireChannel()"
+
+  if (_isStarted == true) {setPinMode(false);} //disable existing data output pin(s)
+
+  for (uint8_t i = 0; i < numOfPins; i++)
+  {
+    _pins[i]    = dataPins[i];
+    _pinLEDs[i] = ledQnt[i];
+  }
+
+  _numPins = numOfPins;
+  _pin     = dataPins[0];
+
+  setLength(total);
+
+  if (_isStarted == true) {setPinMode(true);}
+
+  if (acquired == true) {acquireChannel();}
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   getNumPins()
+
+   Retrieve number of output pins
+
+   NOTE:
+   - return number of pins of virtual strip (see "setPins()"), 1 for regular
+     strip with pin set, 0 if pin is not set
+*/
+/************************************************************************************/
+const uint8_t ESP32_WS281x::getNumPins()
+{
+  if (_numPins > 0) {return _numPins;}
+
+  return (_pin >= 0) ? 1 : 0;
+}
+
+
+/************************************************************************************/
+/*
+   setOutput()
+
+   Set output backend of strip
+
+   NOTE:
+   - &espOutputRMT (default), every pin gets its own RMT TX channel
+
+   - &espOutputI2S, all pins are clocked out in parallel by one DMA transfer of
+     I2S/LCD peripheral in i80 mode, up to ESP_I2S_MAX_PINS pins. Needs two spare
+     pins for bus clock & D/C, see "espI2sSetClockPin()" & "espI2sSetDcPin()".
+     There is only one bus, so only one strip (or strips with the same pins)
+     can use it at a time
+
+   - &espOutputSPI, one pin, data is sent by DMA transfer of SPI peripheral,
+     every bit as 3 or 4 SPI bits. Frees RMT channels for other strips, see
+     "espSpiSetPattern()" & "espSpiSetHost()"
+
+   - references & owned channels are moved to the new backend, so output may
+     be changed any time. Drawing functions & "show()" work the same way
+
+   - output, pointer to output backend
+
+   - return true on success, false if output is NULL or strip has more pins
+     than output supports (output is not changed)
+*/
+/************************************************************************************/
+bool ESP32_WS281x::setOutput(const espOutput_t *output)
+{
+  if ((output == NULL) || (getNumPins() > output->maxPins)) {return false;}
+
+  if (output == _output) {return true;}
+
+  bool acquired = _isAcquired;
+
+  waitShow();                                  //last frame must leave old output first
+  releaseChannel();
+
+  if (_isStarted == true) {_output->release();}
+
+  _output = output;
+
+  if (_isStarted == true)
+  {
+    uint32_t numBytes[ESP_OUTPUT_MAX_PINS];
+    uint8_t  numParts = getPartCapacity(numBytes);
+
+    _output->acquire(numBytes, numParts);
+  }
+
+  if ((acquired == true) || (_isRealtime == true)) {acquireChannel();}
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   getOutput()
+
+   Retrieve output backend of strip, see "setOutput()"
+*/
+/************************************************************************************/
+const espOutput_t* ESP32_WS281x::getOutput()
+{
+  return _output;
+}
+
+
+/************************************************************************************/
+/*
+   setPinMode()
+
+   Set all output pins of strip to OUTPUT & LOW or back to INPUT
+
+   NOTE:
+   - output, true for OUTPUT, false for INPUT
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPinMode(bool output)
+{
+  uint8_t numPins = (_numPins > 0) ? _numPins : 1;
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    int8_t pin = (_numPins > 0) ? _pins[i] : _pin;
+
+    if (pin < 0) {continue;}
+
+    if (output == true)
+    {
+      pinMode(pin, OUTPUT);
+      digitalWrite(pin, LOW);
+    }
+    else
+    {
+      pinMode(pin, INPUT);
+    }
+  }
+}
+
+
+/************************************************************************************/
+/*
+   setBrightness()
+
+   Adjust output brightness. Does not immediately affect what's currently displayed
+   on the LEDs. The next call to "show()" will refresh the LEDs at this level.
+
+   NOTE:
+   - brightness setting 0..255 (minimum/off to full brightest)
+   - this was intended for one-time use in one's setup() function not as an
+     animation effect in itself. Because of the way this library "pre-multiplies"
+     LED colors in RAM, changing the brightness is often a "lossy" operation what
+     you write to pixels isn't necessary the same as what you'll read back.
+
+
+   - stored brightness value is different than what's passed. This simplifies the
+     actual scaling math later, allowing a fast 8x8-bit multiply and taking the
+     MSB. 'brightness' is a uint8_t, adding 1 here may (intentionally) roll over...
+     so 0 = max brightness (color values are interpreted literally; no scaling),
+     1 = min brightness (off), 255 = just below max brightness.
+
+   - existing data in RAM is re-scaled through 256-entry table built once per
+     call, 4 bytes per loop pass, so no byte is multiplied or divided. Read back
+     uses table of the new brightness, see "updateUnscale()"
+
+   - re-scale brightness existing data in RAM is potentially "lossy" process
+     especially when increasing brightness. The tight timing in the WS2811/WS2812
+     code means there aren't enough free cycles to perform this scaling on the fly
+     as data is issued. So we make a pass through the existing color data in RAM and
+     scale it (subsequent graphics commands also work at this brightness level). If
+     there's a significant step up in brightness, the limited number of steps
+     (quantization) in the old data will be quite visible in the re-scaled version.
+     For a non-destructive change, you'll need to re-render the full strip data.
+     C'est la vie.
+*/
+/************************************************************************************/
+void ESP32_WS281x::setBrightness(uint8_t brightness)
+{
+
+  uint8_t newBrightness = brightness + 1; //see NOTE
+
+  if (newBrightness != _brightness) //see NOTE
+  {
+    uint8_t* ptr          = _pixels;
+    uint8_t oldBrightness = _brightness - 1; //de-wrap old "_brightness" value
+    uint16_t scale        = 0;
+
+    if      (oldBrightness == 0) {scale = 0;}                     //avoid /0
+    else if (brightness == 255)  {scale = 65535 / oldBrightness;}
+    else                         {scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;}
+
+    if (_pixelsHi != NULL) //dithering enabled, re-scale full-precision values & derive 8-bit ones
+    {
+      uint16_t* ptrHi = _pixelsHi;
+      uint32_t  cHi   = 0;
+
+      for (uint32_t i = 0; i < _numBytes; i++)
+      {
+        cHi    = ((uint32_t)*ptrHi * scale) >> 8;
+        *ptrHi = (cHi > 0xFFFF) ? 0xFFFF : cHi;
+        *ptr++ = *ptrHi++ >> 8;
+      }
+    }
+    else
+    {
+      uint8_t  rescale[256];                       //old stored value to new one
+      uint32_t word = 0;
+      uint32_t i    = 0;
+
+      for (uint16_t value = 0; value < 256; value++)
+      {
+        uint32_t newValue = ((uint32_t)value * scale) >> 8;
+
+        rescale[value] = (newValue > 255) ? 255 : newValue;
+      }
+
+      for (; (i < _numBytes) && (((uintptr_t)&ptr[i] & 3) != 0); i++) {ptr[i] = rescale[ptr[i]];} //head up to 32-bit boundary, "_pixels" may point into "_frames"
+
+      for (; (i + 4) <= _numBytes; i += 4)           //word at a time
+      {
+        memcpy(&word, __builtin_assume_aligned(&ptr[i], 4), 4);
+
+        word = (uint32_t)rescale[word & 0xFF]                 |
+              ((uint32_t)rescale[(word >> 8)  & 0xFF] << 8)  |
+              ((uint32_t)rescale[(word >> 16) & 0xFF] << 16) |
+              ((uint32_t)rescale[word >> 24]          << 24);
+
+        memcpy(__builtin_assume_aligned(&ptr[i], 4), &word, 4);
+      }
+
+      for (; i < _numBytes; i++) {ptr[i] = rescale[ptr[i]];} //tail
+    }
+
+    _brightness = newBrightness;
+
+    updateUnscale();
+
+    if (_maxCurrent != 0) {updatePowerSum(_backFrame);} //sums of drawing frame, see "setMaxCurrent()"
+
+    setDirtyRange(0, _numLEDs - 1);
+  }
+}
+
+/************************************************************************************/
+/*
+   getBrightness()
+
+   Retrieve the last-set brightness value for the LED drivers strip
+
+   NOTE:
+   - return 0..255 (minimum/off to full brightest)
+*/
+/************************************************************************************/
+const uint8_t ESP32_WS281x::getBrightness()
+{
+  return (_brightness - 1);
+}
+
+
+/************************************************************************************/
+/*
+   updateUnscale()
+
+   Rebuild read back tables of current brightness, see "getPixelColor()"
+
+   NOTE:
+   - 8-bit values are looked up in "_unscale", 16-bit values are multiplied by
+     "_unscaleHi", so reading pixels never divides
+
+   - reciprocal is rounded up, with 24 fraction bits it gives exact quotient
+     for 16-bit values & brightness scale 1..256
+
+   - value too big for current brightness (e.g. written through "getRibbonColor()")
+     is read back as 255
+*/
+/************************************************************************************/
+void ESP32_WS281x::updateUnscale()
+{
+  uint16_t scale = _brightness ? _brightness : 256; //see note in "setBrightness()"
+
+  for (uint16_t value = 0; value < 256; value++)
+  {
+    uint16_t oldValue = (value << 8) / scale;
+
+    _unscale[value] = (oldValue > 255) ? 255 : oldValue;
+  }
+
+  _unscaleHi = ((1UL << 24) + scale - 1) / scale;
+}
+
+
+/************************************************************************************/
+/*
+   setLength()
+
+   Change the length of a previously-declared "ESP32_WS281x" strip object, pin
+   number and pixel format are unchanged
+
+   NOTE:
+   - memory is allocated only if new length is bigger than capacity, shorter
+     or same length reuses existing buffers, see "reserve()"
+
+   - ledQnt, new length of strip, in pixels
+   - preserve, if true pixels up to new length keep their colors & new pixels
+     are cleared, if false ALL PIXELS ARE CLEARED
+*/
+/************************************************************************************/
+void ESP32_WS281x::setLength(ledIndexType ledQnt, bool preserve)
+{
+  uint64_t numBytes      = (uint64_t)ledQnt * _bytesPerPixel; //recalculate size of "_pixels" buffer
+  uint32_t oldNumBytes   = _numBytes;
+  uint8_t  depth         = ((_pixelsWide != NULL) || (_modes & LED_MODE_WIDE)) ? 2 : 1; //bytes per color byte on the wire, see "setChannelDepth()"
+
+  if ((numBytes * depth > ESP_RMT_MAX_BYTES) || ((numBytes > _capacity) && (setCapacity(numBytes) != true))) //too long strip is treated as out of memory
+  {
+    ledQnt   = 0;
+    numBytes = 0;
+  }
+
+  _numLEDs  = ledQnt;
+  _numBytes = numBytes;
+
+  uint32_t first     = (preserve == true) ? ((oldNumBytes < _numBytes) ? oldNumBytes : _numBytes) : 0; //clear only new pixels or ALL PIXELS
+  uint8_t  numFrames = (_frames != NULL) ? 3 : 1;
+
+  for (uint8_t frame = 0; (frame < numFrames) && (first < _numBytes); frame++)
+  {
+    uint8_t* pixels = (_frames != NULL) ? &_frames[frame * _capacity] : _pixels;
+
+    memset(&pixels[first], 0, _numBytes - first);
+  }
+
+  if ((_pixelsHi != NULL) && (first < _numBytes))
+  {
+    for (uint32_t i = first; i < _numBytes; i++)
+    {
+      _pixelsHi[i] = 0;
+
+      if (_ditherErr != NULL) {_ditherErr[i] = i * 157;} //spread error phases, see "setDithering()"
+    }
+  }
+
+  memset(_powerSum, 0, sizeof(_powerSum));     //see "setMaxCurrent()"
+
+  if ((preserve == true) && (_maxCurrent != 0))
+  {
+    for (uint8_t frame = 0; frame < numFrames; frame++) {updatePowerSum(frame);}
+  }
+
+  _dirtyFirst = LED_INDEX_NONE;                //whole strip needs to be sent, see "getDirtyRange()"
+  _dirtyLast  = 0;
+
+  setDirtyRange(0, _numLEDs - 1);
+
+  if (_isStarted == true) {reserveOutput();}   //parts may have changed, e.g. by "setPins()" or "setPixelType()"
+}
+
+
+/************************************************************************************/
+/*
+   reserve()
+
+   Set capacity of pixel buffers, so "setLength()" up to this length doesn't
+   allocate memory
+
+   NOTE:
+   - all buffers of strip (pixels, triple buffering frames, dithering buffers)
+     & shared RMT symbol buffer follow the capacity. Buffers are resized in
+     place with "realloc()" where possible, contents are kept
+
+   - capacity never goes below current length, "setLength(0)" & "reserve(0)"
+     releases all pixel memory. Dithering, 16-bit channels & triple buffering
+     stay enabled & their buffers are allocated again by next "setLength()" or
+     "reserve()", if there is not enough memory the mode is turned off (check
+     with "getDithering()", "getChannelDepth()" & "getTripleBuffering()")
+
+   - capacity is in bytes, so it follows pixel type set by "setPixelType()"
+
+   - ledQnt, number of LEDs to reserve space for
+
+   - return true on success, false if out of memory (capacity is not changed)
+*/
+/************************************************************************************/
+bool ESP32_WS281x::reserve(ledIndexType ledQnt)
+{
+  if (ledQnt < _numLEDs) {ledQnt = _numLEDs;}
+
+  uint64_t capacity = (uint64_t)ledQnt * _bytesPerPixel;
+
+  if (capacity > ESP_RMT_MAX_BYTES) {return false;}
+
+  return setCapacity(capacity);
+}
+
+
+/************************************************************************************/
+/*
+   getCapacity()
+
+   Return number of LEDs strip can hold without allocating memory, see
+   "reserve()"
+*/
+/************************************************************************************/
+const ledIndexType ESP32_WS281x::getCapacity()
+{
+  return _capacity / _bytesPerPixel;
+}
+
+
+/************************************************************************************/
+/*
+   resizeBuffer()
+
+   Resize buffer made of several equal blocks, keeping used part of every block
+
+   NOTE:
+   - buffer is resized in place with "realloc()" where possible, blocks are
+     moved to new positions inside buffer
+
+   - buffer, existing buffer or NULL
+   - numBlocks, number of blocks in buffer
+   - oldSize, current size of one block, in bytes
+   - newSize, new size of one block, in bytes, > 0
+   - used, number of bytes to keep at the beginning of every block, <= oldSize
+     & <= newSize
+
+   - return new buffer, NULL if out of memory (old buffer is not changed)
+*/
+/************************************************************************************/
+static uint8_t* resizeBuffer(uint8_t *buffer, uint8_t numBlocks, uint32_t oldSize, uint32_t newSize, uint32_t used)
+{
+  uint8_t* ptr = NULL;
+
+  if (newSize > oldSize)
+  {
+    if ((ptr = (uint8_t *)realloc(buffer, newSize * numBlocks)) == NULL) {return NULL;}
+
+    for (uint8_t i = numBlocks - 1; i > 0; i--) {memmove(&ptr[i * newSize], &ptr[i * oldSize], used);} //last block first, blocks move up
+  }
+  else
+  {
+    for (uint8_t i = 1; i < numBlocks; i++) {memmove(&buffer[i * newSize], &buffer[i * oldSize], used);} //first block first, blocks move down
+
+    ptr = (uint8_t *)realloc(buffer, newSize * numBlocks);
+
+    if (ptr == NULL) {ptr = buffer;}             //shrinking failed, bigger buffer is still valid
+  }
+
+  return ptr;
+}
+
+
+/************************************************************************************/
+/*
+   getPartCapacity()
+
+   Get capacity of every part (pin) of strip, see "espOutput_t"
+
+   NOTE:
+   - regular strip is one part of full capacity (see "reserve()"), virtual
+     strip has one part per pin (see "setPins()")
+
+   - numBytes, list of ESP_OUTPUT_MAX_PINS entries, filled with part sizes in bytes
+
+   - return number of parts
+*/
+/************************************************************************************/
+uint8_t ESP32_WS281x::getPartCapacity(uint32_t *numBytes)
+{
+  uint8_t depth = (_pixelsWide != NULL) ? 2 : 1;   //bytes per color byte, see "setChannelDepth()"
+
+  if (_numPins == 0)
+  {
+    numBytes[0] = _capacity * depth;
+
+    return 1;
+  }
+
+  uint8_t bytesPerPixel = _bytesPerPixel * depth;
+
+  for (uint8_t i = 0; i < _numPins; i++) {numBytes[i] = (uint32_t)_pinLEDs[i] * bytesPerPixel;}
+
+  return _numPins;
+}
+
+
+/************************************************************************************/
+/*
+   reserveOutput()
+
+   Reserve buffer of output backend for capacity of strip, see "espReserve()"
+
+   NOTE:
+   - return true on success, false if out of memory
+*/
+/************************************************************************************/
+bool ESP32_WS281x::reserveOutput()
+{
+  uint32_t numBytes[ESP_OUTPUT_MAX_PINS];
+  uint8_t  numParts = getPartCapacity(numBytes);
+
+  return _output->reserve(numBytes, numParts);
+}
+
+
+/************************************************************************************/
+/*
+   setCapacity()
+
+   Resize all pixel buffers to new capacity
+
+   NOTE:
+   - capacity, size of one frame, in bytes, >= "_numBytes"
+
+   - return true on success, false if out of memory (buffers are not changed)
+*/
+/************************************************************************************/
+bool ESP32_WS281x::setCapacity(uint32_t capacity)
+{
+  if (capacity == _capacity) {return true;}
+
+  if (capacity == 0)                             //release all, length is 0
+  {
+    _modes = ((_ditherErr  != NULL) ? LED_MODE_DITHERING : 0) | //keep modes, see "reserve()"
+             ((_pixelsWide != NULL) ? LED_MODE_WIDE      : 0) |
+             ((_frames     != NULL) ? LED_MODE_TRIPLE    : 0);
+
+    if (_frames != NULL) {free(_frames);}        //"_pixels" points into "_frames"
+    else                 {free(_pixels);}
+
+    free(_pixelsHi);
+    free(_ditherErr);
+    free(_pixelsWide);
+
+    _frames     = NULL;
+    _pixels     = NULL;
+    _pixelsHi   = NULL;
+    _ditherErr  = NULL;
+    _pixelsWide = NULL;
+    _backFrame  = 0;
+    _capacity   = 0;
+
+    return true;
+  }
+
+  uint8_t*  frames     = NULL;
+  uint16_t* pixelsHi   = NULL;
+  uint8_t*  ditherErr  = NULL;
+  uint8_t*  pixelsWide = NULL;
+  bool      resized    = true;
+
+  if (_pixelsHi != NULL)                         //dithering or 16-bit channels enabled, see "setDithering()" & "setChannelDepth()"
+  {
+    if ((pixelsHi = (uint16_t *)resizeBuffer((uint8_t *)_pixelsHi, 1, _capacity * sizeof(uint16_t), capacity * sizeof(uint16_t), _numBytes * sizeof(uint16_t))) != NULL) {_pixelsHi = pixelsHi;}
+    else                                                                                                                                                                      {resized  = false;}
+  }
+
+  if ((resized == true) && (_ditherErr != NULL))
+  {
+    if ((ditherErr = resizeBuffer(_ditherErr, 1, _capacity, capacity, _numBytes)) != NULL) {_ditherErr = ditherErr;}
+    else                                                                                   {resized    = false;}
+  }
+
+  if ((resized == true) && (_pixelsWide != NULL))
+  {
+    if ((pixelsWide = resizeBuffer(_pixelsWide, 1, _capacity * 2, capacity * 2, _numBytes * 2)) != NULL) {_pixelsWide = pixelsWide;}
+    else                                                                                                 {resized     = false;}
+  }
+
+  if (resized == true)
+  {
+    resized = ((frames = resizeBuffer((_frames != NULL) ? _frames : _pixels, (_frames != NULL) ? 3 : 1, _capacity, capacity, _numBytes)) != NULL);
+  }
+
+  if (resized != true)                           //roll back resized buffers, shrinking never fails
+  {
+    if (pixelsHi   != NULL) {_pixelsHi   = (uint16_t *)resizeBuffer((uint8_t *)_pixelsHi, 1, capacity * sizeof(uint16_t), _capacity * sizeof(uint16_t), _numBytes * sizeof(uint16_t));}
+    if (ditherErr  != NULL) {_ditherErr  = resizeBuffer(_ditherErr, 1, capacity, _capacity, _numBytes);}
+    if (pixelsWide != NULL) {_pixelsWide = resizeBuffer(_pixelsWide, 1, capacity * 2, _capacity * 2, _numBytes * 2);}
+
+    return false;
+  }
+
+  if (_frames != NULL)
+  {
+    _frames = frames;
+    _pixels = &_frames[_backFrame * capacity];
+  }
+  else
+  {
+    _pixels = frames;
+  }
+
+  _capacity = capacity;
+
+  if (_modes != 0)                             //buffers of modes released by "setCapacity(0)", see "reserve()"
+  {
+    uint8_t modes = _modes;
+
+    _modes = 0;
+
+    if (modes & LED_MODE_TRIPLE)    {setTripleBuffering(true);}
+    if (modes & LED_MODE_WIDE)      {setChannelDepth(16);}
+    if (modes & LED_MODE_DITHERING) {setDithering(true);}
+  }
+
+  if (_isStarted == true) {reserveOutput();}   //buffer of output backend, see "espShow()"
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   getLength()
+
+   Return the number of pixels/LEDs in an "ESP32_WS281x" strip object
+
+   NOTE:
+   - return pixel count (quantity), 0 if not set
+*/
+/************************************************************************************/
+const ledIndexType ESP32_WS281x::getLength()
+{
+  return _numLEDs;
+}
+
+
+/************************************************************************************/
+/*
+   setPixelType()
+
+   Change pixel format of a previously-declared "ESP32_WS281x" strip object.
+
+   NOTE:
+   - if format changes from one of the RGB variants to an RGBW variant
+     (or RGBW to RGB), the old data will be deallocated and new data is cleared.
+     Otherwise, the old data will remain in RAM and is not reordered to the new
+     format, so it's advisable to follow up with clear()
+
+   - his function is deprecated, here only for old projects that may still be
+     calling it. New projects should instead use the constructor
+     "ESP32_WS281x(length, pin, type)"
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPixelType(ledPixelType ledType)
+{
+  uint8_t oldBytesPerPixel = _bytesPerPixel;
+
+  _wOffset = (ledType >> 6) & 0b11; //see notes in header file
+  _rOffset = (ledType >> 4) & 0b11; //regarding R/G/B/W offsets
+  _gOffset = (ledType >> 2) & 0b11;
+  _bOffset = (ledType & 0b11);
+  _cOffset = _rOffset;              //no cold white, see "setPixelFormat()"
+
+  _bytesPerPixel = (_wOffset == _rOffset) ? 3 : 4;
+
+  updatePixelFormat(oldBytesPerPixel);
+}
+
+
+/************************************************************************************/
+/*
+   setPixelFormat()
+
+   Change pixel format to any number of channels up to LED_MAX_CHANNELS, e.g.
+   RGB + warm white + cold white (RGBWW) pixels "ledPixelType" can't describe
+
+   NOTE:
+   - same as "setPixelType()", if number of bytes per pixel changes old data is
+     deallocated and new data is cleared
+
+   - setters & getters with white (e.g. "setPixelColor(r, g, b, w)") drive W,
+     cold white is set by "setPixelColor(r, g, b, w, c)" & "fillChannels()" only
+     & is 0(off) otherwise
+
+   - cold white shares gamma, curve, white-point & current of W channel, see
+     "setGamma()" & "setPowerModel()". Use "setChannelCurve(LED_CHANNEL_C, ...)"
+     to set a different curve
+
+   - format, number of channels & channel transmitted as 1-st, 2-nd.. byte.
+     R, G & B are required, W & C are optional
+
+   - return true on success, false if format is invalid (pixel format is not
+     changed)
+*/
+/************************************************************************************/
+bool ESP32_WS281x::setPixelFormat(const ledPixelFormat_t &format)
+{
+  if ((format.numChannels < 3) || (format.numChannels > LED_MAX_CHANNELS)) {return false;}
+
+  int8_t offset[LED_MAX_CHANNELS] = {-1, -1, -1, -1, -1};
+
+  for (uint8_t i = 0; i < format.numChannels; i++)
+  {
+    uint8_t channel = format.order[i];
+
+    if ((channel >= LED_MAX_CHANNELS) || (offset[channel] >= 0)) {return false;} //invalid or duplicate channel
+
+    offset[channel] = i;
+  }
+
+  if ((offset[LED_CHANNEL_R] < 0) || (offset[LED_CHANNEL_G] < 0) || (offset[LED_CHANNEL_B] < 0)) {return false;}
+
+  uint8_t oldBytesPerPixel = _bytesPerPixel;
+
+  _rOffset = offset[LED_CHANNEL_R];
+  _gOffset = offset[LED_CHANNEL_G];
+  _bOffset = offset[LED_CHANNEL_B];
+  _wOffset = (offset[LED_CHANNEL_W] >= 0) ? offset[LED_CHANNEL_W] : _rOffset; //absent channel is mapped to R, see "setPixelColor()"
+  _cOffset = (offset[LED_CHANNEL_C] >= 0) ? offset[LED_CHANNEL_C] : _rOffset;
+
+  _bytesPerPixel = format.numChannels;
+
+  updatePixelFormat(oldBytesPerPixel);
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   updatePixelFormat()
+
+   Follow up change of pixel format
+
+   NOTE:
+   - if bytes-per-pixel has changed (and pixel data was previously allocated),
+     re-allocate to new size will clear any data
+
+   - oldBytesPerPixel, bytes per pixel before the change
+*/
+/************************************************************************************/
+void ESP32_WS281x::updatePixelFormat(uint8_t oldBytesPerPixel)
+{
+  if ((_pixels != NULL) && (_bytesPerPixel != oldBytesPerPixel)) {setLength(_numLEDs);}
+
+  if (_lut != NULL) {updateLUT();} //byte positions of channels have changed
+}
+
+
+/************************************************************************************/
+/*
+   strToPixelType()
+
+   Convert pixel color order from string (e.g. "BGR") to "ESP32_WS281x"
+   color order constant (e.g. LED_BGR). This may be helpful for code
+   that initializes from text configuration rather than compile-time
+   constants
+
+   NOTE:
+   - strValue, input string. Should be reasonably sanitized (a 3..4 character
+     NUL-terminated string) or undefined behavior may result (output is still a
+     valid "ESP32_WS281x" order constant, but might not present as expected).
+     Garbage in, garbage out
+
+   - return "ESP32_WS281x" color order constants (e.g. LED_BGR)
+
+   - this function is declared static in the class so it can be called without a
+     "ESP32_WS281x" object (since it's not likely been declared in the code yet).
+     Use "ESP32_WS281x::str2order()"
+*/
+/************************************************************************************/
+ledPixelType ESP32_WS281x::strToPixelType(const char *strValue)
+{
+  int8_t r = 0, g = 0, b = 0, w = -1;
+
+  if (strValue)
+  {
+    char c;
+
+    for (uint8_t i=0; ((c = tolower(strValue[i]))); i++)
+    {
+      if      (c == 'r') {r = i;}
+      else if (c == 'g') {g = i;}
+      else if (c == 'b') {b = i;}
+      else if (c == 'w') {w = i;}
+    }
+
+    r &= 3;
+  }
+
+  if (w < 0) w = r; //if 'w' not specified, duplicate r bits
+
+  return (w << 6) | (r << 4) | ((g & 3) << 2) | (b & 3);
+}
+
+
+/************************************************************************************/
+/*
+   strToPixelFormat()
+
+   Convert pixel color order from string (e.g. "GRBWC") to pixel format for
+   "setPixelFormat()"
+
+   NOTE:
+   - strValue, input string of 'r', 'g', 'b', 'w' (warm white) & 'c' (cold
+     white) letters, e.g. "RGBWC". Unknown letters and letters past
+     LED_MAX_CHANNELS are skipped
+
+   - return pixel format, number of channels is 0 if string is NULL or empty
+
+   - this function is declared static in the class so it can be called without a
+     "ESP32_WS281x" object, see "strToPixelType()"
+*/
+/************************************************************************************/
+ledPixelFormat_t ESP32_WS281x::strToPixelFormat(const char *strValue)
+{
+  const char       letters[LED_MAX_CHANNELS + 1] = "rgbwc"; //in LED_CHANNEL_R..LED_CHANNEL_C order
+  ledPixelFormat_t format                        = {0, {0}};
+
+  if (strValue == NULL) {return format;}
+
+  for (uint8_t i = 0; (strValue[i] != 0) && (format.numChannels < LED_MAX_CHANNELS); i++)
+  {
+    const char *letter = strchr(letters, tolower(strValue[i]));
+
+    if ((letter != NULL) && (*letter != 0)) {format.order[format.numChannels++] = letter - letters;}
+  }
+
+  return format;
+}
+
+
+/************************************************************************************/
+/*
+   setDithering()
+
+   Enable/disable temporal dithering for smooth low-brightness fades
+
+   NOTE:
+   - brightness premultiply in "setPixelColor()" truncates the 8x8-bit product
+     to 8-bits, so slow fades at low "setBrightness()" levels collapse into a few
+     visible steps. With dithering enabled each byte is also kept in a 16-bit
+     working buffer (see "widenHi()") and "show()" reduces it to 8-bits with
+     first-order temporal error diffusion: the lost fraction is carried over to
+     the next frame, so the time-average of the transmitted values matches the
+     16-bit value. Works best at high refresh rates (call "show()" at 100+ fps)
+
+   - costs 3 extra bytes of RAM per color byte (16-bit value + 8-bit error) and
+     one add/shift pass over "_numBytes" per "show()"
+
+   - existing pixel colors are preserved, the error accumulators are seeded with
+     a spatial pattern so pixels with equal fractions don't toggle in lockstep
+
+   - with dithering enabled "show()" overwrites "_pixels", writes made directly
+     via "getRibbonColor()" pointer are lost
+
+   - call after "setLength()", dithering is not enabled on an empty strip
+
+   - dithering is not available with triple buffering, dithered frame is
+     produced by "show()" on the transmit side
+
+   - dithering is not available with 16-bit channels, see "setChannelDepth()"
+
+   - enable, true to allocate the working buffer, false to release it
+
+   - return true on success, false if there is not enough memory
+*/
+/************************************************************************************/
+bool ESP32_WS281x::setDithering(bool enable)
+{
+  if (enable != true) {_modes &= ~LED_MODE_DITHERING;} //mode kept by empty strip, see "reserve()"
+
+  if (_pixelsWide != NULL) {return !enable;} //not supported with 16-bit channels, working buffer is in use
+
+  free(_pixelsHi); //free existing data, if any
+  free(_ditherErr);
+
+  _pixelsHi  = NULL;
+  _ditherErr = NULL;
+
+  if ((enable != true) || (_pixels == NULL)) {return !enable;}
+
+  if (_frames != NULL) {return false;} //not supported with triple buffering
+
+  _pixelsHi  = (uint16_t *)malloc(_capacity * sizeof(uint16_t)); //same capacity as "_pixels", see "reserve()"
+  _ditherErr = (uint8_t *)malloc(_capacity);
+
+  if ((_pixelsHi == NULL) || (_ditherErr == NULL))
+  {
+    free(_pixelsHi);
+    free(_ditherErr);
+
+    _pixelsHi  = NULL;
+    _ditherErr = NULL;
+
+    return false;
+  }
+
+  for (uint32_t i = 0; i < _numBytes; i++)
+  {
+    _pixelsHi[i]  = _pixels[i] * 257;          //keep current colors, 255 -> 0xFFFF
+    _ditherErr[i] = i * 157;                   //spread error phases, see NOTE
+  }
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   getDithering()
+
+   Retrieve temporal dithering state
+
+   NOTE:
+   - return true if dithering is enabled
+*/
+/************************************************************************************/
+const bool ESP32_WS281x::getDithering()
+{
+  return (_ditherErr != NULL) || (_modes & LED_MODE_DITHERING);
+}
+
+
+/************************************************************************************/
+/*
+   setChannelDepth()
+
+   Set bit depth of color channels on the wire, 8-bit (WS2812, SK6812, etc.)
+   or 16-bit (WS2816, UCS8904, etc.)
+
+   NOTE:
+   - 16-bit LED drivers take 2 bytes per color channel, most significant byte
+     first. Colors are kept in the same 16-bit working buffer as dithering uses,
+     so full range is set by "setPixelColor16()" & "setPixelColors16()".
+     8-bit colors (e.g. "setPixelColor()", "fill()") are stored as value * 257,
+     so 255 is 0xFFFF with & without correction tables
+
+   - brightness, color correction tables (see "setGamma()") & power limiter
+     (see "setMaxCurrent()") are applied to 16-bit values by "show()", table
+     input is interpolated like in "ditherFrame()"
+
+   - costs 4 extra bytes of RAM per color byte (16-bit value + 2 bytes sent)
+     and frame on the wire is 2 times longer, also in buffer of output backend
+
+   - "getRibbonColor()" & "getPixelColor()" give 8-bit values, writes made
+     directly via "getRibbonColor()" pointer are lost
+
+   - existing pixel colors are preserved. Dithering is turned off, it isn't
+     available with 16-bit channels
+
+   - call after "setLength()", 16-bit channels are not enabled on an empty
+     strip. Not available with triple buffering
+
+   - bits, 8 or 16
+
+   - return true on success, false if bits is not supported or there is not
+     enough memory
+*/
+/************************************************************************************/
+bool ESP32_WS281x::setChannelDepth(uint8_t bits)
+{
+  if (bits != 16)                                          //back to 8-bit channels
+  {
+    _modes &= ~LED_MODE_WIDE;                              //mode kept by empty strip, see "reserve()"
+
+    if (_pixelsWide != NULL)
+    {
+      free(_pixelsWide);
+      free(_pixelsHi);
+
+      _pixelsWide = NULL;
+      _pixelsHi   = NULL;
+
+      setDirtyRange(0, _numLEDs - 1);
+    }
+
+    return (bits == 8);
+  }
+
+  if (_pixelsWide != NULL) {return true;}                  //nothing to do
+
+  if ((_pixels == NULL) || (_frames != NULL) || (((uint64_t)_numBytes * 2) > ESP_RMT_MAX_BYTES)) {return false;} //empty strip, triple buffering enabled or too long strip
+
+  uint8_t*  pixelsWide = (uint8_t *)malloc(_capacity * 2); //same capacity as "_pixels", see "reserve()"
+  uint16_t* pixelsHi   = (_pixelsHi != NULL) ? _pixelsHi : (uint16_t *)malloc(_capacity * sizeof(uint16_t)); //dithering buffer is kept
+
+  if ((pixelsWide == NULL) || (pixelsHi == NULL))
+  {
+    free(pixelsWide);
+
+    if (pixelsHi != _pixelsHi) {free(pixelsHi);}
+
+    return false;
+  }
+
+  if (_pixelsHi == NULL)
+  {
+    for (uint32_t i = 0; i < _numBytes; i++) {pixelsHi[i] = _pixels[i] * 257;} //keep current colors, 255 -> 0xFFFF
+  }
+
+  free(_ditherErr);                                        //dithering is turned off
+
+  _ditherErr  = NULL;
+  _pixelsHi   = pixelsHi;
+  _pixelsWide = pixelsWide;
+
+  setDirtyRange(0, _numLEDs - 1);
+
+  if (_isStarted == true) {reserveOutput();}               //frame on the wire is 2 times longer
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   getChannelDepth()
+
+   Retrieve bit depth of color channels
+
+   NOTE:
+   - return 8 or 16, see "setChannelDepth()"
+*/
+/************************************************************************************/
+const uint8_t ESP32_WS281x::getChannelDepth()
+{
+  return ((_pixelsWide != NULL) || (_modes & LED_MODE_WIDE)) ? 16 : 8;
+}
+
+
+/************************************************************************************/
+/*
+   setTripleBuffering()
+
+   Enable/disable lock-free triple buffering for render task & transmit task on
+   different cores
+
+   NOTE:
+   - producer (render task) draws into "_pixels" and publishes complete frame
+     with "commit()", consumer (transmit task or "ESP32_Governor") calls "show()"
+     which always sends the newest complete frame. Handoff is one atomic index
+     exchange on each side, no mutex, so producer never tears or blocks the
+     frame being sent & consumer never waits for producer
+
+   - only one producer task & one consumer task per strip
+
+   - costs 2 extra frames of RAM. Current pixel colors are kept in the drawing
+     frame, other 2 frames are cleared
+
+   - "_pixels" & "getRibbonColor()" point to the drawing frame, which changes
+     on every "commit()". "setBrightness()" re-scales the drawing frame only
+
+   - not available with dithering, see "setDithering()"
+
+   - call after "setLength()", triple buffering is not enabled on an empty strip
+
+   - enable, true to allocate 3 frames, false to go back to a single buffer
+
+   - return true on success, false if there is not enough memory
+*/
+/************************************************************************************/
+bool ESP32_WS281x::setTripleBuffering(bool enable)
+{
+  if (enable != true) {_modes &= ~LED_MODE_TRIPLE;} //mode kept by empty strip, see "reserve()"
+
+  if (enable == (_frames != NULL)) {return true;} //nothing to do
+
+  if (enable == true)
+  {
+    if ((_pixels == NULL) || (_pixelsHi != NULL)) {return false;} //empty strip, dithering or 16-bit channels enabled
+
+    uint8_t *frames = (uint8_t *)malloc(_capacity * 3); //same capacity as "_pixels", see "reserve()"
+
+    if (frames == NULL) {return false;}
+
+    memcpy(frames, _pixels, _numBytes);               //frame 0 is drawing frame
+    memset(&frames[_capacity], 0, _capacity * 2);
+
+    free(_pixels);
+
+    _frames     = frames;
+    _pixels     = frames;
+    _backFrame  = 0;
+    _frontFrame = 1;
+    _readyFrame = 2;                                  //no LED_FRAME_FRESH, nothing committed yet
+
+    memset(_powerSum[1], 0, sizeof(_powerSum[0]) * 2);
+  }
+  else
+  {
+    uint8_t *pixels = (uint8_t *)malloc(_capacity);
+
+    if (pixels == NULL) {return false;}
+
+    memcpy(pixels, _pixels, _numBytes);               //keep drawing frame
+
+    free(_frames);
+
+    memmove(_powerSum[0], _powerSum[_backFrame], sizeof(_powerSum[0]));
+
+    _frames    = NULL;
+    _pixels    = pixels;
+    _backFrame = 0;
+  }
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   getTripleBuffering()
+
+   Retrieve triple buffering state
+
+   NOTE:
+   - return true if triple buffering is enabled
+*/
+/************************************************************************************/
+const bool ESP32_WS281x::getTripleBuffering()
+{
+  return (_frames != NULL) || (_modes & LED_MODE_TRIPLE);
+}
+
+
+/************************************************************************************/
+/*
+   setGamma()
+
+   Set the same gamma-correction exponent for all color channels
+
+   NOTE:
+   - see "setGamma(gammaR, gammaG, gammaB, gammaW)"
+*/
+/************************************************************************************/
+void ESP32_WS281x::setGamma(float gamma)
+{
+  setGamma(gamma, gamma, gamma, gamma);
+}
+
+
+/************************************************************************************/
+/*
+   setGamma()
+
+   Set gamma-correction exponent per color channel, applied when pixel data is
+   sent to LED drivers
+
+   NOTE:
+   - unlike "gamma8()" & "gamma32()" which change color values before they are
+     stored in RAM, correction set here is fused into the encoder pass of "show()".
+     Pixel buffer stays linear (so "getPixelColor()", "setBrightness()" and
+     blending work on linear values) and render loop doesn't pay for correction
+
+   - gamma, curve, white-point ("setColorCorrection()") and color temperature
+     ("setColorTemperature()") are combined into one 256-entry table per channel,
+     tables are rebuilt only when one of the settings changes. Tables are freed
+     when all settings are neutral
+
+   - gammaR, gammaG, gammaB, gammaW, exponent per channel, e.g. 2.6 is close
+     to "gamma8()". 1.0 is linear (no correction). Cold white (if any) follows
+     gammaW
+*/
+/************************************************************************************/
+void ESP32_WS281x::setGamma(float gammaR, float gammaG, float gammaB, float gammaW)
+{
+  _gamma[LED_CHANNEL_R] = (gammaR > 0) ? gammaR : 1.0;
+  _gamma[LED_CHANNEL_G] = (gammaG > 0) ? gammaG : 1.0;
+  _gamma[LED_CHANNEL_B] = (gammaB > 0) ? gammaB : 1.0;
+  _gamma[LED_CHANNEL_W] = (gammaW > 0) ? gammaW : 1.0;
+  _gamma[LED_CHANNEL_C] = _gamma[LED_CHANNEL_W]; //cold white, see "setPixelFormat()"
+
+  updateLUT();
+}
+
+
+/************************************************************************************/
+/*
+   setChannelCurve()
+
+   Set user correction curve for one color channel, overrides gamma exponent of
+   this channel
+
+   NOTE:
+   - table is not copied, it must stay valid while in use (e.g. const table in
+     flash)
+
+   - channel, LED_CHANNEL_R, LED_CHANNEL_G, LED_CHANNEL_B, LED_CHANNEL_W or
+     LED_CHANNEL_C
+   - curve, 256-entry table 0..255 in, 0..255 out. NULL to go back to gamma
+     exponent
+*/
+/************************************************************************************/
+void ESP32_WS281x::setChannelCurve(uint8_t channel, const uint8_t *curve)
+{
+  if (channel > LED_CHANNEL_C) {return;}
+
+  _curve[channel]   = curve;
+  _curve16[channel] = NULL;
+
+  updateLUT();
+}
+
+
+/************************************************************************************/
+/*
+   setChannelCurve()
+
+   Set user 16-bit correction curve for one color channel, overrides gamma
+   exponent of this channel
+
+   NOTE:
+   - same as 8-bit "setChannelCurve()", but fraction of each entry is kept in
+     8.8 fixed-point table, which matters for dithered strips (see "setDithering()").
+     Generate table with e.g. "static constexpr auto curve = ledGammaTable<uint16_t>(2.2)"
+
+   - channel, LED_CHANNEL_R, LED_CHANNEL_G, LED_CHANNEL_B, LED_CHANNEL_W or
+     LED_CHANNEL_C
+   - curve, 256-entry table 0..255 in, 0..65535 out. NULL to go back to gamma
+     exponent
+*/
+/************************************************************************************/
+void ESP32_WS281x::setChannelCurve(uint8_t channel, const uint16_t *curve)
+{
+  if (channel > LED_CHANNEL_C) {return;}
+
+  _curve[channel]   = NULL;
+  _curve16[channel] = curve;
+
+  updateLUT();
+}
+
+
+/************************************************************************************/
+/*
+   setColorCorrection()
+
+   Set white-point correction, e.g. to compensate for unequal brightness of
+   R,G,B dies or diffuser tint
+
+   NOTE:
+   - correction, packed WRGB scale per channel, 0xFF = full. 0xFFFFFFFF is no
+     correction, e.g. 0xFFFFB0F0 for typical 5050 LED strip. Cold white (if
+     any) follows W
+*/
+/************************************************************************************/
+void ESP32_WS281x::setColorCorrection(uint32_t correction)
+{
+  _correction = correction;
+
+  updateLUT();
+}
+
+
+/************************************************************************************/
+/*
+   setColorTemperature()
+
+   Set color temperature of white, e.g. to make white warmer at night
+
+   NOTE:
+   - kelvin, 1000..40000 Kelvin, 6600K is neutral. 0 disables color temperature
+     correction. White channel (if any) is not changed, see "colorKelvin()"
+*/
+/************************************************************************************/
+void ESP32_WS281x::setColorTemperature(uint16_t kelvin)
+{
+  _temperature = (kelvin != 0) ? (colorKelvin(kelvin) | 0xFF000000) : 0xFFFFFFFF;
+
+  updateLUT();
+}
+
+
+/************************************************************************************/
+/*
+   setWhiteExtraction()
+
+   Enable/disable automatic RGB to RGBW conversion, so RGB content drives white
+   die of RGBW strip
+
+   NOTE:
+   - white made of R,G,B dies is dimmer & draws more current than the same
+     white from W die. With extraction enabled every write moves the part of
+     R,G,B the white die can reproduce to W: w = min(r / whiteR, g / whiteG,
+     b / whiteB) and whiteR * w, whiteG * w, whiteB * w is subtracted from R,G,B
+
+   - conversion is done as colors are written (same as brightness premultiply,
+     see "setBrightness()") by "setPixelColor()", "setPixelColors()", "fill()"
+     & their 16-bit versions, so "show()" and encoders don't pay for it. Pixels
+     already in RAM are not converted & "getPixelColor()" returns converted
+     color. Power sums (see "setMaxCurrent()") see the converted color
+
+   - white passed to "setPixelColor(r, g, b, w)" is added to extracted white,
+     result is clipped to full scale
+
+   - ignored on strip without white
+
+   - whiteColor, packed RGB color of white die as made by R,G,B dies.
+     LED_WHITE_MIN (default) for neutral white die, common part of R,G,B
+     (minimum channel) is moved to W. Calibrated color of warm/cold white die,
+     e.g. "colorKelvin(3000)" for 3000K white die. LED_WHITE_NONE disables
+     extraction
+*/
+/************************************************************************************/
+void ESP32_WS281x::setWhiteExtraction(uint32_t whiteColor)
+{
+  const uint8_t shift[3] = {16, 8, 0}; //position of R,G,B in packed RGB
+
+  _whiteColor = whiteColor & 0xFFFFFF;
+
+  for (uint8_t channel = 0; channel < 3; channel++)
+  {
+    uint8_t die = (_whiteColor >> shift[channel]) & 0xFF;
+
+    _whiteRatio[channel] = (die != 0) ? ((255 * 256) / die) : 0;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   getWhiteExtraction()
+
+   Retrieve white extraction setting
+
+   NOTE:
+   - return packed RGB color of white die, LED_WHITE_NONE if extraction is
+     disabled
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x::getWhiteExtraction()
+{
+  return _whiteColor;
+}
+
+
+/************************************************************************************/
+/*
+   extractWhite()
+
+   Move the part of R,G,B the white die can reproduce to W, see
+   "setWhiteExtraction()"
+
+   NOTE:
+   - subtracted part never exceeds channel value, "_whiteRatio" is rounded
+     down
+
+   - rgbw, R,G,B,W values, converted in place
+   - maxValue, full scale, 255 for 8-bit or 65535 for 16-bit values
+*/
+/************************************************************************************/
+void ESP32_WS281x::extractWhite(uint16_t *rgbw, uint16_t maxValue)
+{
+  const uint8_t shift[3] = {16, 8, 0}; //position of R,G,B in packed RGB
+  uint32_t      white    = maxValue;   //W die can't go above full scale
+
+  for (uint8_t channel = 0; channel < 3; channel++)
+  {
+    if (_whiteRatio[channel] == 0) {continue;} //die has none of this channel
+
+    uint32_t w = ((uint32_t)rgbw[channel] * _whiteRatio[channel]) >> 8;
+
+    if (w < white) {white = w;}
+  }
+
+  for (uint8_t channel = 0; channel < 3; channel++)
+  {
+    rgbw[channel] -= (white * ((_whiteColor >> shift[channel]) & 0xFF)) / 255;
+  }
+
+  white += rgbw[LED_CHANNEL_W];
+
+  rgbw[LED_CHANNEL_W] = (white > maxValue) ? maxValue : white;
+}
+
+
+/************************************************************************************/
+/*
+   updateLUT()
+
+   Rebuild color correction tables from gamma, curve, white-point and color
+   temperature settings
+
+   NOTE:
+   - tables are stored in device byte order ("ledPixelType"), so encoder just
+     steps to the next table with each byte of pixel
+
+   - table entries are 8.8 fixed-point, so fraction of gamma curve survives for
+     "ditherFrame()". Encoder sends rounded integer part
+
+   - if table can't be allocated correction is silently disabled
+*/
+/************************************************************************************/
+void ESP32_WS281x::updateLUT()
+{
+  setDirtyRange(0, _numLEDs - 1);                //every sent byte may change, see "getDirtyRange()"
+
+  bool neutral = (_correction == 0xFFFFFFFF) && (_temperature == 0xFFFFFFFF);
+
+  for (uint8_t channel = 0; channel < LED_MAX_CHANNELS; channel++)
+  {
+    neutral &= (_gamma[channel] == 1.0) && (_curve[channel] == NULL) && (_curve16[channel] == NULL);
+  }
+
+  if (neutral == true)
+  {
+    free(_lut);
+
+    _lut = NULL;
+
+    return;
+  }
+
+  if ((_lut == NULL) && ((_lut = (uint16_t *)malloc(LED_MAX_CHANNELS * 256 * sizeof(uint16_t))) == NULL)) {return;}
+
+  const uint8_t offset[LED_MAX_CHANNELS] = {_rOffset, _gOffset, _bOffset, _wOffset, _cOffset};
+  const uint8_t shift[LED_MAX_CHANNELS]  = {16, 8, 0, 24, 24};                     //position of R,G,B,W,C in packed WRGB, C shares W
+
+  for (uint8_t channel = 0; channel < LED_MAX_CHANNELS; channel++)
+  {
+    if ((channel > LED_CHANNEL_B) && (offset[channel] == _rOffset)) {continue;} //no such channel, see "setPixelFormat()"
+
+    uint16_t* table = &_lut[offset[channel] * 256];
+    float     scale = ((_correction >> shift[channel]) & 0xFF) * ((_temperature >> shift[channel]) & 0xFF) / 65025.0; //0..1
+    float     c     = 0;
+
+    for (uint16_t i = 0; i < 256; i++)
+    {
+      if      (_curve[channel]   != NULL) {c = pgm_read_byte(&_curve[channel][i]);}
+      else if (_curve16[channel] != NULL) {c = pgm_read_word(&_curve16[channel][i]) / 257.0;}
+      else if (_gamma[channel] == 1.0)    {c = i;}
+      else                                {c = powf(i / 255.0, _gamma[channel]) * 255.0;}
+
+      table[i] = c * scale * 256 + 0.5; //0..255 in, 8.8 fixed-point 0..0xFF00 out
+    }
+  }
+}
+
+
+/************************************************************************************/
+/*
+   setPowerModel()
+
+   Set current model of LED drivers for power limiter
+
+   NOTE:
+   - mAred, mAgreen, mAblue, mAwhite, current of one channel at full output
+     (255), in mA. Default 20mA (typical WS2812B & SK6812), white is ignored
+     on RGB-type strip. Cold white (if any) follows mAwhite
+   - idleMA, current of one LED with all channels off, in mA. Default 1mA
+
+   - see "setMaxCurrent()"
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPowerModel(uint8_t mAred, uint8_t mAgreen, uint8_t mAblue, uint8_t mAwhite, uint8_t idleMA)
+{
+  _channelCurrent[LED_CHANNEL_R] = mAred;
+  _channelCurrent[LED_CHANNEL_G] = mAgreen;
+  _channelCurrent[LED_CHANNEL_B] = mAblue;
+  _channelCurrent[LED_CHANNEL_W] = mAwhite;
+  _channelCurrent[LED_CHANNEL_C] = mAwhite;
+  _idleCurrent                   = idleMA;
+}
+
+
+/************************************************************************************/
+/*
+   setMaxCurrent()
+
+   Set current budget of the strip, e.g. to protect power supply from full
+   white frame
+
+   NOTE:
+   - "show()" estimates current of the frame with "setPowerModel()" and if it
+     exceeds the budget, encoder scales the whole frame by the same factor.
+     Unlike "setBrightness()" this is lossless, pixel buffer in RAM isn't changed
+     and frames within the budget are sent as is
+
+   - estimate doesn't need a pass over "_pixels", sum of color values per byte
+     position in pixel is updated by "setPixelColor()", "fill()", "clear()" &
+     "setBrightness()" as colors are written. Enabling the limiter does one pass
+     to initialize the sums. Writes made directly via "getRibbonColor()" pointer
+     are not seen, call "setMaxCurrent()" again after them to re-sync
+
+   - estimate is based on linear color values in RAM, so with gamma correction
+     (see "setGamma()") real current is lower & limiter is on the safe side
+
+   - maxMA, budget in mA, 0 to disable power limiter
+*/
+/************************************************************************************/
+void ESP32_WS281x::setMaxCurrent(uint32_t maxMA)
+{
+  _maxCurrent = maxMA;
+
+  if (_maxCurrent == 0) {return;}
+
+  for (uint8_t frame = 0; frame < ((_frames != NULL) ? 3 : 1); frame++)
+  {
+    updatePowerSum(frame);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   getCurrent()
+
+   Retrieve estimated current of the frame being drawn
+
+   NOTE:
+   - return estimated current in mA before power limiting, 0 if power limiter is
+     disabled
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x::getCurrent()
+{
+  if (_maxCurrent == 0) {return 0;}
+
+  return estimateCurrent(_backFrame);
+}
+
+
+/************************************************************************************/
+/*
+   updatePowerSum()
+
+   Recalculate sum of color values per byte position in pixel with a full
+   pass over frame
+
+   NOTE:
+   - frame, frame index 0..2, always 0 without triple buffering
+*/
+/************************************************************************************/
+void ESP32_WS281x::updatePowerSum(uint8_t frame)
+{
+  const uint8_t* ptr           = (_frames != NULL) ? &_frames[frame * _capacity] : _pixels;
+  uint32_t*      sum           = _powerSum[frame];
+  uint8_t        bytesPerPixel = _bytesPerPixel;
+
+  memset(sum, 0, sizeof(_powerSum[0]));
+
+  for (ledIndexType i = 0; i < _numLEDs; i++)
+  {
+    for (uint8_t j = 0; j < bytesPerPixel; j++)
+    {
+      sum[j] += (_pixelsHi != NULL) ? (_pixelsHi[i * bytesPerPixel + j] >> 8) : ptr[j]; //"_pixels" is dithered
+    }
+
+    ptr += bytesPerPixel;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   updatePowerSum()
+
+   Remove/add colors of a run of pixels of the drawing frame from/to power sums
+
+   NOTE:
+   - used by bulk writes with dithering disabled, see "setMaxCurrent()"
+
+   - ledIndex, index of first pixel in run
+   - numOfLEDs, number of pixels in run
+   - add, true to add colors to sums, false to remove them
+*/
+/************************************************************************************/
+void ESP32_WS281x::updatePowerSum(ledIndexType ledIndex, ledIndexType numOfLEDs, bool add)
+{
+  uint8_t        bytesPerPixel = _bytesPerPixel;
+  const uint8_t* p             = &_pixels[ledIndex * bytesPerPixel];
+  uint32_t       sum[LED_MAX_CHANNELS] = {0, 0, 0, 0, 0};
+
+  for (ledIndexType i = 0; i < numOfLEDs; i++)
+  {
+    for (uint8_t j = 0; j < bytesPerPixel; j++) {sum[j] += p[j];}
+
+    p += bytesPerPixel;
+  }
+
+  for (uint8_t j = 0; j < bytesPerPixel; j++)
+  {
+    if (add == true) {_powerSum[_backFrame][j] += sum[j];}
+    else             {_powerSum[_backFrame][j] -= sum[j];}
+  }
+}
+
+
+/************************************************************************************/
+/*
+   estimateCurrent()
+
+   Estimate current of the frame from sums of color values & power model
+
+   NOTE:
+   - frame, frame index 0..2, always 0 without triple buffering
+
+   - return current in mA
+*/
+/************************************************************************************/
+uint32_t ESP32_WS281x::estimateCurrent(uint8_t frame)
+{
+  const uint8_t offset[LED_MAX_CHANNELS] = {_rOffset, _gOffset, _bOffset, _wOffset, _cOffset};
+  uint64_t      current                  = 0;
+
+  for (uint8_t channel = 0; channel < LED_MAX_CHANNELS; channel++)
+  {
+    if ((channel > LED_CHANNEL_B) && (offset[channel] == _rOffset)) {continue;} //no such channel, see "setPixelFormat()"
+
+    current += (uint64_t)_powerSum[frame][offset[channel]] * _channelCurrent[channel];
+  }
+
+  return (current / 255) + ((uint32_t)_idleCurrent * _numLEDs);
+}
+
+
+/************************************************************************************/
+/*
+   powerScale()
+
+   Calculate encoder scale that brings the frame within the current budget
+
+   NOTE:
+   - idle current can't be scaled, so if idle current alone exceeds the budget
+     frame is sent black
+
+   - frame, frame index 0..2, always 0 without triple buffering
+
+   - return scale 0..256, 256 = frame is within budget
+*/
+/************************************************************************************/
+uint16_t ESP32_WS281x::powerScale(uint8_t frame)
+{
+  uint32_t current     = estimateCurrent(frame);
+  uint32_t idleCurrent = (uint32_t)_idleCurrent * _numLEDs;
+
+  if (current <= _maxCurrent)     {return 256;}
+  if (_maxCurrent <= idleCurrent) {return 0;}
+
+  return ((uint64_t)(_maxCurrent - idleCurrent) << 8) / (current - idleCurrent);
+}
+
+
+/************************************************************************************/
+/*
+   widenHi()
+
+   Stretch 8.8 fixed-point value to full 16-bit range, 0..0xFF00 -> 0..0xFFFF
+
+   NOTE:
+   - 8-bit value is stored as value * 257 (see "setPixelColor()"), so 255 is
+     0xFFFF same as written by "setPixelColor16()" & sent by 16-bit channels
+     with or without correction tables (see "encodeFrame16()")
+*/
+/************************************************************************************/
+static inline uint16_t widenHi(uint32_t value)
+{
+  return value + (value >> 8);
+}
+
+
+/************************************************************************************/
+/*
+   narrowHi()
+
+   Convert 16-bit value back to 8.8 fixed-point, 0..0xFFFF -> 0..0xFF00
+
+   NOTE:
+   - exact inverse of "widenHi()", so 8-bit colors are dithered without
+     flicker & correction tables are looked up without interpolation
+*/
+/************************************************************************************/
+static inline uint16_t narrowHi(uint16_t value)
+{
+  return value - ((value - (value >> 8)) >> 8); //value / 257 without divide, exact for 16-bit values
+}
+
+
+/************************************************************************************/
+/*
+   ditherFrame()
+
+   Reduce 16-bit working buffer to 8-bit "_pixels" with temporal error diffusion
+
+   NOTE:
+   - integer part of each value plus the carry of the accumulated fraction is
+     sent, remaining fraction is kept for the next frame (see "setDithering()")
+
+   - 16-bit value is converted to 8.8 fixed-point first, see "narrowHi()"
+
+   - color correction tables (see "setGamma()") are applied here instead of in
+     the encoder, so gamma curve doesn't flatten the 16-bit value back to a few
+     steps. Input is interpolated between 2 table entries to keep 8.8 precision
+*/
+/************************************************************************************/
+void ESP32_WS281x::ditherFrame()
+{
+  const uint16_t* hi            = _pixelsHi;
+  uint8_t*        err           = _ditherErr;
+  uint8_t*        ptr           = _pixels;
+  const uint16_t* lut           = _lut;
+  uint8_t         bytesPerPixel = _bytesPerPixel;
+  uint8_t         position      = 0;
+  uint8_t         index         = 0;
+  int32_t         step          = 0;
+  uint16_t        value         = 0;
+  uint16_t        acc           = 0;
+  uint16_t        c             = 0;
+
+  for (uint32_t i = 0; i < _numBytes; i++)
+  {
+    value = narrowHi(*hi++);
+
+    if (lut != NULL) //see NOTE
+    {
+      index = value >> 8;
+      step  = ((index < 255) ? lut[index + 1] : lut[index]) - lut[index]; //distance to next table entry
+      value = lut[index] + ((step * (value & 0xFF)) >> 8);
+
+      lut += 256;    //table of next byte position
+
+      if (++position == bytesPerPixel)
+      {
+        position = 0;
+        lut      = _lut;
+      }
+    }
+
+    acc    = *err + (value & 0xFF);  //carried error + fraction of this frame
+    c      = (value >> 8) + (acc >> 8);
+
+    *err++ = (uint8_t)acc;
+    *ptr++ = (c > 255) ? 255 : c;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   encodeFrame16()
+
+   Convert 16-bit working buffer to 16-bit channel bytes sent by "show()"
+
+   NOTE:
+   - color correction tables are applied with interpolation between 2 table
+     entries, same as "ditherFrame()". 8.8 table output ends at 0xFF00, so it
+     is stretched to full 16-bit range, see "widenHi()"
+
+   - power limit is applied here, encoder would scale high & low byte apart
+
+   - scale, power limiter scale 0..256, 256 = no scaling, see "powerScale()"
+*/
+/************************************************************************************/
+void ESP32_WS281x::encodeFrame16(uint16_t scale)
+{
+  const uint16_t* hi            = _pixelsHi;
+  uint8_t*        ptr           = _pixelsWide;
+  const uint16_t* lut           = _lut;
+  uint8_t         bytesPerPixel = _bytesPerPixel;
+  uint8_t         position      = 0;
+  uint8_t         index         = 0;
+  int32_t         step          = 0;
+  uint32_t        value         = 0;
+
+  for (uint32_t i = 0; i < _numBytes; i++)
+  {
+    value = *hi++;
+
+    if (lut != NULL) //see NOTE
+    {
+      value = narrowHi(value);
+      index = value >> 8;
+      step  = ((index < 255) ? lut[index + 1] : lut[index]) - lut[index]; //distance to next table entry
+      value = lut[index] + ((step * (int32_t)(value & 0xFF)) >> 8);
+      value = widenHi(value);        //0..0xFF00 -> 0..0xFFFF
+
+      lut += 256;    //table of next byte position
+
+      if (++position == bytesPerPixel)
+      {
+        position = 0;
+        lut      = _lut;
+      }
+    }
+
+    if (scale < 256) {value = (value * scale) >> 8;}
+
+    *ptr++ = value >> 8; //MSB first
+    *ptr++ = value;
+  }
+}
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using separate red(R), green(G) and blue(G) components in RAM
+
+   NOTE:
+   - if using RGBW pixels, white will be set to 0(off)
+   - 0b00RRGGBB for RGB LED drivers
+   - 0bWWRRGGBB for RGBW LED drivers
+
+   - ledIndex, pixel index starting from 0
+   - r, red  brightness 0..255 (minimum/off to maximum)
+   - g, green brightness 0..255 (minimum/off to maximum)
+   - b, blue brightness 0..255 (minimum/off to maximum)
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b)
+{
+  setPixelColor(ledIndex, r, g, b, 0);
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using separate red(R), green(G), blue(G) and white(W)
+   components in RAM (for RGBW LED drivers only)
+
+   NOTE:
+   - if using RGB pixels, white will be ignored
+   - if using RGB + warm white + cold white pixels, cold white will be set to
+     0(off), see "setPixelFormat()"
+   - 0bxxRRGGBB for RGB LED drivers
+   - 0bWWRRGGBB for RGBW LED drivers
+
+   - ledIndex, pixel index starting from 0
+   - r, red  brightness 0..255 (minimum/off to maximum)
+   - g, green brightness 0..255 (minimum/off to maximum)
+   - b, blue brightness 0..255 (minimum/off to maximum)
+   - w, white brightness 0..255 (minimum/off to maximum)
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+  setPixelColor(ledIndex, r, g, b, w, 0);
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using separate red(R), green(G), blue(G), warm white(W)
+   and cold white(C) components in RAM (for RGB + warm white + cold white LED
+   drivers, see "setPixelFormat()")
+
+   NOTE:
+   - if using pixels without white, white & cold white will be ignored
+   - if using RGBW pixels, cold white will be ignored
+
+   - ledIndex, pixel index starting from 0
+   - r, red  brightness 0..255 (minimum/off to maximum)
+   - g, green brightness 0..255 (minimum/off to maximum)
+   - b, blue brightness 0..255 (minimum/off to maximum)
+   - w, warm white brightness 0..255 (minimum/off to maximum)
+   - c, cold white brightness 0..255 (minimum/off to maximum)
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint8_t c)
+{
+  if (ledIndex < _numLEDs)
+  {
+    uint8_t  bytesPerPixel = _bytesPerPixel; //3..LED_MAX_CHANNELS, see "setPixelFormat()"
+    uint8_t* p             = &_pixels[ledIndex * bytesPerPixel];
+    uint32_t* sum          = _powerSum[_backFrame];
+
+    if ((_whiteColor != LED_WHITE_NONE) && (_wOffset != _rOffset)) //see "setWhiteExtraction()"
+    {
+      uint16_t rgbw[4] = {r, g, b, w};
+
+      extractWhite(rgbw, 255);
+
+      r = rgbw[LED_CHANNEL_R];
+      g = rgbw[LED_CHANNEL_G];
+      b = rgbw[LED_CHANNEL_B];
+      w = rgbw[LED_CHANNEL_W];
+    }
+
+    if (_maxCurrent != 0) //power limiter enabled, remove old color from sums, see "setMaxCurrent()"
+    {
+      for (uint8_t i = 0; i < bytesPerPixel; i++)
+      {
+        sum[i] -= (_pixelsHi != NULL) ? (_pixelsHi[ledIndex * bytesPerPixel + i] >> 8) : p[i]; //"_pixels" is dithered
+      }
+    }
+
+    if (_pixelsHi != NULL) //dithering enabled, keep fraction of brightness premultiply, see "setDithering()"
+    {
+      uint16_t *q = &_pixelsHi[ledIndex * bytesPerPixel];
+
+      q[_cOffset] = _brightness ? widenHi(c * _brightness) : (c * 257); //store C & W first, overwritten by R if absent
+      q[_wOffset] = _brightness ? widenHi(w * _brightness) : (w * 257);
+      q[_rOffset] = _brightness ? widenHi(r * _brightness) : (r * 257);
+      q[_gOffset] = _brightness ? widenHi(g * _brightness) : (g * 257);
+      q[_bOffset] = _brightness ? widenHi(b * _brightness) : (b * 257);
+
+      c = q[_cOffset] >> 8;
+      w = q[_wOffset] >> 8;
+      r = q[_rOffset] >> 8;
+      g = q[_gOffset] >> 8;
+      b = q[_bOffset] >> 8;
+    }
+    else if (_brightness) //see note in "setBrightness()", strip brightness 0..255 (stored as +1, e.g. 1..256)
+    {
+      r = (r * _brightness) >> 8;
+      g = (g * _brightness) >> 8;
+      b = (b * _brightness) >> 8;
+      w = (w * _brightness) >> 8;
+      c = (c * _brightness) >> 8;
+    }
+
+    p[_cOffset] = c; //store C & W first, overwritten by R if absent (C/W is ignored)
+    p[_wOffset] = w;
+    p[_rOffset] = r; //store R,G,B
+    p[_gOffset] = g;
+    p[_bOffset] = b;
+
+    if (_maxCurrent != 0) //add new color to sums
+    {
+      for (uint8_t i = 0; i < bytesPerPixel; i++) {sum[i] += p[i];}
+    }
+
+    if (ledIndex < _dirtyFirst) {_dirtyFirst = ledIndex;} //see "getDirtyRange()"
+    if (ledIndex > _dirtyLast)  {_dirtyLast  = ledIndex;}
+  }
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   NOTE:
+   Set a pixel's color using a 32-bit 'packed' RGB or RGBW value
+
+   NOTE:
+   - ledIndex, Pixel index starting from 0
+   - color, 32-bit color value. Most significant byte is white (for RGBW
+     pixels) or ignored (for RGB pixels), next is red, then green, and least
+     significant byte is blue
+
+   - 0bxxRRGGBB for RGB LED drivers
+   - 0bWWRRGGBB for RGBW LED drivers
+*/
+/************************************************************************************/
+void ESP32_WS281x::setPixelColor(ledIndexType ledIndex, uint32_t color)
+{
+  setPixelColor(ledIndex, (uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color, (uint8_t)(color >> 24));
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColors()
+
+   Set colors of a run of neighbour pixels from array of 32-bit 'packed' RGB or
+   RGBW values
+
+   NOTE:
+   - same result as calling "setPixelColor()" for every pixel, but pixel offsets,
+     brightness & dirty range are handled once per run instead of once per pixel
+
+   - with dithering enabled falls back to "setPixelColor()" for every pixel
+
+   - ledIndex, index of first pixel in run
+   - colors, array of numOfLEDs 32-bit color values, see "setPixelColor()"
+   - numOfLEDs, number of pixels in run, clipped to end of strip
+   - reverse, if true colors[0] goes to the last pixel of the run (serpentine
+     rows of LED matrix, reversed segments, etc.)
 */
 /************************************************************************************/
-ledPixelType ESP32_WS281x::strToPixelType(const char *strValue)
+void ESP32_WS281x::setPixelColors(ledIndexType ledIndex, const uint32_t *colors, ledIndexType numOfLEDs, bool reverse)
 {
-  int8_t r = 0, g = 0, b = 0, w = -1;
+  if ((ledIndex >= _numLEDs) || (colors == NULL) || (numOfLEDs == 0)) {return;}
 
-  if (strValue)
+  if (numOfLEDs > (_numLEDs - ledIndex)) //clip to end of strip
   {
-    char c;
+    if (reverse == true) {colors += numOfLEDs - (_numLEDs - ledIndex);} //skip colors of pixels past the end
 
-    for (uint8_t i=0; ((c = tolower(strValue[i]))); i++)
+    numOfLEDs = _numLEDs - ledIndex;
+  }
+
+  if (_pixelsHi != NULL) //dithering enabled, full-precision copy must be kept, see "setDithering()"
+  {
+    for (ledIndexType i = 0; i < numOfLEDs; i++)
     {
-      if      (c == 'r') {r = i;}
-      else if (c == 'g') {g = i;}
-      else if (c == 'b') {b = i;}
-      else if (c == 'w') {w = i;}
+      setPixelColor(ledIndex + i, colors[(reverse == true) ? (numOfLEDs - 1 - i) : i]);
     }
 
-    r &= 3;
+    return;
   }
 
-  if (w < 0) w = r; //if 'w' not specified, duplicate r bits
+  uint8_t  bytesPerPixel = _bytesPerPixel;
+  uint8_t* p             = &_pixels[ledIndex * bytesPerPixel];
+  uint16_t scale         = _brightness ? _brightness : 256; //see note in "setBrightness()"
+  bool     extract       = (_whiteColor != LED_WHITE_NONE) && (_wOffset != _rOffset); //see "setWhiteExtraction()"
 
-  return (w << 6) | (r << 4) | ((g & 3) << 2) | (b & 3);
+  if (_maxCurrent != 0) {updatePowerSum(ledIndex, numOfLEDs, false);} //remove old colors from sums, see "setMaxCurrent()"
+
+  for (ledIndexType i = 0; i < numOfLEDs; i++)
+  {
+    uint32_t color = colors[(reverse == true) ? (numOfLEDs - 1 - i) : i];
+
+    if (extract == true)
+    {
+      uint16_t rgbw[4] = {(uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color, (uint8_t)(color >> 24)};
+
+      extractWhite(rgbw, 255);
+
+      color = ((uint32_t)rgbw[LED_CHANNEL_W] << 24) | ((uint32_t)rgbw[LED_CHANNEL_R] << 16) | ((uint32_t)rgbw[LED_CHANNEL_G] << 8) | rgbw[LED_CHANNEL_B];
+    }
+
+    p[_cOffset] = 0;                                      //store C & W first, overwritten by R if absent
+    p[_wOffset] = ((uint8_t)(color >> 24) * scale) >> 8;
+    p[_rOffset] = ((uint8_t)(color >> 16) * scale) >> 8;
+    p[_gOffset] = ((uint8_t)(color >> 8)  * scale) >> 8;
+    p[_bOffset] = ((uint8_t)color         * scale) >> 8;
+
+    p += bytesPerPixel;
+  }
+
+  if (_maxCurrent != 0) {updatePowerSum(ledIndex, numOfLEDs, true);} //add new colors to sums
+
+  setDirtyRange(ledIndex, ledIndex + numOfLEDs - 1);
 }
 
 
 /************************************************************************************/
 /*
-   setPixelColor()
+   setPixelColor16()
 
-   Set a pixel's color using separate red(R), green(G) and blue(G) components in RAM
+   Set a pixel's color using separate 16-bit red(R), green(G) and blue(B)
+   components in RAM
 
    NOTE:
    - if using RGBW pixels, white will be set to 0(off)
-   - 0b00RRGGBB for RGB LED drivers
-   - 0bWWRRGGBB for RGBW LED drivers
 
-   - ledIndex, pixel index starting from 0
-   - r, red  brightness 0..255 (minimum/off to maximum)
-   - g, green brightness 0..255 (minimum/off to maximum)
-   - b, blue brightness 0..255 (minimum/off to maximum)
+   - see "setPixelColor16()" with white below
 */
 /************************************************************************************/
-void ESP32_WS281x::setPixelColor(uint16_t ledIndex, uint8_t r, uint8_t g, uint8_t b)
+void ESP32_WS281x::setPixelColor16(ledIndexType ledIndex, uint16_t r, uint16_t g, uint16_t b)
 {
-  if (ledIndex < _numLEDs)
-  {
-    if (_brightness) //see notes in "setBrightness()", strip brightness 0..255 (stored as +1, e.g. 1..256)
-    {
-      r = (r * _brightness) >> 8;
-      g = (g * _brightness) >> 8;
-      b = (b * _brightness) >> 8;
-    }
-
-    uint8_t *p;
-
-    if (_wOffset == _rOffset)   //RGB-type strip, 3-bytes per pixel
-    {
-      p = &_pixels[ledIndex * 3]; //3-bytes per pixel (ignore W)
-    }
-    else                        //WRGB-type strip, 4-bytes per pixel
-    {
-      p = &_pixels[ledIndex * 4]; //4-bytes per pixel
-
-      p[_wOffset] = 0;          //set W to 0, only R,G,B passed
-    }
-
-    p[_rOffset] = r; //store R,G,B
-    p[_gOffset] = g;
-    p[_bOffset] = b;
-  }
+  setPixelColor16(ledIndex, r, g, b, 0);
 }
 
 
 /************************************************************************************/
 /*
-   setPixelColor()
+   setPixelColor16()
 
-   Set a pixel's color using separate red(R), green(G), blue(G) and white(W)
-   components in RAM (for RGBW LED drivers only)
+   Set a pixel's color using separate 16-bit red(R), green(G), blue(B) and
+   white(W) components in RAM
 
    NOTE:
+   - full 16-bit value is sent with 16-bit channels (see "setChannelDepth()")
+     & kept as fraction for dithering (see "setDithering()"). Otherwise only
+     the high byte is used, same as "setPixelColor(r >> 8, g >> 8, ...)"
+
    - if using RGB pixels, white will be ignored
-   - 0bxxRRGGBB for RGB LED drivers
-   - 0bWWRRGGBB for RGBW LED drivers
+   - if using RGB + warm white + cold white pixels, cold white will be set to
+     0(off), see "setPixelColors16()" to set it
 
    - ledIndex, pixel index starting from 0
-   - r, red  brightness 0..255 (minimum/off to maximum)
-   - g, green brightness 0..255 (minimum/off to maximum)
-   - b, blue brightness 0..255 (minimum/off to maximum)
-   - w, white brightness 0..255 (minimum/off to maximum)
+   - r, red brightness 0..65535 (minimum/off to maximum)
+   - g, green brightness 0..65535 (minimum/off to maximum)
+   - b, blue brightness 0..65535 (minimum/off to maximum)
+   - w, white brightness 0..65535 (minimum/off to maximum)
 */
 /************************************************************************************/
-void ESP32_WS281x::setPixelColor(uint16_t ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+void ESP32_WS281x::setPixelColor16(ledIndexType ledIndex, uint16_t r, uint16_t g, uint16_t b, uint16_t w)
 {
-  if (ledIndex < _numLEDs)
+  if (ledIndex >= _numLEDs) {return;}
+
+  if (_pixelsHi == NULL) {setPixelColor(ledIndex, r >> 8, g >> 8, b >> 8, w >> 8); return;} //8-bit buffer only
+
+  uint8_t   bytesPerPixel = _bytesPerPixel;
+  uint16_t  scale         = _brightness ? _brightness : 256; //see note in "setBrightness()"
+  uint16_t* q             = &_pixelsHi[ledIndex * bytesPerPixel];
+  uint8_t*  p             = &_pixels[ledIndex * bytesPerPixel];
+  uint32_t* sum           = _powerSum[_backFrame];
+
+  if (_maxCurrent != 0) //power limiter enabled, remove old color from sums, see "setMaxCurrent()"
   {
-    if (_brightness) //see note in "setBrightness()", strip brightness 0..255 (stored as +1, e.g. 1..256)
-    {
-      r = (r * _brightness) >> 8;
-      g = (g * _brightness) >> 8;
-      b = (b * _brightness) >> 8;
-      w = (w * _brightness) >> 8;
-    }
+    for (uint8_t i = 0; i < bytesPerPixel; i++) {sum[i] -= q[i] >> 8;} //"_pixels" may be dithered
+  }
 
-    uint8_t *p;
+  if ((_whiteColor != LED_WHITE_NONE) && (_wOffset != _rOffset)) //see "setWhiteExtraction()"
+  {
+    uint16_t rgbw[4] = {r, g, b, w};
 
-    if (_wOffset == _rOffset)   //RGB-type strip, 3-bytes per pixel
-    {
-      p = &_pixels[ledIndex * 3]; //3-bytes per pixel (ignore W)
-    }
-    else                        //WRGB-type strip, 4-bytes per pixel
-    {
-      p = &_pixels[ledIndex * 4]; //4-bytes per pixel
+    extractWhite(rgbw, 65535);
 
-      p[_wOffset] = w;          //store W
-    }
+    r = rgbw[LED_CHANNEL_R];
+    g = rgbw[LED_CHANNEL_G];
+    b = rgbw[LED_CHANNEL_B];
+    w = rgbw[LED_CHANNEL_W];
+  }
 
-    p[_rOffset] = r; //store R,G,B
-    p[_gOffset] = g;
-    p[_bOffset] = b;
+  q[_cOffset] = 0;                          //store C & W first, overwritten by R if absent
+  q[_wOffset] = ((uint32_t)w * scale) >> 8;
+  q[_rOffset] = ((uint32_t)r * scale) >> 8;
+  q[_gOffset] = ((uint32_t)g * scale) >> 8;
+  q[_bOffset] = ((uint32_t)b * scale) >> 8;
+
+  for (uint8_t i = 0; i < bytesPerPixel; i++) {p[i] = q[i] >> 8;} //8-bit copy for power sums & "getRibbonColor()"
+
+  if (_maxCurrent != 0) //add new color to sums
+  {
+    for (uint8_t i = 0; i < bytesPerPixel; i++) {sum[i] += p[i];}
   }
+
+  if (ledIndex < _dirtyFirst) {_dirtyFirst = ledIndex;} //see "getDirtyRange()"
+  if (ledIndex > _dirtyLast)  {_dirtyLast  = ledIndex;}
 }
 
 
 /************************************************************************************/
 /*
-   setPixelColor()
+   setPixelColors16()
 
-   NOTE:
-   Set a pixel's color using a 32-bit 'packed' RGB or RGBW value
+   Set colors of a run of neighbour pixels from array of 16-bit channel values
 
    NOTE:
-   - ledIndex, Pixel index starting from 0
-   - color, 32-bit color value. Most significant byte is white (for RGBW
-     pixels) or ignored (for RGB pixels), next is red, then green, and least
-     significant byte is blue
+   - same result as calling "setPixelColor16()" for every pixel, but pixel
+     offsets, brightness, power sums & dirty range are handled once per run.
+     Meant for bulk ingest of high dynamic range frames (e.g. from network)
 
-   - 0bxxRRGGBB for RGB LED drivers
-   - 0bWWRRGGBB for RGBW LED drivers
+   - values are in R,G,B order for RGB-type strip, in R,G,B,W order for
+     RGBW-type strip & in R,G,B,W,C order for RGB + warm white + cold white
+     strip (see "setPixelFormat()"), whatever the order of channels on the wire is
+
+   - ledIndex, index of first pixel in run
+   - values, array of 3..LED_MAX_CHANNELS values per pixel, 0..65535 each
+   - numOfLEDs, number of pixels in run, clipped to end of strip
 */
 /************************************************************************************/
-void ESP32_WS281x::setPixelColor(uint16_t ledIndex, uint32_t color)
+void ESP32_WS281x::setPixelColors16(ledIndexType ledIndex, const uint16_t *values, ledIndexType numOfLEDs)
 {
-  if (ledIndex < _numLEDs)
-  {
-    uint8_t *p;
+  if ((ledIndex >= _numLEDs) || (values == NULL) || (numOfLEDs == 0)) {return;}
 
-    uint8_t r = (uint8_t)(color >> 16);
-    uint8_t g = (uint8_t)(color >> 8);
-    uint8_t b = (uint8_t)color;
+  if (numOfLEDs > (_numLEDs - ledIndex)) {numOfLEDs = _numLEDs - ledIndex;} //clip to end of strip
 
-    if (_brightness) //see note in 'setBrightness()', strip brightness 0..255 (stored as +1, e.g. 1..256)
-    {
-      r = (r * _brightness) >> 8;
-      g = (g * _brightness) >> 8;
-      b = (b * _brightness) >> 8;
-    }
+  const uint8_t offset[LED_MAX_CHANNELS] = {_rOffset, _gOffset, _bOffset, _wOffset, _cOffset};
+  uint8_t       bytesPerPixel            = _bytesPerPixel;
+  uint8_t       channels[LED_MAX_CHANNELS];        //channels present in R,G,B,W,C order, e.g. value index -> channel
+  uint8_t       numOfChannels            = 0;
+
+  for (uint8_t channel = 0; channel < LED_MAX_CHANNELS; channel++)
+  {
+    if ((channel <= LED_CHANNEL_B) || (offset[channel] != _rOffset)) {channels[numOfChannels++] = channel;}
+  }
 
-    if (_wOffset == _rOffset)    //RGB-type strip, 3-bytes per pixel
+  if (_pixelsHi == NULL)  //8-bit buffer only
+  {
+    for (ledIndexType i = 0; i < numOfLEDs; i++, values += bytesPerPixel)
     {
-      p = &_pixels[ledIndex * 3];
+      uint8_t c[LED_MAX_CHANNELS] = {0, 0, 0, 0, 0};
+
+      for (uint8_t j = 0; j < bytesPerPixel; j++) {c[channels[j]] = values[j] >> 8;}
+
+      setPixelColor(ledIndex + i, c[LED_CHANNEL_R], c[LED_CHANNEL_G], c[LED_CHANNEL_B], c[LED_CHANNEL_W], c[LED_CHANNEL_C]);
     }
-    else                         //WRGB-type strip, 4-bytes per pixel
+
+    return;
+  }
+
+  uint16_t  scale  = _brightness ? _brightness : 256; //see note in "setBrightness()"
+  uint16_t* q      = &_pixelsHi[ledIndex * bytesPerPixel];
+  uint8_t*  p      = &_pixels[ledIndex * bytesPerPixel];
+  uint32_t  sum[LED_MAX_CHANNELS] = {0, 0, 0, 0, 0}; //old colors are subtracted, new ones added
+  bool      extract = (_whiteColor != LED_WHITE_NONE) && (_wOffset != _rOffset); //see "setWhiteExtraction()"
+
+  for (ledIndexType i = 0; i < numOfLEDs; i++)
+  {
+    for (uint8_t j = 0; j < bytesPerPixel; j++) {sum[j] -= q[j] >> 8;} //"_pixels" may be dithered
+
+    for (uint8_t j = 0; j < bytesPerPixel; j++) {q[offset[channels[j]]] = ((uint32_t)values[j] * scale) >> 8;}
+
+    if (extract == true) //values are in R,G,B,W(,C) order
     {
-      p  = &_pixels[ledIndex * 4];
+      uint16_t rgbw[4] = {values[0], values[1], values[2], values[3]};
 
-      uint8_t w  = (uint8_t)(color >> 24);
+      extractWhite(rgbw, 65535);
 
-      p[_wOffset] = _brightness ? ((w * _brightness) >> 8) : w; //store W
+      for (uint8_t j = 0; j < 4; j++) {q[offset[j]] = ((uint32_t)rgbw[j] * scale) >> 8;}
     }
 
-    p[_rOffset] = r; //store R,G,B
-    p[_gOffset] = g;
-    p[_bOffset] = b;
+    for (uint8_t j = 0; j < bytesPerPixel; j++)
+    {
+      p[j]    = q[j] >> 8;
+      sum[j] += p[j];
+    }
+
+    q      += bytesPerPixel;
+    p      += bytesPerPixel;
+    values += bytesPerPixel;
+  }
+
+  if (_maxCurrent != 0) //see "setMaxCurrent()"
+  {
+    for (uint8_t j = 0; j < bytesPerPixel; j++) {_powerSum[_backFrame][j] += sum[j];} //modular sum of differences
   }
+
+  setDirtyRange(ledIndex, ledIndex + numOfLEDs - 1);
+}
+
+
+/************************************************************************************/
+/*
+   unscaleHi()
+
+   Convert 16-bit pixel value back to 8-bit value as set, see "updateUnscale()"
+
+   NOTE:
+   - value, 16-bit value multiplied by brightness scale, see "widenHi()"
+   - reciprocal, "_unscaleHi" of the strip
+*/
+/************************************************************************************/
+static inline uint8_t unscaleHi(uint16_t value, uint32_t reciprocal)
+{
+  uint32_t result = ((uint64_t)value * reciprocal) >> 24;
+
+  return (result > 255) ? 255 : result;
 }
 
 
@@ -620,45 +2951,65 @@ void ESP32_WS281x::setPixelColor(uint16_t ledIndex, uint32_t color)
 
   - 0b00RRGGBB for RGB LED drivers
   - 0bWWRRGGBB for RGBW LED drivers
+
+  - cold white (if any) is not returned, see "getPixelChannels()"
 */
 /************************************************************************************/
-const uint32_t ESP32_WS281x::getPixelColor(uint16_t ledIndex)
+const uint32_t ESP32_WS281x::getPixelColor(ledIndexType ledIndex)
 {
   if (ledIndex >= _numLEDs) {return 0;} //out of bounds, return no color
 
-  uint8_t* p;
-
-  if (_wOffset == _rOffset) //RGB-type strip, 3-bytes per pixel
+  if (_pixelsHi != NULL) //dithering or 16-bit channels enabled, full-precision value gives exact read back
   {
-    p = &_pixels[ledIndex * 3];
+    uint16_t* q = &_pixelsHi[ledIndex * _bytesPerPixel];
 
-    if (_brightness)        //see note in 'setBrightness()', strip brightness 0..255 (stored as +1, e.g. 1..256)
-    {
-      return (((uint32_t)(p[_rOffset] << 8) / _brightness) << 16) |
-             (((uint32_t)(p[_gOffset] << 8) / _brightness) << 8)  |
-              ((uint32_t)(p[_bOffset] << 8) / _brightness);
-    }
-    else                    //no "_brightness" adjustment has been made, return 'raw' color
-    {
+    return ((_wOffset != _rOffset) ? ((uint32_t)unscaleHi(q[_wOffset], _unscaleHi) << 24) : 0) |
+           ((uint32_t)unscaleHi(q[_rOffset], _unscaleHi) << 16) |
+           ((uint32_t)unscaleHi(q[_gOffset], _unscaleHi) << 8)  |
+            (uint32_t)unscaleHi(q[_bOffset], _unscaleHi);
+  }
 
-      return ((uint32_t)p[_rOffset] << 16) | ((uint32_t)p[_gOffset] << 8) | (uint32_t)p[_bOffset];
-    }
+  uint8_t* p = &_pixels[ledIndex * _bytesPerPixel];
+
+  if (_wOffset == _rOffset) //no white, 3-bytes per pixel (or 4-bytes with cold white)
+  {
+    return ((uint32_t)_unscale[p[_rOffset]] << 16) | ((uint32_t)_unscale[p[_gOffset]] << 8) | (uint32_t)_unscale[p[_bOffset]]; //see "updateUnscale()"
   }
-  else                      //WRGB-type strip, 4-bytes per pixel
+  else                      //WRGB-type strip, 4-bytes per pixel (or 5-bytes with cold white)
   {
-    p = &_pixels[ledIndex * 4];
+    return ((uint32_t)_unscale[p[_wOffset]] << 24) | ((uint32_t)_unscale[p[_rOffset]] << 16) | ((uint32_t)_unscale[p[_gOffset]] << 8) | (uint32_t)_unscale[p[_bOffset]];
+  }
+}
 
-    if (_brightness)        //return scaled color
-    {
-      return (((uint32_t)(p[_wOffset] << 8) / _brightness) << 24) |
-             (((uint32_t)(p[_rOffset] << 8) / _brightness) << 16) |
-             (((uint32_t)(p[_gOffset] << 8) / _brightness) << 8)  |
-              ((uint32_t)(p[_bOffset] << 8) / _brightness);
-    }
-    else                    //no "_brightness" adjustment has been made, return 'raw' color
-    {
-      return ((uint32_t)p[_wOffset] << 24) | ((uint32_t)p[_rOffset] << 16) | ((uint32_t)p[_gOffset] << 8)  | (uint32_t)p[_bOffset];
-    }
+
+/************************************************************************************/
+/*
+   getPixelChannels()
+
+   Get all channels of a previously-set pixel, e.g. of RGB + warm white + cold
+   white pixel "getPixelColor()" can't return
+
+   NOTE:
+   - stored values were decimated by "setBrightness()", same as "getPixelColor()"
+
+   - ledIndex, index of pixel to read (0=first)
+   - channels, returned array of LED_MAX_CHANNELS values indexed by
+     LED_CHANNEL_R..LED_CHANNEL_C. Channels strip doesn't have are 0. All
+     values are 0 if ledIndex is out of bounds
+*/
+/************************************************************************************/
+void ESP32_WS281x::getPixelChannels(ledIndexType ledIndex, uint8_t *channels)
+{
+  const uint8_t offset[LED_MAX_CHANNELS] = {_rOffset, _gOffset, _bOffset, _wOffset, _cOffset};
+
+  for (uint8_t channel = 0; channel < LED_MAX_CHANNELS; channel++)
+  {
+    if ((ledIndex >= _numLEDs) || ((channel > LED_CHANNEL_B) && (offset[channel] == _rOffset))) {channels[channel] = 0; continue;} //out of bounds or no such channel
+
+    uint32_t i = ledIndex * _bytesPerPixel + offset[channel];
+
+    if (_pixelsHi != NULL) {channels[channel] = unscaleHi(_pixelsHi[i], _unscaleHi);}  //dithering or 16-bit channels enabled, exact read back
+    else                   {channels[channel] = _unscale[_pixels[i]];}                   //same as "getPixelColor()"
   }
 }
 
@@ -676,6 +3027,8 @@ const uint32_t ESP32_WS281x::getPixelColor(uint16_t ledIndex)
      mayhem if one writes past the ends of the buffer. Great power, great
      responsibility and all that
 
+   - with dithering enabled buffer is overwritten by "show()", see "setDithering()"
+
    - pixel data is stored in a device-native format ("ledPixelType" format) and is
      not translated here. Applications that access this buffer will need to be
      aware of the specific data format and handle colors appropriately
@@ -692,6 +3045,63 @@ const uint8_t* ESP32_WS281x::getRibbonColor()
 }
 
 
+/************************************************************************************/
+/*
+   getDirtyRange()
+
+   Retrieve range of pixels changed since last "show()"
+
+   NOTE:
+   - range covers every pixel written by "setPixelColor()", "fill()", "rainbow()"
+     (of strip or any "ESP32_WS281x_Segment" on top of it), whole strip after
+     "clear()", "setBrightness()", "setLength()" and color correction changes
+     (e.g. "setGamma()"). Pixels in between may be unchanged
+
+   - range is kept if "show()" dropped the frame, so it's sent next time
+
+   - with triple buffering range is reset by "commit()" instead of "show()", so
+     it describes the frame being drawn
+
+   - firstIndex, returned index of first changed pixel
+   - lastIndex, returned index of last changed pixel
+
+   - return true if any pixel was changed, false otherwise (indexes are not set)
+*/
+/************************************************************************************/
+bool ESP32_WS281x::getDirtyRange(ledIndexType &firstIndex, ledIndexType &lastIndex)
+{
+  if (_dirtyFirst > _dirtyLast) {return false;}
+
+  firstIndex = _dirtyFirst;
+  lastIndex  = _dirtyLast;
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   setDirtyRange()
+
+   Add range of pixels to the changed range, e.g. after writing buffer directly
+   via "getRibbonColor()" pointer
+
+   NOTE:
+   - firstIndex, index of first changed pixel
+   - lastIndex, index of last changed pixel
+*/
+/************************************************************************************/
+void ESP32_WS281x::setDirtyRange(ledIndexType firstIndex, ledIndexType lastIndex)
+{
+  if ((firstIndex > lastIndex) || (firstIndex >= _numLEDs)) {return;}
+
+  if (lastIndex >= _numLEDs)   {lastIndex   = _numLEDs - 1;}
+
+  if (firstIndex < _dirtyFirst) {_dirtyFirst = firstIndex;}
+  if (lastIndex  > _dirtyLast)  {_dirtyLast  = lastIndex;}
+}
+
+
 /************************************************************************************/
 /*
    fill()
@@ -709,28 +3119,88 @@ const uint8_t* ESP32_WS281x::getRibbonColor()
      unspecified will fill to end of strip.
 */
 /************************************************************************************/
-void ESP32_WS281x::fill(uint32_t color, uint16_t ledIndex, uint16_t numOfLEDs)
+void ESP32_WS281x::fill(uint32_t color, ledIndexType ledIndex, ledIndexType numOfLEDs)
+{
+  const uint8_t channels[LED_MAX_CHANNELS] = {(uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color, (uint8_t)(color >> 24), 0};
+
+  fillChannels(channels, ledIndex, numOfLEDs);
+}
+
+
+/************************************************************************************/
+/*
+   fillChannels()
+
+   Fill all or part of the "ESP32_WS281x" data buffer in RAM with a color given
+   per channel, e.g. of RGB + warm white + cold white pixel "fill()" can't set
+
+   NOTE:
+   - pixel is encoded once & replicated with "memcpy()" doubling the filled part
+     every pass, so fill costs the same for any number of channels
+
+   - channels, array of LED_MAX_CHANNELS values 0..255 indexed by LED_CHANNEL_R..
+     LED_CHANNEL_C. Channels strip doesn't have are ignored
+   - ledIndex, index of first pixel to fill starting from 0. 0 if unspecified
+   - numOfLEDs, number of pixels to fill. Passing 0 or leaving unspecified will
+     fill to end of strip
+*/
+/************************************************************************************/
+void ESP32_WS281x::fillChannels(const uint8_t *channels, ledIndexType ledIndex, ledIndexType numOfLEDs)
 {
-  if (ledIndex >= _numLEDs) {return;} //if ledIndex LED is past end of strip, nothing to do
+  if ((ledIndex >= _numLEDs) || (channels == NULL)) {return;} //if ledIndex LED is past end of strip, nothing to do
 
-  uint16_t end;
+  ledIndexType end;
 
   //calculate index ONE AFTER the last pixel to fill
-  if (numOfLEDs == 0)
+  if ((numOfLEDs == 0) || (numOfLEDs > (_numLEDs - ledIndex)))
   {
-    end = _numLEDs;          //fill to end of strip
+    end = _numLEDs;          //fill to end of strip, ensure that the loop won't go past the last pixel
   }
-  else                       //ensure that the loop won't go past the last pixel
+  else
   {
     end = ledIndex + numOfLEDs;
+  }
+
+  if (_pixelsHi != NULL) //dithering enabled, full-precision copy must be kept, see "setDithering()"
+  {
+    for (ledIndexType i = ledIndex; i < end; i++)
+    {
+      this->setPixelColor(i, channels[LED_CHANNEL_R], channels[LED_CHANNEL_G], channels[LED_CHANNEL_B], channels[LED_CHANNEL_W], channels[LED_CHANNEL_C]);
+    }
+
+    return;
+  }
+
+  uint8_t  bytesPerPixel = _bytesPerPixel;
+  uint8_t* p             = &_pixels[ledIndex * bytesPerPixel];
+  uint32_t numBytes      = (uint32_t)(end - ledIndex) * bytesPerPixel;
+  uint16_t scale         = _brightness ? _brightness : 256; //see note in "setBrightness()"
+  uint8_t  pixel[LED_MAX_CHANNELS];
+  uint16_t rgbw[4]       = {channels[LED_CHANNEL_R], channels[LED_CHANNEL_G], channels[LED_CHANNEL_B], channels[LED_CHANNEL_W]};
+
+  if ((_whiteColor != LED_WHITE_NONE) && (_wOffset != _rOffset)) {extractWhite(rgbw, 255);} //see "setWhiteExtraction()"
 
-    if (end > _numLEDs) {end = _numLEDs;}
+  pixel[_cOffset] = (channels[LED_CHANNEL_C] * scale) >> 8; //encode color once, store C & W first, overwritten by R if absent
+  pixel[_wOffset] = (rgbw[LED_CHANNEL_W] * scale) >> 8;
+  pixel[_rOffset] = (rgbw[LED_CHANNEL_R] * scale) >> 8;
+  pixel[_gOffset] = (rgbw[LED_CHANNEL_G] * scale) >> 8;
+  pixel[_bOffset] = (rgbw[LED_CHANNEL_B] * scale) >> 8;
+
+  if (_maxCurrent != 0) {updatePowerSum(ledIndex, end - ledIndex, false);} //remove old colors from sums, see "setMaxCurrent()"
+
+  memcpy(p, pixel, bytesPerPixel);
+
+  for (uint32_t done = bytesPerPixel; done < numBytes; done *= 2) //replicate filled part, doubling it every pass
+  {
+    memcpy(&p[done], p, ((numBytes - done) < done) ? (numBytes - done) : done);
   }
 
-  for (uint16_t i = ledIndex; i < end; i++)
+  if (_maxCurrent != 0) //add new colors to sums
   {
-    this->setPixelColor(i, color);
+    for (uint8_t i = 0; i < bytesPerPixel; i++) {_powerSum[_backFrame][i] += (uint32_t)pixel[i] * (end - ledIndex);}
   }
+
+  setDirtyRange(ledIndex, end - 1);
 }
 
 
@@ -755,9 +3225,9 @@ void ESP32_WS281x::fill(uint32_t color, uint16_t ledIndex, uint16_t numOfLEDs)
 /************************************************************************************/
 void ESP32_WS281x::rainbow(uint16_t firstHue, int8_t reps, uint8_t saturation, uint8_t _brightness, bool gammify)
 {
-  for (uint16_t i=0; i < _numLEDs; i++)
+  for (ledIndexType i = 0; i < _numLEDs; i++)
   {
-    uint16_t hue = firstHue + (i * reps * 65536) / _numLEDs;
+    uint16_t hue = firstHue + ((int64_t)i * reps * 65536) / _numLEDs; //64-bit, "i * reps * 65536" overflows 32-bit on long strips
 
     uint32_t color = colorHSV(hue, saturation, _brightness);
 
@@ -778,6 +3248,11 @@ void ESP32_WS281x::rainbow(uint16_t firstHue, int8_t reps, uint8_t saturation, u
 void ESP32_WS281x::clear()
 { 
   memset(_pixels, 0, _numBytes);
+  memset(_powerSum[_backFrame], 0, sizeof(_powerSum[0]));
+
+  setDirtyRange(0, _numLEDs - 1);
+
+  if (_pixelsHi != NULL) {memset(_pixelsHi, 0, _numBytes * sizeof(uint16_t));}
 }
 
 
@@ -957,6 +3432,49 @@ uint32_t ESP32_WS281x::colorHSV(uint16_t hue, uint8_t sat, uint8_t brightness)
 }
 
 
+/************************************************************************************/
+/*
+   colorKelvin()
+
+   Convert color temperature of black body radiator to a packed 32-bit RGB color
+
+   NOTE:
+   - kelvin, temperature 1000..40000 Kelvin. 6600K is close to white(255, 255, 255),
+     lower is warmer (red/orange), higher is colder (blue)
+
+   - approximation by Tanner Helland fitted to Mitchell Charity's blackbody
+     data, good enough for white balancing LEDs
+
+   - returned packed 32-bit RGB with the most significant byte set to 0 (the
+     white element of WRGB pixels is NOT utilized)
+*/
+/************************************************************************************/
+uint32_t ESP32_WS281x::colorKelvin(uint16_t kelvin)
+{
+  float temperature = constrain(kelvin, 1000, 40000) / 100.0;
+  float r;
+  float g;
+  float b;
+
+  if (temperature <= 66)
+  {
+    r = 255;
+    g = 99.4708025861 * logf(temperature) - 161.1195681661;
+  }
+  else
+  {
+    r = 329.698727446 * powf(temperature - 60, -0.1332047592);
+    g = 288.1221695283 * powf(temperature - 60, -0.0755148492);
+  }
+
+  if      (temperature >= 66) {b = 255;}
+  else if (temperature <= 19) {b = 0;}
+  else                        {b = 138.5177312231 * logf(temperature - 10) - 305.0447927307;}
+
+  return color(constrain(r, 0, 255), constrain(g, 0, 255), constrain(b, 0, 255));
+}
+
+
 /************************************************************************************/
 /*
    gamma8()
@@ -969,8 +3487,8 @@ uint32_t ESP32_WS281x::colorHSV(uint16_t hue, uint8_t sat, uint8_t brightness)
    - return gamma-adjusted brightness, can then be passed to one of the
      "setPixelColor()" functions. This uses a fixed gamma correction exponent
      of 2.6, which seems reasonably okay for average LED drivers in average tasks.
-     If you need finer control you'll need to provide your own gamma-correction
-     function instead
+     If you need finer control use "setGamma()" or generate your own table with
+     "ledGammaTable()"
 */
 /************************************************************************************/
 uint8_t ESP32_WS281x::gamma8(uint8_t colorValue)
@@ -40,12 +40,54 @@
 
 
 #include <Arduino.h>
+#include <array>
 
 #include "ESP32_RMT.h"
+#include "ESP32_I2S.h"
+#include "ESP32_SPI.h"
 
 
 typedef uint8_t ledPixelType; //< 3-rd arg for "ESP32_WS281x" constructor
 
+/*
+   Pixel index & length type, 32-bit for strips longer than 65535 LEDs (e.g. PSRAM
+   backed virtual strips). Define LED_INDEX_16BIT before including this header to
+   keep 16-bit indexes & smaller tables (e.g. "ESP32_WS281x_Matrix") on small strips
+*/
+#if defined(LED_INDEX_16BIT)
+typedef uint16_t ledIndexType;
+#else
+typedef uint32_t ledIndexType;
+#endif
+
+#define LED_INDEX_NONE ((ledIndexType)~0) //invalid/none pixel index
+
+
+/* color channel index for per-channel color correction, see "setGamma()" */
+#define LED_CHANNEL_R 0
+#define LED_CHANNEL_G 1
+#define LED_CHANNEL_B 2
+#define LED_CHANNEL_W 3
+#define LED_CHANNEL_C 4 //cold white of tunable-white (RGB + warm white + cold white) pixel, W is warm white
+
+#define LED_MAX_CHANNELS 5 //maximum number of channels (bytes) per pixel, see "ledPixelFormat_t"
+
+
+/* white extraction, see "setWhiteExtraction()" */
+#define LED_WHITE_NONE 0x000000 //disabled
+#define LED_WHITE_MIN  0xFFFFFF //pure white die, common part of R,G,B is moved to W
+
+
+/* triple buffering "_readyFrame" bits, see "setTripleBuffering()" */
+#define LED_FRAME_INDEX_MASK 0x03 //index of frame 0..2
+#define LED_FRAME_FRESH      0x04 //frame committed & not yet sent
+
+
+/* buffer modes kept while strip has no pixel memory, see "reserve()" */
+#define LED_MODE_DITHERING   0x01 //temporal dithering, see "setDithering()"
+#define LED_MODE_WIDE        0x02 //16-bit channels, see "setChannelDepth()"
+#define LED_MODE_TRIPLE      0x04 //triple buffering, see "setTripleBuffering()"
+
 
 /*
    The order of primary colors in the "ESP32_WS281x" data stream can vary
@@ -103,72 +145,198 @@ typedef uint8_t ledPixelType; //< 3-rd arg for "ESP32_WS281x" constructor
 
 
 /*
-   table is declared outside of the "ESP32_WS281x" class for oldschool
-   compilers that don't handle the C++11 constexpr keyword
+   Pixel format with any number of channels up to LED_MAX_CHANNELS, for pixels
+   "ledPixelType" can't describe (e.g. RGB + warm white + cold white). See
+   "setPixelFormat()"
+
+   e.g. "{5, {LED_CHANNEL_G, LED_CHANNEL_R, LED_CHANNEL_B, LED_CHANNEL_W, LED_CHANNEL_C}}"
+   - indicates a LED driver expecting 5-bytes per pixel, transmitted as G,R,B,
+     warm white & cold white
 */
-/* PROGMEM (flash mem) table containing 8-bit gamma-correction table */
-static const uint8_t PROGMEM _ledPixelGammaTable[256] =
+typedef struct
 {
-  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-  0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,
-  1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   3,
-  3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   5,   6,
-  6,   6,   6,   7,   7,   7,   8,   8,   8,   9,   9,   9,   10,  10,  10,
-  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,
-  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
-  25,  26,  27,  27,  28,  29,  29,  30,  31,  31,  32,  33,  34,  34,  35,
-  36,  37,  38,  38,  39,  40,  41,  42,  42,  43,  44,  45,  46,  47,  48,
-  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
-  64,  65,  66,  68,  69,  70,  71,  72,  73,  75,  76,  77,  78,  80,  81,
-  82,  84,  85,  86,  88,  89,  90,  92,  93,  94,  96,  97,  99,  100, 102,
-  103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120, 122, 124, 125,
-  127, 129, 130, 132, 134, 136, 137, 139, 141, 143, 145, 146, 148, 150, 152,
-  154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180, 182,
-  184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
-  218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252,
-  255
-};
+  uint8_t numChannels;            //number of channels (bytes) per pixel 3..LED_MAX_CHANNELS
+  uint8_t order[LED_MAX_CHANNELS];//channel transmitted as 1-st, 2-nd.. byte, LED_CHANNEL_R..LED_CHANNEL_C. R, G & B are required
+} ledPixelFormat_t;
+
+
+/*
+   Compile-time gamma-correction table generator
+
+   NOTE:
+   - T, table type, e.g. uint8_t for 8-bit or uint16_t for 16-bit output
+   - inBits, input bit depth, table has 2^inBits entries
+   - outBits, output bit depth, default is full width of T
+   - gamma, exponent, e.g. 2.6
+
+   - e.g. "ledGammaTable<uint8_t>(2.6)" for 8->8 table used by "gamma8()" or
+     "ledGammaTable<uint16_t>(2.2)" for 8->16 table for dithered strips, see
+     "setChannelCurve()"
+
+   - declare result as "constexpr" (or "static constexpr" inside a function)
+     to evaluate it at compile time, only the generated table ends up in flash.
+     Math is done with "ledGammaLog()" & "ledGammaExp()" series below, because
+     "log()" & "exp()" aren't constexpr. Large tables (inBits > 12) may need a
+     higher "-fconstexpr-ops-limit"
+*/
+constexpr double ledGammaLog(double x) //natural log, x > 0
+{
+  int8_t k = 0;
 
+  while (x < 0.5) {x *= 2; k--;} //range reduction to 0.5..1
+  while (x > 1.0) {x /= 2; k++;}
+
+  double z    = (x - 1) / (x + 1);
+  double sum  = 0;
+  double term = z;
+
+  for (uint8_t n = 1; n < 60; n += 2) //ln(x) = 2 * atanh(z)
+  {
+    sum  += term / n;
+    term *= z * z;
+  }
+
+  return 2 * sum + k * 0.69314718055994530942;
+}
+
+constexpr double ledGammaExp(double x) //e^x
+{
+  uint8_t k = 0;
+
+  while ((x < -0.5) || (x > 0.5)) {x /= 2; k++;} //range reduction to -0.5..0.5
+
+  double sum  = 1;
+  double term = 1;
+
+  for (uint8_t n = 1; n < 25; n++) //Taylor series
+  {
+    term *= x / n;
+    sum  += term;
+  }
+
+  while (k-- > 0) {sum *= sum;}    //e^x = (e^(x/2))^2
+
+  return sum;
+}
+
+template <typename T, uint8_t inBits = 8, uint8_t outBits = 8 * sizeof(T)>
+constexpr std::array<T, (1UL << inBits)> ledGammaTable(double gamma)
+{
+  std::array<T, (1UL << inBits)> table{};
+
+  for (uint32_t i = 1; i < table.size(); i++) //table[0] = 0
+  {
+    table[i] = ledGammaExp(gamma * ledGammaLog(i / (double)((1UL << inBits) - 1))) * ((1UL << outBits) - 1) + 0.5;
+  }
+
+  return table;
+}
+
+
+/* flash table containing 8-bit gamma-correction table with 2.6 exponent, see "gamma8()" */
+extern const std::array<uint8_t, 256> _ledPixelGammaTable;
+
+
+class ESP32_Governor;
 
 class ESP32_WS281x
 {
+  friend class ESP32_Governor;
 
   public:
-  ESP32_WS281x(uint16_t ledQnt, int8_t dataPin = 6, ledPixelType ledType = LED_GRB);
+  ESP32_WS281x(ledIndexType ledQnt, int8_t dataPin = 6, ledPixelType ledType = LED_GRB);
   ESP32_WS281x();
  ~ESP32_WS281x();
 
   void                begin();
+  void                end();
+  bool                acquireChannel();
+  void                releaseChannel();
+  bool                setRealtime(bool enable);
+  const  bool         getRealtime();
   bool                canShow();
+  bool                waitShow(uint32_t timeoutMs = 1000);
+  static bool         waitShow(ESP32_WS281x *const *strips, uint8_t numStrips, uint32_t timeoutMs = 1000);
   void                show();
+  void                commit(bool copyFrame = false);
+  const  uint32_t     getDroppedFrames();
 
   void                setPin(int8_t dataPin);
   const  int8_t       getPin();
+  bool                setPins(const int8_t *dataPins, const ledIndexType *ledQnt, uint8_t numOfPins);
+  const  uint8_t      getNumPins();
+  bool                setOutput(const espOutput_t *output);
+  const  espOutput_t* getOutput();
   void                setBrightness(uint8_t brightness);
   const  uint8_t      getBrightness();
-  void                setLength(uint16_t ledQnt);
-  const  uint16_t     getLength();
+  void                setLength(ledIndexType ledQnt, bool preserve = false);
+  const  ledIndexType getLength();
+  bool                reserve(ledIndexType ledQnt);
+  const  ledIndexType getCapacity();
   void                setPixelType(ledPixelType ledType);
   static ledPixelType strToPixelType(const char *strValue);
-
-  void                setPixelColor(uint16_t ledIndex, uint8_t r, uint8_t g, uint8_t b);
-  void                setPixelColor(uint16_t ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
-  void                setPixelColor(uint16_t ledIndex, uint32_t color);
-  const  uint32_t     getPixelColor(uint16_t ledIndex);
+  bool                setPixelFormat(const ledPixelFormat_t &format);
+  static ledPixelFormat_t strToPixelFormat(const char *strValue);
+  bool                setDithering(bool enable);
+  const  bool         getDithering();
+  bool                setChannelDepth(uint8_t bits);
+  const  uint8_t      getChannelDepth();
+  bool                setTripleBuffering(bool enable);
+  const  bool         getTripleBuffering();
+  void                setGamma(float gamma);
+  void                setGamma(float gammaR, float gammaG, float gammaB, float gammaW = 1.0);
+  void                setChannelCurve(uint8_t channel, const uint8_t *curve);
+  void                setChannelCurve(uint8_t channel, const uint16_t *curve);
+  void                setColorCorrection(uint32_t correction);
+  void                setColorTemperature(uint16_t kelvin);
+  void                setWhiteExtraction(uint32_t whiteColor = LED_WHITE_MIN);
+  const  uint32_t     getWhiteExtraction();
+  void                setPowerModel(uint8_t mAred, uint8_t mAgreen, uint8_t mAblue, uint8_t mAwhite = 20, uint8_t idleMA = 1);
+  void                setMaxCurrent(uint32_t maxMA);
+  const  uint32_t     getCurrent();
+
+  void                setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b);
+  void                setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+  void                setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w, uint8_t c);
+  void                setPixelColor(ledIndexType ledIndex, uint32_t color);
+  void                setPixelColors(ledIndexType ledIndex, const uint32_t *colors, ledIndexType numOfLEDs, bool reverse = false);
+  void                setPixelColor16(ledIndexType ledIndex, uint16_t r, uint16_t g, uint16_t b);
+  void                setPixelColor16(ledIndexType ledIndex, uint16_t r, uint16_t g, uint16_t b, uint16_t w);
+  void                setPixelColors16(ledIndexType ledIndex, const uint16_t *values, ledIndexType numOfLEDs);
+  const  uint32_t     getPixelColor(ledIndexType ledIndex);
+  void                getPixelChannels(ledIndexType ledIndex, uint8_t *channels);
   const  uint8_t*     getRibbonColor();
-  void                fill(uint32_t color = 0, uint16_t ledIndex = 0, uint16_t numOfLEDs = 0);
+  bool                getDirtyRange(ledIndexType &firstIndex, ledIndexType &lastIndex);
+  void                setDirtyRange(ledIndexType firstIndex, ledIndexType lastIndex);
+  void                fill(uint32_t color = 0, ledIndexType ledIndex = 0, ledIndexType numOfLEDs = 0);
+  void                fillChannels(const uint8_t *channels, ledIndexType ledIndex = 0, ledIndexType numOfLEDs = 0);
   void                rainbow(uint16_t firstHue = 0, int8_t reps = 1, uint8_t saturation = 255, uint8_t brightness = 255, bool gammify = true);
   void                clear();
 
   static uint32_t     color(uint8_t r, uint8_t g, uint8_t b);
   static uint32_t     color(uint8_t r, uint8_t g, uint8_t b, uint8_t w);
   static uint32_t     colorHSV(uint16_t hue, uint8_t sat = 255, uint8_t brightness = 255);
+  static uint32_t     colorKelvin(uint16_t kelvin);
   static uint8_t      gamma8(uint8_t colorValue);
   static uint32_t     gamma32(uint32_t colorValue);
 
 
 private:
-  //empty
+  void                setPinMode(bool output);
+  void                updatePixelFormat(uint8_t oldBytesPerPixel);
+  EventBits_t         getDoneBits();
+  bool                setCapacity(uint32_t capacity);
+  uint8_t             getPartCapacity(uint32_t *numBytes);
+  bool                reserveOutput();
+  void                ditherFrame();
+  void                encodeFrame16(uint16_t scale);
+  void                updateLUT();
+  void                updateUnscale();
+  void                extractWhite(uint16_t *rgbw, uint16_t maxValue);
+  void                updatePowerSum(uint8_t frame);
+  void                updatePowerSum(ledIndexType ledIndex, ledIndexType numOfLEDs, bool add);
+  uint32_t            estimateCurrent(uint8_t frame);
+  uint16_t            powerScale(uint8_t frame);
 
 protected:
   bool     _isStarted;  //true if "begin()" previously called
@@ -178,10 +346,45 @@ protected:
   uint8_t  _gOffset;    //index of green byte
   uint8_t  _bOffset;    //index of blue byte
   uint8_t  _wOffset;    //index of white (==rOffset if no white)
-  uint16_t _numLEDs;    //number of RGB LEDs in strip
-  uint16_t _numBytes;   //size of '_pixels' buffer below (3-bytes or 4-bytes per pixel)
-  uint8_t* _pixels;     //buffer to hold LED color values (3-bytes or 4-bytes each color)
-  uint32_t _endTime;    //latch timing reference
+  uint8_t  _cOffset;    //index of cold white (==rOffset if no cold white), see "setPixelFormat()"
+  uint8_t  _bytesPerPixel; //number of channels (bytes) per pixel 3..LED_MAX_CHANNELS
+  ledIndexType _numLEDs; //number of RGB LEDs in strip
+  uint32_t _numBytes;   //size of '_pixels' buffer below ("_bytesPerPixel" per pixel)
+  uint8_t* _pixels;     //buffer to hold LED color values ("_bytesPerPixel" each color)
+  uint16_t* _pixelsHi;  //16-bit working buffer (0xFFFF = full scale) for temporal dithering or 16-bit channels, NULL if both are disabled
+  uint8_t*  _ditherErr; //per-byte dither error accumulator, NULL if dithering is disabled
+  uint8_t*  _pixelsWide;//16-bit channel values sent by "show()", 2 bytes (MSB first) per color byte, NULL if 16-bit channels are disabled
+  volatile bool _isCommitted; //true if frame is complete & waiting for "ESP32_Governor", with triple buffering governor checks "_readyFrame" instead
+  uint8_t*  _frames;    //3 frames for lock-free render/transmit handoff, "_pixels" points to one of them, NULL if disabled
+  uint8_t   _backFrame; //frame being drawn, owned by producer ("commit()")
+  uint8_t   _frontFrame;//frame being sent, owned by consumer ("show()")
+  uint32_t  _readyFrame;//latest committed frame index + "LED_FRAME_FRESH" flag, exchanged atomically
+  uint8_t   _modes;     //"LED_MODE_..." bits of buffers released by "setCapacity(0)", restored on next allocation
+  uint16_t* _lut;       //8.8 fixed-point color correction tables applied by encoder, 256-entries per byte position in pixel (device order), NULL if disabled
+  uint8_t   _unscale[256]; //stored 8-bit value to value as set at current brightness, see "updateUnscale()"
+  uint32_t  _unscaleHi; //0.24 fixed-point reciprocal of current brightness for 16-bit values, see "updateUnscale()"
+  float     _gamma[LED_MAX_CHANNELS];  //gamma exponent per R,G,B,W,C channel, 1.0 if linear
+  const uint8_t* _curve[LED_MAX_CHANNELS]; //user 8->8 curve per R,G,B,W,C channel (overrides gamma), NULL if not set
+  const uint16_t* _curve16[LED_MAX_CHANNELS]; //user 8->16 curve per R,G,B,W,C channel (overrides gamma), NULL if not set
+  uint32_t  _correction;//packed WRGB white-point scale, 0xFFFFFFFF if none
+  uint32_t  _temperature;//packed WRGB color temperature scale, 0xFFFFFFFF if none
+  uint32_t  _whiteColor; //packed RGB color of white die, LED_WHITE_NONE if white extraction is disabled
+  uint16_t  _whiteRatio[3]; //full scale / white die color per R,G,B in 8.8 fixed-point, 0 if die has none of it
+  uint32_t  _maxCurrent; //current budget in mA, 0 if power limiter is disabled
+  uint8_t   _channelCurrent[LED_MAX_CHANNELS]; //current per R,G,B,W,C channel at full output, in mA
+  uint8_t   _idleCurrent;//current per LED with all channels off, in mA
+  uint32_t  _powerSum[3][LED_MAX_CHANNELS]; //sum of color values per byte position in pixel for each frame (see "setTripleBuffering()"), kept up to date while drawing
+  ledIndexType _dirtyFirst;//index of first pixel changed since last "show()"/"commit()", LED_INDEX_NONE if none
+  ledIndexType _dirtyLast; //index of last pixel changed since last "show()"/"commit()"
+  uint8_t   _numPins;   //number of pins of virtual strip (see "setPins()"), 0 if strip uses "_pin" only
+  uint8_t   _pins[ESP_OUTPUT_MAX_PINS];   //output pins of virtual strip
+  ledIndexType _pinLEDs[ESP_OUTPUT_MAX_PINS];//number of LEDs on every pin of virtual strip
+  uint32_t  _capacity;  //allocated size of '_pixels' & every other per-frame buffer, in bytes (see "reserve()")
+  bool      _isAcquired;//true if strip owns RMT channel(s), see "acquireChannel()"
+  ESP32_Governor* _governor; //governor sending this strip, woken up by "commit()" in free-run mode, NULL if none
+  uint32_t  _droppedFrames;  //number of frames replaced by a newer one or not sent by "show()", updated with "__atomic_*" (producer & governor tasks)
+  bool      _isRealtime;     //true if "show()" never allocates or reconfigures RMT, see "setRealtime()"
+  const espOutput_t* _output;//output backend, see "setOutput()"
 
 };
 
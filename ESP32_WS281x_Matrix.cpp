@@ -0,0 +1,485 @@
+/***************************************************************************************************/
+/*
+   This is a 2D matrix layer for the "ESP32_WS281x" library. Matrix maps (x, y)
+   coordinates of LED panels (progressive/zigzag, rows/columns, tiled) to strip
+   indexes via table built once, & writes row/column spans with bulk stores
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x_Matrix.h"
+
+
+/************************************************************************************/
+/*
+   ESP32_WS281x_Matrix()
+
+   Constructor
+
+   NOTE:
+   - matrix doesn't own pixels, all pixels are stored in parent strip & "show()"
+     of parent strip sends them
+
+   - strip, parent "ESP32_WS281x" strip object, must outlive the matrix
+   - tileWidth, width of one tile (whole panel if not tiled), in pixels
+   - tileHeight, height of one tile, in pixels
+   - layout, wiring of pixels inside tile, see LED_MATRIX_* flags
+   - tilesX, number of tiles in horizontal direction
+   - tilesY, number of tiles in vertical direction
+   - tileLayout, wiring of tiles inside panel, see LED_MATRIX_* flags. Every
+     tile is wired the same way, zigzag tiles are not rotated
+*/
+/************************************************************************************/
+ESP32_WS281x_Matrix::ESP32_WS281x_Matrix(ESP32_WS281x &strip, uint16_t tileWidth, uint16_t tileHeight, uint8_t layout, uint8_t tilesX, uint8_t tilesY, uint8_t tileLayout) : _strip(&strip), _width(0), _height(0), _xyTable(NULL)
+{
+  setLayout(tileWidth, tileHeight, layout, tilesX, tilesY, tileLayout);
+}
+
+
+/************************************************************************************/
+/*
+   ~ESP32_WS281x_Matrix()
+
+   Destructor, free index table
+*/
+/************************************************************************************/
+ESP32_WS281x_Matrix::~ESP32_WS281x_Matrix()
+{
+  free(_xyTable);
+}
+
+
+/************************************************************************************/
+/*
+   setLayout()
+
+   Change matrix geometry & rebuild (x, y) to strip index table
+
+   NOTE:
+   - table needs "sizeof(ledIndexType)" bytes per pixel, built once here so drawing never repeats
+     the layout math
+
+   - see constructor for parameters
+
+   - return true on success, false if size is 0, width or height is bigger than
+     65535, size is bigger than strip index range or out of memory (matrix
+     becomes 0x0, all writes are ignored)
+*/
+/************************************************************************************/
+bool ESP32_WS281x_Matrix::setLayout(uint16_t tileWidth, uint16_t tileHeight, uint8_t layout, uint8_t tilesX, uint8_t tilesY, uint8_t tileLayout)
+{
+  uint32_t width  = (uint32_t)tileWidth  * tilesX;
+  uint32_t height = (uint32_t)tileHeight * tilesY;
+  uint64_t size   = (uint64_t)width * height;
+
+  free(_xyTable);
+
+  _xyTable = NULL;
+  _width   = 0;
+  _height  = 0;
+
+  if ((width == 0) || (height == 0) || (width > 0xFFFF) || (height > 0xFFFF) || (size > LED_INDEX_NONE)) {return false;} //"_width" & "_height" are 16-bit
+
+  if (((size * sizeof(ledIndexType)) > SIZE_MAX) || ((_xyTable = (ledIndexType *)malloc(size * sizeof(ledIndexType))) == NULL)) {return false;}
+
+  uint32_t tileSize = (uint32_t)tileWidth * tileHeight;
+
+  for (uint32_t y = 0; y < height; y++)
+  {
+    for (uint32_t x = 0; x < width; x++)
+    {
+      uint32_t tile  = mapXY(x / tileWidth, y / tileHeight, tilesX,    tilesY,     tileLayout);
+      uint32_t pixel = mapXY(x % tileWidth, y % tileHeight, tileWidth, tileHeight, layout);
+
+      _xyTable[y * width + x] = tile * tileSize + pixel;
+    }
+  }
+
+  _width  = width;
+  _height = height;
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   getWidth()
+
+   Return matrix width, in pixels
+*/
+/************************************************************************************/
+const uint16_t ESP32_WS281x_Matrix::getWidth()
+{
+  return _width;
+}
+
+
+/************************************************************************************/
+/*
+   getHeight()
+
+   Return matrix height, in pixels
+*/
+/************************************************************************************/
+const uint16_t ESP32_WS281x_Matrix::getHeight()
+{
+  return _height;
+}
+
+
+/************************************************************************************/
+/*
+   getStripIndex()
+
+   Convert (x, y) coordinates to parent strip index
+
+   NOTE:
+   - x, column 0..getWidth() - 1, 0 is left
+   - y, row 0..getHeight() - 1, 0 is top
+
+   - return parent index, LED_INDEX_NONE if (x, y) is outside of matrix
+*/
+/************************************************************************************/
+const ledIndexType ESP32_WS281x_Matrix::getStripIndex(uint16_t x, uint16_t y)
+{
+  if ((x >= _width) || (y >= _height)) {return LED_INDEX_NONE;}
+
+  return _xyTable[(uint32_t)y * _width + x];
+}
+
+
+/************************************************************************************/
+/*
+   getStrip()
+
+   Return parent strip
+*/
+/************************************************************************************/
+ESP32_WS281x& ESP32_WS281x_Matrix::getStrip()
+{
+  return *_strip;
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using separate R, G, B components
+
+   NOTE:
+   - see parent "setPixelColor()" for details
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::setPixelColor(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+  _strip->setPixelColor(getStripIndex(x, y), r, g, b); //LED_INDEX_NONE is past end of any strip
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using separate R, G, B, W components (for RGBW pixels)
+
+   NOTE:
+   - see parent "setPixelColor()" for details
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::setPixelColor(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+  _strip->setPixelColor(getStripIndex(x, y), r, g, b, w);
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using a 32-bit 'packed' RGB or RGBW value
+
+   NOTE:
+   - see parent "setPixelColor()" for details
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::setPixelColor(uint16_t x, uint16_t y, uint32_t color)
+{
+  _strip->setPixelColor(getStripIndex(x, y), color);
+}
+
+
+/************************************************************************************/
+/*
+   getPixelColor()
+
+   Query the color of a previously-set pixel
+
+   NOTE:
+   - see parent "getPixelColor()" for details
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x_Matrix::getPixelColor(uint16_t x, uint16_t y)
+{
+  return _strip->getPixelColor(getStripIndex(x, y));
+}
+
+
+/************************************************************************************/
+/*
+   fillRow()
+
+   Fill all or part of a row with a color
+
+   NOTE:
+   - y, row 0..getHeight() - 1
+   - color, 32-bit color value
+   - x, first column to fill
+   - width, number of pixels to fill, 0 = fill to right edge
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::fillRow(uint16_t y, uint32_t color, uint16_t x, uint16_t width)
+{
+  if ((x >= _width) || (y >= _height)) {return;}
+
+  if ((width == 0) || (width > (_width - x))) {width = _width - x;}
+
+  drawSpan(x, y, width, false, color, NULL);
+}
+
+
+/************************************************************************************/
+/*
+   fillColumn()
+
+   Fill all or part of a column with a color
+
+   NOTE:
+   - x, column 0..getWidth() - 1
+   - color, 32-bit color value
+   - y, first row to fill
+   - height, number of pixels to fill, 0 = fill to bottom edge
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::fillColumn(uint16_t x, uint32_t color, uint16_t y, uint16_t height)
+{
+  if ((x >= _width) || (y >= _height)) {return;}
+
+  if ((height == 0) || (height > (_height - y))) {height = _height - y;}
+
+  drawSpan(x, y, height, true, color, NULL);
+}
+
+
+/************************************************************************************/
+/*
+   fillRect()
+
+   Fill rectangle with a color
+
+   NOTE:
+   - rectangle is clipped to matrix
+
+   - x, left column
+   - y, top row
+   - width, rectangle width, in pixels
+   - height, rectangle height, in pixels
+   - color, 32-bit color value
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::fillRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color)
+{
+  if ((x >= _width) || (y >= _height)) {return;}
+
+  if (width  > (_width  - x)) {width  = _width  - x;}
+  if (height > (_height - y)) {height = _height - y;}
+
+  for (uint16_t row = y; row < (y + height); row++)
+  {
+    drawSpan(x, row, width, false, color, NULL);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   blit()
+
+   Copy rectangle of colors to matrix
+
+   NOTE:
+   - rectangle is clipped to matrix, clipped part of source is skipped
+
+   - x, left column of destination
+   - y, top row of destination
+   - width, source width, in pixels
+   - height, source height, in pixels
+   - colors, source array of width * height 32-bit color values, row by row
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::blit(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint32_t *colors)
+{
+  if ((x >= _width) || (y >= _height) || (colors == NULL)) {return;}
+
+  uint16_t visibleWidth  = (width  > (_width  - x)) ? (_width  - x) : width;
+  uint16_t visibleHeight = (height > (_height - y)) ? (_height - y) : height;
+
+  for (uint16_t row = 0; row < visibleHeight; row++)
+  {
+    drawSpan(x, y + row, visibleWidth, false, 0, &colors[(uint32_t)row * width]);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   fill()
+
+   Fill whole matrix with a color
+
+   NOTE:
+   - color, 32-bit color value
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::fill(uint32_t color)
+{
+  fillRect(0, 0, _width, _height, color);
+}
+
+
+/************************************************************************************/
+/*
+   clear()
+
+   Fill whole matrix with 0/black/off, other pixels of parent strip are not
+   changed
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::clear()
+{
+  fill(0);
+}
+
+
+/************************************************************************************/
+/*
+   mapXY()
+
+   Calculate index of (x, y) inside rectangle wired according to layout
+
+   NOTE:
+   - x, column 0..width - 1, 0 is left
+   - y, row 0..height - 1, 0 is top
+   - width, rectangle width
+   - height, rectangle height
+   - layout, see LED_MATRIX_* flags
+
+   - return index 0..width * height - 1
+*/
+/************************************************************************************/
+uint32_t ESP32_WS281x_Matrix::mapXY(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t layout)
+{
+  if ((layout & LED_MATRIX_BOTTOM) != 0) {y = height - 1 - y;}
+  if ((layout & LED_MATRIX_RIGHT)  != 0) {x = width  - 1 - x;}
+
+  uint16_t major    = y;     //wired line
+  uint16_t minor    = x;     //position inside wired line
+  uint16_t lineSize = width;
+
+  if ((layout & LED_MATRIX_COLUMNS) != 0)
+  {
+    major    = x;
+    minor    = y;
+    lineSize = height;
+  }
+
+  if (((layout & LED_MATRIX_ZIGZAG) != 0) && ((major & 0x01) != 0)) {minor = lineSize - 1 - minor;} //every second line runs backward
+
+  return (uint32_t)major * lineSize + minor;
+}
+
+
+/************************************************************************************/
+/*
+   drawSpan()
+
+   Write horizontal or vertical span of pixels
+
+   NOTE:
+   - span is split into runs of neighbour strip indexes (forward or backward),
+     every run is written by one parent "fill()" or "setPixelColors()" call.
+     Row of row-wired panel is one run, column of column-wired panel is one run
+
+   - span must be inside the matrix
+
+   - x, column of first pixel
+   - y, row of first pixel
+   - numOfLEDs, number of pixels in span
+   - vertical, true for column span, false for row span
+   - color, 32-bit color value if colors is NULL
+   - colors, array of numOfLEDs 32-bit color values, NULL to fill with color
+*/
+/************************************************************************************/
+void ESP32_WS281x_Matrix::drawSpan(uint16_t x, uint16_t y, uint16_t numOfLEDs, bool vertical, uint32_t color, const uint32_t *colors)
+{
+  const ledIndexType* index = &_xyTable[(uint32_t)y * _width + x];
+  uint32_t            step  = (vertical == true) ? _width : 1; //table step between span pixels
+  uint16_t            start = 0;
+
+  while (start < numOfLEDs)
+  {
+    ledIndexType first = index[start * step];
+    uint16_t     count = 1;
+    int64_t      dir   = 0;                                //+1 forward run, -1 backward run
+
+    if ((start + 1) < numOfLEDs)
+    {
+      dir = (int64_t)index[(start + 1) * step] - first;
+
+      if ((dir != 1) && (dir != -1)) {dir = 0;}            //not neighbours, single pixel run
+    }
+
+    if (dir != 0)
+    {
+      while (((start + count) < numOfLEDs) && ((int64_t)index[(start + count) * step] == ((int64_t)first + dir * count))) {count++;}
+    }
+
+    ledIndexType lowest = (dir < 0) ? (first - count + 1) : first;
+
+    if (colors == NULL) {_strip->fill(color, lowest, count);}
+    else                {_strip->setPixelColors(lowest, &colors[start], count, (dir < 0));}
+
+    start += count;
+  }
+}
@@ -0,0 +1,109 @@
+/***************************************************************************************************/
+/*
+   This is a 2D matrix layer for the "ESP32_WS281x" library. Matrix maps (x, y)
+   coordinates of LED panels (progressive/zigzag, rows/columns, tiled) to strip
+   indexes via table built once, & writes row/column spans with bulk stores
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef ESP32_WS281x_Matrix_H
+#define ESP32_WS281x_Matrix_H
+
+
+#include <Arduino.h>
+
+#include "ESP32_WS281x.h"
+
+
+/*
+   Matrix layout flags, used for pixels inside a tile & for tiles inside a panel. Combine
+   one flag from every group, e.g. LED_MATRIX_TOP + LED_MATRIX_LEFT + LED_MATRIX_ROWS +
+   LED_MATRIX_ZIGZAG
+
+   - first pixel is at top or bottom row
+   - first pixel is at left or right column
+   - pixels are wired in rows or in columns
+   - all rows/columns run in the same direction (progressive) or every second
+     row/column runs backward (zigzag, serpentine)
+*/
+#define LED_MATRIX_TOP          0x00
+#define LED_MATRIX_BOTTOM       0x01
+#define LED_MATRIX_LEFT         0x00
+#define LED_MATRIX_RIGHT        0x02
+#define LED_MATRIX_ROWS         0x00
+#define LED_MATRIX_COLUMNS      0x04
+#define LED_MATRIX_PROGRESSIVE  0x00
+#define LED_MATRIX_ZIGZAG       0x08
+
+
+class ESP32_WS281x_Matrix
+{
+
+  public:
+  ESP32_WS281x_Matrix(ESP32_WS281x &strip, uint16_t tileWidth, uint16_t tileHeight, uint8_t layout = LED_MATRIX_TOP + LED_MATRIX_LEFT + LED_MATRIX_ROWS + LED_MATRIX_ZIGZAG,
+                      uint8_t tilesX = 1, uint8_t tilesY = 1, uint8_t tileLayout = LED_MATRIX_TOP + LED_MATRIX_LEFT + LED_MATRIX_ROWS + LED_MATRIX_PROGRESSIVE);
+ ~ESP32_WS281x_Matrix();
+  ESP32_WS281x_Matrix(const ESP32_WS281x_Matrix &) = delete;            //owns "_xyTable", copy would free it twice
+  ESP32_WS281x_Matrix& operator=(const ESP32_WS281x_Matrix &) = delete;
+
+  bool                setLayout(uint16_t tileWidth, uint16_t tileHeight, uint8_t layout, uint8_t tilesX = 1, uint8_t tilesY = 1, uint8_t tileLayout = LED_MATRIX_TOP + LED_MATRIX_LEFT + LED_MATRIX_ROWS + LED_MATRIX_PROGRESSIVE);
+  const  uint16_t     getWidth();
+  const  uint16_t     getHeight();
+  const  ledIndexType getStripIndex(uint16_t x, uint16_t y);
+  ESP32_WS281x&       getStrip();
+
+  void                setPixelColor(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b);
+  void                setPixelColor(uint16_t x, uint16_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+  void                setPixelColor(uint16_t x, uint16_t y, uint32_t color);
+  const  uint32_t     getPixelColor(uint16_t x, uint16_t y);
+  void                fillRow(uint16_t y, uint32_t color = 0, uint16_t x = 0, uint16_t width = 0);
+  void                fillColumn(uint16_t x, uint32_t color = 0, uint16_t y = 0, uint16_t height = 0);
+  void                fillRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color = 0);
+  void                blit(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint32_t *colors);
+  void                fill(uint32_t color = 0);
+  void                clear();
+
+
+private:
+  static uint32_t     mapXY(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t layout);
+  void                drawSpan(uint16_t x, uint16_t y, uint16_t numOfLEDs, bool vertical, uint32_t color, const uint32_t *colors);
+
+protected:
+  ESP32_WS281x*       _strip;   //parent strip, owns pixel buffer
+  uint16_t            _width;   //matrix width, in pixels
+  uint16_t            _height;  //matrix height, in pixels
+  ledIndexType*       _xyTable; //strip index of every (x, y), row by row
+};
+
+#endif
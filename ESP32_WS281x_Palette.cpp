@@ -0,0 +1,541 @@
+/***************************************************************************************************/
+/*
+   This is a palette-indexed strip for the "ESP32_WS281x" library. Every pixel
+   stores a 4-bit or 8-bit index into a palette of colors pre-encoded to RMT
+   symbols, so pixel buffer is 3..8 times smaller & encoding is a copy of
+   symbol blocks
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x_Palette.h"
+
+
+/************************************************************************************/
+/*
+   ESP32_WS281x_Palette()
+
+   Constructor
+
+   NOTE:
+   - palette is allocated here, pre-encoded palette takes "bytesPerPixel * 32"
+     bytes per color: 1.5..2KB with 4-bit indexes, 24..32KB with 8-bit indexes.
+     So 8-bit indexes pay off on long strips (1000+ LEDs) only, 4-bit indexes
+     on any strip
+
+   - all palette colors are black (off) & all pixels are index 0
+
+   - RMT resources are taken by "begin()" & released by "end()" or destructor,
+     they are shared with "ESP32_WS281x" strips
+
+   - ledQnt, number of LEDs in strand
+   - dataPin, Arduino pin number which will drive the LED data in
+   - ledType, pixel type, e.g. LED_GRB
+   - bitsPerIndex, 4 for 16 colors or 8 for 256 colors
+*/
+/************************************************************************************/
+ESP32_WS281x_Palette::ESP32_WS281x_Palette(ledIndexType ledQnt, int8_t dataPin, ledPixelType ledType, uint8_t bitsPerIndex) : _isStarted(false), _pin(dataPin), _brightness(0), _numLEDs(0), _indices(NULL), _colors(NULL), _symbols(NULL)
+{
+  _wOffset = (ledType >> 6) & 0b11; //see notes in "ESP32_WS281x.h"
+  _rOffset = (ledType >> 4) & 0b11; //regarding R/G/B/W offsets
+  _gOffset = (ledType >> 2) & 0b11;
+  _bOffset = (ledType & 0b11);
+
+  _palette.bytesPerPixel = (_wOffset == _rOffset) ? 3 : 4;
+  _palette.bitsPerIndex  = (bitsPerIndex == 4) ? 4 : 8;
+
+  uint16_t paletteSize = getPaletteSize();
+
+  _colors  = (uint32_t *)calloc(paletteSize, sizeof(uint32_t));
+  _symbols = (rmt_symbol_word_t *)malloc(paletteSize * _palette.bytesPerPixel * 8 * sizeof(rmt_symbol_word_t));
+
+  _palette.symbols = _symbols;
+
+  if ((_colors == NULL) || (_symbols == NULL)) //not enough memory, "show()" does nothing
+  {
+    free(_colors);
+    free(_symbols);
+
+    _colors          = NULL;
+    _symbols         = NULL;
+    _palette.symbols = NULL;
+  }
+  else
+  {
+    for (uint16_t i = 0; i < paletteSize; i++) {encodeColor(i);}
+  }
+
+  setLength(ledQnt);
+}
+
+
+/************************************************************************************/
+/*
+   Destructor
+
+   Deallocate ESP32_WS281x_Palette object, release RMT resources, set data pin
+   back to INPUT
+*/
+/************************************************************************************/
+ESP32_WS281x_Palette::~ESP32_WS281x_Palette()
+{
+  end();
+
+  free(_indices);
+  free(_colors);
+  free(_symbols);
+}
+
+
+/************************************************************************************/
+/*
+   begin()
+
+   Configure data pin for output
+
+   NOTE:
+   - takes reference to RMT symbol buffer shared by all strips, see
+     "ESP32_WS281x::begin()"
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::begin()
+{
+  if (_isStarted != true)
+  {
+    espInit();                                      //initialize mutex
+    espAcquire(_numLEDs * _palette.bytesPerPixel);  //symbol buffer is the same as for unpacked pixels
+  }
+
+  _isStarted = true;
+
+  setPinMode(true);
+}
+
+
+/************************************************************************************/
+/*
+   end()
+
+   Release RMT resources taken by "begin()", set data pin back to INPUT
+
+   NOTE:
+   - pixel buffer & palette are kept, strip can be started again by "begin()"
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::end()
+{
+  if (_isStarted != true) {return;}
+
+  waitShow();
+  espRelease();
+  setPinMode(false);
+
+  _isStarted = false;
+}
+
+
+/************************************************************************************/
+/*
+   setPinMode()
+
+   Set data pin as OUTPUT (driven LOW) or back to INPUT
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::setPinMode(bool output)
+{
+  if (_pin < 0) {return;}
+
+  if (output == true)
+  {
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+  }
+  else
+  {
+    pinMode(_pin, INPUT);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   canShow()
+
+   Check whether a call to "show()" will start sending data immediately
+
+   NOTE:
+   - see "ESP32_WS281x::canShow()"
+*/
+/************************************************************************************/
+bool ESP32_WS281x_Palette::canShow()
+{
+  return waitShow(0);
+}
+
+
+/************************************************************************************/
+/*
+   waitShow()
+
+   Wait until previous frame (latch included) is sent
+
+   NOTE:
+   - timeoutMs, maximum waiting time in milliseconds
+
+   - return true if frame is sent, false on timeout
+*/
+/************************************************************************************/
+bool ESP32_WS281x_Palette::waitShow(uint32_t timeoutMs)
+{
+  if (_pin < 0) {return true;}
+
+  uint8_t pin = _pin;
+
+  return espWaitDone(espGetDoneBits(&pin, 1), timeoutMs);
+}
+
+
+/************************************************************************************/
+/*
+   show()
+
+   Transmit pixels to LED drivers
+
+   NOTE:
+   - every pixel is sent as its pre-encoded palette color, so encoding is one
+     "memcpy()" per pixel, see "espShowIndexed()"
+
+   - same as "ESP32_WS281x::show()" function returns as soon as frame is
+     started, see "waitShow()"
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::show()
+{
+  if ((_indices == NULL) || (_symbols == NULL) || (_pin < 0)) {return;}
+
+  espShowIndexed(_pin, _indices, _numLEDs, &_palette);
+}
+
+
+/************************************************************************************/
+/*
+   setLength()
+
+   Change the length of strip
+
+   NOTE:
+   - old pixels are deallocated & new pixels are index 0
+
+   - ledQnt, new number of LEDs, 0 releases pixel buffer
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::setLength(ledIndexType ledQnt)
+{
+  uint32_t numBytes = ((uint64_t)ledQnt * _palette.bitsPerIndex + 7) / 8;
+
+  free(_indices);
+
+  _indices = ((ledQnt != 0) && ((uint64_t)ledQnt * _palette.bytesPerPixel <= ESP_RMT_MAX_BYTES)) ? (uint8_t *)calloc(numBytes, 1) : NULL;
+  _numLEDs = (_indices != NULL) ? ledQnt : 0; //too long strip is treated as out of memory
+
+  if (_isStarted == true) {espReserve(_numLEDs * _palette.bytesPerPixel);}
+}
+
+
+/************************************************************************************/
+/*
+   getLength()
+
+   Retrieve number of LEDs in strip
+*/
+/************************************************************************************/
+const ledIndexType ESP32_WS281x_Palette::getLength()
+{
+  return _numLEDs;
+}
+
+
+/************************************************************************************/
+/*
+   getBitsPerIndex()
+
+   Retrieve size of pixel index, 4 or 8 bits
+*/
+/************************************************************************************/
+const uint8_t ESP32_WS281x_Palette::getBitsPerIndex()
+{
+  return _palette.bitsPerIndex;
+}
+
+
+/************************************************************************************/
+/*
+   getPaletteSize()
+
+   Retrieve number of palette colors, 16 or 256
+*/
+/************************************************************************************/
+const uint16_t ESP32_WS281x_Palette::getPaletteSize()
+{
+  return 1 << _palette.bitsPerIndex;
+}
+
+
+/************************************************************************************/
+/*
+   setBrightness()
+
+   Adjust output brightness
+
+   NOTE:
+   - unlike "ESP32_WS281x::setBrightness()" it's lossless, brightness is applied
+     when palette colors are pre-encoded. Whole palette is re-encoded, so it's
+     not for every frame with 8-bit indexes
+
+   - brightness, 0..255 (off to max)
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::setBrightness(uint8_t brightness)
+{
+  uint8_t newBrightness = brightness + 1; //stored as +1, e.g. 1..256
+
+  if (newBrightness == _brightness) {return;}
+
+  _brightness = newBrightness;
+
+  for (uint16_t i = 0; (_symbols != NULL) && (i < getPaletteSize()); i++) {encodeColor(i);}
+}
+
+
+/************************************************************************************/
+/*
+   getBrightness()
+
+   Retrieve the last brightness value set with "setBrightness()"
+
+   NOTE:
+   - return brightness 0..255, 255 if never set
+*/
+/************************************************************************************/
+const uint8_t ESP32_WS281x_Palette::getBrightness()
+{
+  return _brightness - 1;
+}
+
+
+/************************************************************************************/
+/*
+   encodeColor()
+
+   Pre-encode one palette color to RMT symbols
+
+   NOTE:
+   - index, palette index, must be valid
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::encodeColor(uint8_t index)
+{
+  uint32_t color = _colors[index];
+  uint16_t scale = _brightness ? _brightness : 256; //see note in "setBrightness()"
+  uint8_t  pixel[4];
+
+  pixel[_wOffset] = ((uint8_t)(color >> 24) * scale) >> 8; //store W first, overwritten by R on RGB-type strip
+  pixel[_rOffset] = ((uint8_t)(color >> 16) * scale) >> 8;
+  pixel[_gOffset] = ((uint8_t)(color >> 8)  * scale) >> 8;
+  pixel[_bOffset] = ((uint8_t)color         * scale) >> 8;
+
+  espEncodeColor(&_symbols[index * _palette.bytesPerPixel * 8], pixel, _palette.bytesPerPixel);
+}
+
+
+/************************************************************************************/
+/*
+   setPaletteColor()
+
+   Set color of one palette entry
+
+   NOTE:
+   - all pixels with this index change color on next "show()"
+
+   - index, palette index 0..15 with 4-bit indexes, 0..255 with 8-bit indexes
+   - color, 32-bit 'packed' RGB or WRGB value, see "ESP32_WS281x::setPixelColor()"
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::setPaletteColor(uint8_t index, uint32_t color)
+{
+  if ((_symbols == NULL) || (index >= getPaletteSize())) {return;}
+
+  _colors[index] = color;
+
+  encodeColor(index);
+}
+
+
+/************************************************************************************/
+/*
+   setPaletteColors()
+
+   Set colors of a run of palette entries
+
+   NOTE:
+   - index, first palette index
+   - colors, array of numOfColors 32-bit colors, see "setPaletteColor()"
+   - numOfColors, number of colors, clipped to end of palette
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::setPaletteColors(uint8_t index, const uint32_t *colors, uint16_t numOfColors)
+{
+  if (colors == NULL) {return;}
+
+  for (uint16_t i = 0; (i < numOfColors) && ((index + i) < getPaletteSize()); i++)
+  {
+    setPaletteColor(index + i, colors[i]);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   getPaletteColor()
+
+   Get color of one palette entry
+
+   NOTE:
+   - return 'packed' 32-bit RGB or WRGB value as set, brightness is not applied.
+     0 if index is out of palette
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x_Palette::getPaletteColor(uint8_t index)
+{
+  if ((_colors == NULL) || (index >= getPaletteSize())) {return 0;}
+
+  return _colors[index];
+}
+
+
+/************************************************************************************/
+/*
+   setPixelIndex()
+
+   Set palette index of one pixel
+
+   NOTE:
+   - ledIndex, pixel index starting from 0
+   - index, palette index, upper bits are ignored with 4-bit indexes
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::setPixelIndex(ledIndexType ledIndex, uint8_t index)
+{
+  if (ledIndex >= _numLEDs) {return;}
+
+  if (_palette.bitsPerIndex == 8)
+  {
+    _indices[ledIndex] = index;
+  }
+  else
+  {
+    uint8_t *p = &_indices[ledIndex >> 1];
+
+    if (ledIndex & 1) {*p = (*p & 0xF0) | (index & 0x0F);}    //low nibble, see "espShowIndexed()"
+    else              {*p = (*p & 0x0F) | (index << 4);}      //high nibble
+  }
+}
+
+
+/************************************************************************************/
+/*
+   getPixelIndex()
+
+   Get palette index of one pixel
+
+   NOTE:
+   - return palette index, 0 if ledIndex is out of bounds
+*/
+/************************************************************************************/
+const uint8_t ESP32_WS281x_Palette::getPixelIndex(ledIndexType ledIndex)
+{
+  if (ledIndex >= _numLEDs) {return 0;}
+
+  if (_palette.bitsPerIndex == 8) {return _indices[ledIndex];}
+
+  return (ledIndex & 1) ? (_indices[ledIndex >> 1] & 0x0F) : (_indices[ledIndex >> 1] >> 4);
+}
+
+
+/************************************************************************************/
+/*
+   fill()
+
+   Fill all or part of the strip with one palette index
+
+   NOTE:
+   - whole bytes are filled with "memset()", only the odd pixels at the ends
+     of run are set one by one with 4-bit indexes
+
+   - index, palette index
+   - ledIndex, index of first pixel to fill starting from 0. 0 if unspecified
+   - numOfLEDs, number of pixels to fill. Passing 0 or leaving unspecified will
+     fill to end of strip
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::fill(uint8_t index, ledIndexType ledIndex, ledIndexType numOfLEDs)
+{
+  if (ledIndex >= _numLEDs) {return;}
+
+  ledIndexType end = ((numOfLEDs == 0) || (numOfLEDs > (_numLEDs - ledIndex))) ? _numLEDs : (ledIndex + numOfLEDs); //index ONE AFTER the last pixel
+
+  if (_palette.bitsPerIndex == 8)
+  {
+    memset(&_indices[ledIndex], index, end - ledIndex);
+
+    return;
+  }
+
+  if (ledIndex & 1) {setPixelIndex(ledIndex++, index);} //odd first pixel shares byte with previous one
+  if (end & 1)      {setPixelIndex(--end, index);}      //odd last pixel shares byte with next one
+
+  if (ledIndex < end) {memset(&_indices[ledIndex >> 1], (index << 4) | (index & 0x0F), (end - ledIndex) >> 1);}
+}
+
+
+/************************************************************************************/
+/*
+   clear()
+
+   Set all pixels to palette index 0
+*/
+/************************************************************************************/
+void ESP32_WS281x_Palette::clear()
+{
+  fill(0);
+}
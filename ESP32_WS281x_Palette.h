@@ -0,0 +1,100 @@
+/***************************************************************************************************/
+/*
+   This is a palette-indexed strip for the "ESP32_WS281x" library. Every pixel
+   stores a 4-bit or 8-bit index into a palette of colors pre-encoded to RMT
+   symbols, so pixel buffer is 3..8 times smaller & encoding is a copy of
+   symbol blocks
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef ESP32_WS281x_Palette_H
+#define ESP32_WS281x_Palette_H
+
+
+#include <Arduino.h>
+
+#include "ESP32_WS281x.h"
+
+
+class ESP32_WS281x_Palette
+{
+
+  public:
+  ESP32_WS281x_Palette(ledIndexType ledQnt, int8_t dataPin, ledPixelType ledType = LED_GRB, uint8_t bitsPerIndex = 8);
+ ~ESP32_WS281x_Palette();
+  ESP32_WS281x_Palette(const ESP32_WS281x_Palette &) = delete;            //owns "_indices", "_colors" & "_symbols", copy would free them twice
+  ESP32_WS281x_Palette& operator=(const ESP32_WS281x_Palette &) = delete;
+
+  void                begin();
+  void                end();
+  bool                canShow();
+  bool                waitShow(uint32_t timeoutMs = 1000);
+  void                show();
+
+  void                setLength(ledIndexType ledQnt);
+  const  ledIndexType getLength();
+  const  uint8_t      getBitsPerIndex();
+  const  uint16_t     getPaletteSize();
+  void                setBrightness(uint8_t brightness);
+  const  uint8_t      getBrightness();
+
+  void                setPaletteColor(uint8_t index, uint32_t color);
+  void                setPaletteColors(uint8_t index, const uint32_t *colors, uint16_t numOfColors);
+  const  uint32_t     getPaletteColor(uint8_t index);
+  void                setPixelIndex(ledIndexType ledIndex, uint8_t index);
+  const  uint8_t      getPixelIndex(ledIndexType ledIndex);
+  void                fill(uint8_t index = 0, ledIndexType ledIndex = 0, ledIndexType numOfLEDs = 0);
+  void                clear();
+
+
+private:
+  void                encodeColor(uint8_t index);
+  void                setPinMode(bool output);
+
+protected:
+  bool                _isStarted;     //true if "begin()" previously called
+  int8_t              _pin;           //output pin number, -1 if not set
+  uint8_t             _brightness;    //strip brightness 0..255 (stored as +1, e.g. 1..256)
+  uint8_t             _rOffset;       //index of red byte
+  uint8_t             _gOffset;       //index of green byte
+  uint8_t             _bOffset;       //index of blue byte
+  uint8_t             _wOffset;       //index of white (==rOffset if no white)
+  ledIndexType        _numLEDs;       //number of LEDs in strip
+  uint8_t*            _indices;       //pixel buffer, 1 byte per pixel with 8-bit indexes, 2 pixels per byte (high nibble first) with 4-bit indexes
+  uint32_t*           _colors;        //packed WRGB palette colors, 2^bitsPerIndex entries
+  rmt_symbol_word_t*  _symbols;       //palette colors pre-encoded to RMT symbols, "bytesPerPixel * 8" symbols per color
+  espPalette_t        _palette;       //palette handed to "espShowIndexed()"
+};
+
+#endif
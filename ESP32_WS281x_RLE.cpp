@@ -0,0 +1,515 @@
+/***************************************************************************************************/
+/*
+   This is a run-length encoded strip for the "ESP32_WS281x" library. Strip is
+   kept as a list of runs of identical pixels & runs are encoded straight to RMT
+   memory while frame is on the wire, so mostly black status displays with few
+   lit segments need neither full-length pixel buffer nor RMT symbol buffer
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x_RLE.h"
+
+
+/************************************************************************************/
+/*
+   ESP32_WS281x_RLE()
+
+   Constructor
+
+   NOTE:
+   - every run takes 12 bytes, so strip pays off while it has fewer runs than
+     "numLEDs * bytesPerPixel / 12" (e.g. 250 runs on 1000 RGB LEDs). Frame
+     with every pixel different still works, just slower & bigger than
+     "ESP32_WS281x"
+
+   - all pixels are black (off), strip is one run
+
+   - RMT resources are taken by "begin()" & released by "end()" or destructor,
+     RMT channels are shared with "ESP32_WS281x" strips
+
+   - ledQnt, number of LEDs in strand
+   - dataPin, Arduino pin number which will drive the LED data in
+   - ledType, pixel type, e.g. LED_GRB
+*/
+/************************************************************************************/
+ESP32_WS281x_RLE::ESP32_WS281x_RLE(ledIndexType ledQnt, int8_t dataPin, ledPixelType ledType) : _isStarted(false), _pin(dataPin), _brightness(0), _numLEDs(0), _runs(NULL), _numRuns(0), _runsSize(0)
+{
+  _wOffset = (ledType >> 6) & 0b11; //see notes in "ESP32_WS281x.h"
+  _rOffset = (ledType >> 4) & 0b11; //regarding R/G/B/W offsets
+  _gOffset = (ledType >> 2) & 0b11;
+  _bOffset = (ledType & 0b11);
+
+  _encoder.lut           = NULL;
+  _encoder.bytesPerPixel = (_wOffset == _rOffset) ? 3 : 4;
+  _encoder.scale         = 256;
+  _encoder.dirtyFirst    = 0;                        //every frame is encoded, see "espShowRLE()"
+  _encoder.dirtyLast     = 0xFFFFFFFF;
+
+  setLength(ledQnt);
+}
+
+
+/************************************************************************************/
+/*
+   Destructor
+
+   Deallocate ESP32_WS281x_RLE object, release RMT resources, set data pin
+   back to INPUT
+*/
+/************************************************************************************/
+ESP32_WS281x_RLE::~ESP32_WS281x_RLE()
+{
+  end();
+
+  free(_runs);
+}
+
+
+/************************************************************************************/
+/*
+   begin()
+
+   Configure data pin for output
+
+   NOTE:
+   - takes reference to RMT resources shared by all strips, see
+     "ESP32_WS281x::begin()". RMT symbol buffer is not used by "espShowRLE()",
+     so nothing is reserved
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::begin()
+{
+  if (_isStarted != true)
+  {
+    espInit();                                     //initialize mutex
+    espAcquire(0);
+  }
+
+  _isStarted = true;
+
+  setPinMode(true);
+}
+
+
+/************************************************************************************/
+/*
+   end()
+
+   Release RMT resources taken by "begin()", set data pin back to INPUT
+
+   NOTE:
+   - runs are kept, strip can be started again by "begin()"
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::end()
+{
+  if (_isStarted != true) {return;}
+
+  waitShow();
+  espRelease();
+  setPinMode(false);
+
+  _isStarted = false;
+}
+
+
+/************************************************************************************/
+/*
+   setPinMode()
+
+   Set data pin as OUTPUT (driven LOW) or back to INPUT
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::setPinMode(bool output)
+{
+  if (_pin < 0) {return;}
+
+  if (output == true)
+  {
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+  }
+  else
+  {
+    pinMode(_pin, INPUT);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   canShow()
+
+   Check whether a call to "show()" will start sending data immediately
+
+   NOTE:
+   - see "ESP32_WS281x::canShow()"
+*/
+/************************************************************************************/
+bool ESP32_WS281x_RLE::canShow()
+{
+  return waitShow(0);
+}
+
+
+/************************************************************************************/
+/*
+   waitShow()
+
+   Wait until previous frame (latch included) is sent
+
+   NOTE:
+   - timeoutMs, maximum waiting time in milliseconds
+
+   - return true if frame is sent, false on timeout
+*/
+/************************************************************************************/
+bool ESP32_WS281x_RLE::waitShow(uint32_t timeoutMs)
+{
+  if (_pin < 0) {return true;}
+
+  uint8_t pin = _pin;
+
+  return espWaitDone(espGetDoneBits(&pin, 1), timeoutMs);
+}
+
+
+/************************************************************************************/
+/*
+   show()
+
+   Transmit pixels to LED drivers
+
+   NOTE:
+   - runs are encoded to RMT symbols while frame is on the wire, long runs
+     never touch pixel memory, see "espShowRLE()"
+
+   - same as "ESP32_WS281x::show()" function returns as soon as frame is
+     started, see "waitShow()"
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::show()
+{
+  if ((_numRuns == 0) || (_pin < 0)) {return;}
+
+  espShowRLE(_pin, _runs, _numRuns, _encoder.bytesPerPixel, &_encoder);
+}
+
+
+/************************************************************************************/
+/*
+   setLength()
+
+   Change the length of strip
+
+   NOTE:
+   - old pixels are dropped & strip becomes one black run, run buffer is kept
+
+   - ledQnt, new number of LEDs
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::setLength(ledIndexType ledQnt)
+{
+  _numRuns = 0;
+  _numLEDs = 0;
+
+  if ((ledQnt == 0) || ((uint64_t)ledQnt * _encoder.bytesPerPixel > ESP_RMT_MAX_BYTES) || (reserveRuns(1) != true)) {return;} //too long strip is treated as out of memory
+
+  memset(&_runs[0], 0, sizeof(espRun_t));
+
+  _runs[0].count = ledQnt;
+  _numRuns       = 1;
+  _numLEDs       = ledQnt;
+}
+
+
+/************************************************************************************/
+/*
+   getLength()
+
+   Retrieve number of LEDs in strip
+*/
+/************************************************************************************/
+const ledIndexType ESP32_WS281x_RLE::getLength()
+{
+  return _numLEDs;
+}
+
+
+/************************************************************************************/
+/*
+   getNumRuns()
+
+   Retrieve number of runs of identical pixels, neighbour runs always differ
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x_RLE::getNumRuns()
+{
+  return _numRuns;
+}
+
+
+/************************************************************************************/
+/*
+   setBrightness()
+
+   Adjust output brightness
+
+   NOTE:
+   - unlike "ESP32_WS281x::setBrightness()" it's lossless & costs nothing,
+     brightness is applied to runs by "espShowRLE()"
+
+   - brightness, 0..255 (off to max)
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::setBrightness(uint8_t brightness)
+{
+  _brightness    = brightness + 1;                 //stored as +1, e.g. 1..256
+  _encoder.scale = _brightness ? _brightness : 256; //255 wraps to 0, see "ESP32_WS281x::setBrightness()"
+}
+
+
+/************************************************************************************/
+/*
+   getBrightness()
+
+   Retrieve the last brightness value set with "setBrightness()"
+
+   NOTE:
+   - return brightness 0..255, 255 if never set
+*/
+/************************************************************************************/
+const uint8_t ESP32_WS281x_RLE::getBrightness()
+{
+  return _brightness - 1;
+}
+
+
+/************************************************************************************/
+/*
+   reserveRuns()
+
+   Grow run buffer to hold at least numRuns runs
+
+   NOTE:
+   - buffer grows twice at least, so painting pixel by pixel reallocates
+     rarely
+
+   - return true on success, false if out of memory (runs are kept)
+*/
+/************************************************************************************/
+bool ESP32_WS281x_RLE::reserveRuns(uint32_t numRuns)
+{
+  if (numRuns <= _runsSize) {return true;}
+
+  uint32_t  newSize = (numRuns > (_runsSize * 2)) ? numRuns : (_runsSize * 2);
+  espRun_t *newRuns = (espRun_t *)realloc(_runs, newSize * sizeof(espRun_t));
+
+  if (newRuns == NULL) {return false;}
+
+  _runs     = newRuns;
+  _runsSize = newSize;
+
+  return true;
+}
+
+
+/************************************************************************************/
+/*
+   splitRun()
+
+   Split run at the pixel, so a run starts exactly there
+
+   NOTE:
+   - run buffer must have space for one more run, see "reserveRuns()"
+
+   - ledIndex, pixel index 0.._numLEDs
+
+   - return index of run starting at ledIndex, "_numRuns" if ledIndex is
+     "_numLEDs"
+*/
+/************************************************************************************/
+uint32_t ESP32_WS281x_RLE::splitRun(ledIndexType ledIndex)
+{
+  ledIndexType start = 0;                          //first pixel of run
+
+  for (uint32_t i = 0; i < _numRuns; i++)
+  {
+    if (ledIndex == start) {return i;}
+
+    if ((ledIndex - start) < _runs[i].count)
+    {
+      memmove(&_runs[i + 1], &_runs[i], (_numRuns - i) * sizeof(espRun_t));
+
+      _runs[i].count      = ledIndex - start;
+      _runs[i + 1].count -= _runs[i].count;
+
+      _numRuns++;
+
+      return i + 1;
+    }
+
+    start += _runs[i].count;
+  }
+
+  return _numRuns;
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set pixel color from 'packed' 32-bit RGB or WRGB color
+
+   NOTE:
+   - pixel is looked up by walking runs, so cost follows number of runs, not
+     length of strip. Use "fill()" for segments
+
+   - ledIndex, pixel index starting from 0
+   - color, 32-bit 'packed' RGB or WRGB value, see "ESP32_WS281x::setPixelColor()"
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::setPixelColor(ledIndexType ledIndex, uint32_t color)
+{
+  fill(color, ledIndex, 1);
+}
+
+
+/************************************************************************************/
+/*
+   getPixelColor()
+
+   Query the color of a previously set pixel
+
+   NOTE:
+   - return 'packed' 32-bit RGB or WRGB value as set, brightness is not applied.
+     0 if ledIndex is out of bounds
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x_RLE::getPixelColor(ledIndexType ledIndex)
+{
+  ledIndexType start = 0;                          //first pixel of run
+
+  for (uint32_t i = 0; i < _numRuns; i++)
+  {
+    if ((ledIndex - start) < _runs[i].count)
+    {
+      const uint8_t *p     = _runs[i].pixel;
+      uint32_t       color = ((uint32_t)p[_rOffset] << 16) | ((uint32_t)p[_gOffset] << 8) | p[_bOffset];
+
+      if (_wOffset != _rOffset) {color |= (uint32_t)p[_wOffset] << 24;}
+
+      return color;
+    }
+
+    start += _runs[i].count;
+  }
+
+  return 0;
+}
+
+
+/************************************************************************************/
+/*
+   fill()
+
+   Fill all or part of the strip with one color
+
+   NOTE:
+   - filled pixels become one run, runs covered by it are dropped & equal
+     neighbour runs are merged, so strip never has more runs than needed
+
+   - color, 32-bit 'packed' RGB or WRGB value. 0 (black) if unspecified
+   - ledIndex, index of first pixel to fill starting from 0. 0 if unspecified
+   - numOfLEDs, number of pixels to fill. Passing 0 or leaving unspecified will
+     fill to end of strip
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::fill(uint32_t color, ledIndexType ledIndex, ledIndexType numOfLEDs)
+{
+  if (ledIndex >= _numLEDs) {return;}
+
+  ledIndexType end = ((numOfLEDs == 0) || (numOfLEDs > (_numLEDs - ledIndex))) ? _numLEDs : (ledIndex + numOfLEDs); //index ONE AFTER the last pixel
+
+  if (reserveRuns(_numRuns + 2) != true) {return;} //both ends may split a run
+
+  espRun_t run = {};
+
+  run.count           = end - ledIndex;
+  run.pixel[_wOffset] = color >> 24;               //store W first, overwritten by R on RGB-type strip
+  run.pixel[_rOffset] = color >> 16;
+  run.pixel[_gOffset] = color >> 8;
+  run.pixel[_bOffset] = color;
+
+  uint32_t first = splitRun(ledIndex);
+  uint32_t last  = splitRun(end);                  //index ONE AFTER the last covered run
+
+  _runs[first] = run;
+
+  memmove(&_runs[first + 1], &_runs[last], (_numRuns - last) * sizeof(espRun_t));
+
+  _numRuns -= last - first - 1;
+
+  if (((first + 1) < _numRuns) && (memcmp(_runs[first].pixel, _runs[first + 1].pixel, ESP_RLE_MAX_BYTES) == 0)) //merge with next run
+  {
+    _runs[first].count += _runs[first + 1].count;
+
+    memmove(&_runs[first + 1], &_runs[first + 2], (_numRuns - first - 2) * sizeof(espRun_t));
+
+    _numRuns--;
+  }
+
+  if ((first > 0) && (memcmp(_runs[first - 1].pixel, _runs[first].pixel, ESP_RLE_MAX_BYTES) == 0)) //merge with previous run
+  {
+    _runs[first - 1].count += _runs[first].count;
+
+    memmove(&_runs[first], &_runs[first + 1], (_numRuns - first - 1) * sizeof(espRun_t));
+
+    _numRuns--;
+  }
+}
+
+
+/************************************************************************************/
+/*
+   clear()
+
+   Set all pixels to black (off), strip becomes one run
+*/
+/************************************************************************************/
+void ESP32_WS281x_RLE::clear()
+{
+  fill(0);
+}
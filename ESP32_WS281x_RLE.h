@@ -0,0 +1,97 @@
+/***************************************************************************************************/
+/*
+   This is a run-length encoded strip for the "ESP32_WS281x" library. Strip is
+   kept as a list of runs of identical pixels & runs are encoded straight to RMT
+   memory while frame is on the wire, so mostly black status displays with few
+   lit segments need neither full-length pixel buffer nor RMT symbol buffer
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef ESP32_WS281x_RLE_H
+#define ESP32_WS281x_RLE_H
+
+
+#include <Arduino.h>
+
+#include "ESP32_WS281x.h"
+
+
+class ESP32_WS281x_RLE
+{
+
+  public:
+  ESP32_WS281x_RLE(ledIndexType ledQnt, int8_t dataPin, ledPixelType ledType = LED_GRB);
+ ~ESP32_WS281x_RLE();
+  ESP32_WS281x_RLE(const ESP32_WS281x_RLE &) = delete;            //owns "_runs", copy would free it twice
+  ESP32_WS281x_RLE& operator=(const ESP32_WS281x_RLE &) = delete;
+
+  void                begin();
+  void                end();
+  bool                canShow();
+  bool                waitShow(uint32_t timeoutMs = 1000);
+  void                show();
+
+  void                setLength(ledIndexType ledQnt);
+  const  ledIndexType getLength();
+  const  uint32_t     getNumRuns();
+  void                setBrightness(uint8_t brightness);
+  const  uint8_t      getBrightness();
+
+  void                setPixelColor(ledIndexType ledIndex, uint32_t color);
+  const  uint32_t     getPixelColor(ledIndexType ledIndex);
+  void                fill(uint32_t color = 0, ledIndexType ledIndex = 0, ledIndexType numOfLEDs = 0);
+  void                clear();
+
+
+private:
+  bool                reserveRuns(uint32_t numRuns);
+  uint32_t            splitRun(ledIndexType ledIndex);
+  void                setPinMode(bool output);
+
+protected:
+  bool                _isStarted;     //true if "begin()" previously called
+  int8_t              _pin;           //output pin number, -1 if not set
+  uint8_t             _brightness;    //strip brightness 0..255 (stored as +1, e.g. 1..256)
+  uint8_t             _rOffset;       //index of red byte
+  uint8_t             _gOffset;       //index of green byte
+  uint8_t             _bOffset;       //index of blue byte
+  uint8_t             _wOffset;       //index of white (==rOffset if no white)
+  ledIndexType        _numLEDs;       //number of LEDs in strip
+  espRun_t*           _runs;          //runs of pixels in strip order, colors in device order without brightness, counts add up to "_numLEDs"
+  uint32_t            _numRuns;       //number of runs in "_runs"
+  uint32_t            _runsSize;      //size of "_runs", in runs
+  espEncoder_t        _encoder;       //brightness applied by "espShowRLE()", see "setBrightness()"
+};
+
+#endif
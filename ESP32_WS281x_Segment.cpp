@@ -0,0 +1,279 @@
+/***************************************************************************************************/
+/*
+   This is a segment/view for the "ESP32_WS281x" library. Segment maps its own pixel
+   indexes to a sub-range of a parent strip with optional reversal & stride, and
+   writes straight into the parent pixel buffer
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x_Segment.h"
+
+
+/************************************************************************************/
+/*
+   ESP32_WS281x_Segment()
+
+   Constructor
+
+   NOTE:
+   - segment doesn't allocate any memory, all pixels are stored in parent strip
+     & "show()" of parent strip sends them
+
+   - strip, parent "ESP32_WS281x" strip object, must outlive the segment
+   - ledIndex, parent index of first pixel in range
+   - numOfLEDs, number of pixels in segment
+   - reverse, if true segment pixel 0 is the last pixel of the range
+   - stride, parent index step between neighbour segment pixels, e.g. 2 to
+     address every second LED
+*/
+/************************************************************************************/
+ESP32_WS281x_Segment::ESP32_WS281x_Segment(ESP32_WS281x &strip, ledIndexType ledIndex, ledIndexType numOfLEDs, bool reverse, uint16_t stride) : _strip(&strip)
+{
+  setRange(ledIndex, numOfLEDs, reverse, stride);
+}
+
+
+/************************************************************************************/
+/*
+   setRange()
+
+   Move segment to a new sub-range of the parent strip
+
+   NOTE:
+   - range is not checked against parent length, pixels past the end of the
+     parent strip are ignored by parent "setPixelColor()"
+
+   - ledIndex, parent index of first pixel in range
+   - numOfLEDs, number of pixels in segment
+   - reverse, if true segment pixel 0 is the last pixel of the range
+   - stride, parent index step between neighbour segment pixels, 0 = 1
+*/
+/************************************************************************************/
+void ESP32_WS281x_Segment::setRange(ledIndexType ledIndex, ledIndexType numOfLEDs, bool reverse, uint16_t stride)
+{
+  _first   = ledIndex;
+  _numLEDs = numOfLEDs;
+  _stride  = (stride == 0) ? 1 : stride;
+  _reverse = reverse;
+}
+
+
+/************************************************************************************/
+/*
+   getLength()
+
+   Return the number of pixels in segment
+*/
+/************************************************************************************/
+const ledIndexType ESP32_WS281x_Segment::getLength()
+{
+  return _numLEDs;
+}
+
+
+/************************************************************************************/
+/*
+   getStripIndex()
+
+   Convert segment pixel index to parent strip index
+
+   NOTE:
+   - ledIndex, segment pixel index, 0..getLength() - 1
+
+   - return parent index, LED_INDEX_NONE if ledIndex is out of segment or mapped
+     past end of index range
+*/
+/************************************************************************************/
+const ledIndexType ESP32_WS281x_Segment::getStripIndex(ledIndexType ledIndex)
+{
+  if (ledIndex >= _numLEDs) {return LED_INDEX_NONE;}
+
+  if (_reverse == true) {ledIndex = _numLEDs - 1 - ledIndex;}
+
+  uint64_t index = _first + (uint64_t)ledIndex * _stride;
+
+  return (index > LED_INDEX_NONE) ? LED_INDEX_NONE : index;
+}
+
+
+/************************************************************************************/
+/*
+   getStrip()
+
+   Return parent strip
+*/
+/************************************************************************************/
+ESP32_WS281x& ESP32_WS281x_Segment::getStrip()
+{
+  return *_strip;
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using separate R, G, B components
+
+   NOTE:
+   - see parent "setPixelColor()" for details, parent dirty range is updated
+*/
+/************************************************************************************/
+void ESP32_WS281x_Segment::setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b)
+{
+  _strip->setPixelColor(getStripIndex(ledIndex), r, g, b); //LED_INDEX_NONE is past end of any strip
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using separate R, G, B, W components (for RGBW pixels)
+
+   NOTE:
+   - see parent "setPixelColor()" for details, parent dirty range is updated
+*/
+/************************************************************************************/
+void ESP32_WS281x_Segment::setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+{
+  _strip->setPixelColor(getStripIndex(ledIndex), r, g, b, w);
+}
+
+
+/************************************************************************************/
+/*
+   setPixelColor()
+
+   Set a pixel's color using a 32-bit 'packed' RGB or RGBW value
+
+   NOTE:
+   - see parent "setPixelColor()" for details, parent dirty range is updated
+*/
+/************************************************************************************/
+void ESP32_WS281x_Segment::setPixelColor(ledIndexType ledIndex, uint32_t color)
+{
+  _strip->setPixelColor(getStripIndex(ledIndex), color);
+}
+
+
+/************************************************************************************/
+/*
+   getPixelColor()
+
+   Query the color of a previously-set pixel
+
+   NOTE:
+   - see parent "getPixelColor()" for details
+*/
+/************************************************************************************/
+const uint32_t ESP32_WS281x_Segment::getPixelColor(ledIndexType ledIndex)
+{
+  return _strip->getPixelColor(getStripIndex(ledIndex));
+}
+
+
+/************************************************************************************/
+/*
+   fill()
+
+   Fill all or part of the segment with a color
+
+   NOTE:
+   - contiguous segments (stride 1) are filled by parent "fill()" in one call,
+     order of pixels doesn't matter for a solid fill
+
+   - color, 32-bit color value
+   - ledIndex, segment index of first pixel to fill
+   - numOfLEDs, number of pixels to fill, 0 = fill to end of segment
+*/
+/************************************************************************************/
+void ESP32_WS281x_Segment::fill(uint32_t color, ledIndexType ledIndex, ledIndexType numOfLEDs)
+{
+  if (ledIndex >= _numLEDs) {return;}
+
+  if ((numOfLEDs == 0) || (numOfLEDs > (_numLEDs - ledIndex))) {numOfLEDs = _numLEDs - ledIndex;}
+
+  if (_stride == 1)
+  {
+    ledIndexType first = (_reverse == true) ? getStripIndex(ledIndex + numOfLEDs - 1) : getStripIndex(ledIndex);
+
+    if (first != LED_INDEX_NONE) {_strip->fill(color, first, numOfLEDs);}
+
+    return;
+  }
+
+  for (ledIndexType i = ledIndex; i < (ledIndex + numOfLEDs); i++)
+  {
+    setPixelColor(i, color);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   rainbow()
+
+   Fill the segment with one or more cycles of hues
+
+   NOTE:
+   - hues are spread over segment length, see parent "rainbow()" for details
+*/
+/************************************************************************************/
+void ESP32_WS281x_Segment::rainbow(uint16_t firstHue, int8_t reps, uint8_t saturation, uint8_t brightness, bool gammify)
+{
+  for (ledIndexType i = 0; i < _numLEDs; i++)
+  {
+    uint16_t hue = firstHue + ((int64_t)i * reps * 65536) / _numLEDs;
+
+    uint32_t color = ESP32_WS281x::colorHSV(hue, saturation, brightness);
+
+    if (gammify) color = ESP32_WS281x::gamma32(color);
+
+    setPixelColor(i, color);
+  }
+}
+
+
+/************************************************************************************/
+/*
+   clear()
+
+   Fill the segment with 0/black/off, pixels outside of segment are not changed
+*/
+/************************************************************************************/
+void ESP32_WS281x_Segment::clear()
+{
+  fill(0, 0, 0);
+}
@@ -0,0 +1,77 @@
+/***************************************************************************************************/
+/*
+   This is a segment/view for the "ESP32_WS281x" library. Segment maps its own pixel
+   indexes to a sub-range of a parent strip with optional reversal & stride, and
+   writes straight into the parent pixel buffer
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+   based on:    Adafruit_NeoPixel library v1.12.5
+
+   RMT (Remote Control Peripheral) channels:
+   - ESP32 has 8 RMT channels for sending & receiving infrared remote control
+     signals. Can be assign to any GPIO pins
+   - ESP32-S3 has 4 TX channels (to send) & 4 RX channels (to receive) channels for
+     infrared remote control signals. DMA access for TX mode on channel 3 & for RX
+     mode on channel 7
+
+   ESP32 strapping pins:
+   - GPIO0, internal pull-up
+   - GPIO2, internal pull-down
+   - GPIO4, internal pull-down
+   - GPIO5, internal pull-up
+   - GPIO12/MTDI, internal pull-down
+   - GPIO15/MTDO, internal pull-up
+   - GPIO0, 2, 4 & 15 cannot be used on ESP-WROVER due to external connections
+     for PSRAM chip
+   - GPIO34..39 input only pins. These pins don’t have internal pull-up or
+     pull-down resistors
+
+   Supported frameworks:
+   ESP32 Core - https://github.com/espressif/arduino-esp32
+
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef ESP32_WS281x_Segment_H
+#define ESP32_WS281x_Segment_H
+
+
+#include <Arduino.h>
+
+#include "ESP32_WS281x.h"
+
+
+class ESP32_WS281x_Segment
+{
+
+  public:
+  ESP32_WS281x_Segment(ESP32_WS281x &strip, ledIndexType ledIndex, ledIndexType numOfLEDs, bool reverse = false, uint16_t stride = 1);
+
+  void                setRange(ledIndexType ledIndex, ledIndexType numOfLEDs, bool reverse = false, uint16_t stride = 1);
+  const  ledIndexType getLength();
+  const  ledIndexType getStripIndex(ledIndexType ledIndex);
+  ESP32_WS281x&       getStrip();
+
+  void                setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b);
+  void                setPixelColor(ledIndexType ledIndex, uint8_t r, uint8_t g, uint8_t b, uint8_t w);
+  void                setPixelColor(ledIndexType ledIndex, uint32_t color);
+  const  uint32_t     getPixelColor(ledIndexType ledIndex);
+  void                fill(uint32_t color = 0, ledIndexType ledIndex = 0, ledIndexType numOfLEDs = 0);
+  void                rainbow(uint16_t firstHue = 0, int8_t reps = 1, uint8_t saturation = 255, uint8_t brightness = 255, bool gammify = true);
+  void                clear();
+
+
+protected:
+  ESP32_WS281x*       _strip;   //parent strip, owns pixel buffer
+  ledIndexType        _first;   //parent index of segment pixel 0
+  ledIndexType        _numLEDs; //number of pixels in segment
+  uint16_t            _stride;  //parent index step between neighbour segment pixels
+  bool                _reverse; //true if segment pixel 0 is the last pixel of the range
+};
+
+#endif
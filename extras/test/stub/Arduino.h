@@ -0,0 +1,108 @@
+/***************************************************************************************************/
+/*
+   Host stub of Arduino-ESP32 core for tests of the "ESP32_WS281x" library.
+   Declares only what the library uses, FreeRTOS & heap calls are
+   implemented in "stub.cpp" without allocating memory
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef STUB_ARDUINO_H
+#define STUB_ARDUINO_H
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+
+/* arduino-esp32 3.x */
+#define ESP_IDF_VERSION_VAL(major, minor, patch) (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_IDF_VERSION                          ESP_IDF_VERSION_VAL(5, 1, 0)
+
+#define IRAM_ATTR
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+
+#define log_e(...) do {} while (0)
+#define log_w(...) do {} while (0)
+#define log_d(...) do {} while (0)
+
+#define INPUT  0x01
+#define OUTPUT 0x03
+#define LOW    0x0
+#define HIGH   0x1
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+void          pinMode(uint8_t pin, uint8_t mode);
+void          digitalWrite(uint8_t pin, uint8_t val);
+unsigned long micros();
+unsigned long millis();
+void          delay(uint32_t ms);
+
+
+/* esp_err.h */
+typedef int esp_err_t;
+
+#define ESP_OK              0
+#define ESP_FAIL            -1
+#define ESP_ERR_INVALID_ARG 0x102
+
+
+/* esp_heap_caps.h */
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+void* heap_caps_malloc(size_t size, uint32_t caps);
+void  heap_caps_free(void *ptr);
+
+
+/* FreeRTOS, every call returns at once. Tasks are created but never run */
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t EventBits_t;
+typedef void*    SemaphoreHandle_t;
+typedef void*    TaskHandle_t;
+typedef void*    EventGroupHandle_t;
+typedef void   (*TaskFunction_t)(void *);
+
+#define pdTRUE                1
+#define pdFALSE               0
+#define pdPASS                1
+#define portMAX_DELAY         0xFFFFFFFF
+#define portTICK_PERIOD_MS    1
+#define pdMS_TO_TICKS(ms)     (ms)
+#define tskNO_AFFINITY        0x7FFFFFFF
+#define portYIELD_FROM_ISR(x) (void)(x)
+
+SemaphoreHandle_t  xSemaphoreCreateMutex();
+SemaphoreHandle_t  xSemaphoreCreateBinary();
+BaseType_t         xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t         xSemaphoreGive(SemaphoreHandle_t semaphore);
+void               vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+BaseType_t         xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackSize, void *param, UBaseType_t priority, TaskHandle_t *task, BaseType_t core);
+void               vTaskDelete(TaskHandle_t task);
+void               vTaskDelay(TickType_t ticks);
+uint32_t           ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+BaseType_t         xTaskNotifyGive(TaskHandle_t task);
+
+EventGroupHandle_t xEventGroupCreate();
+EventBits_t        xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits);
+EventBits_t        xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits);
+BaseType_t         xEventGroupSetBitsFromISR(EventGroupHandle_t group, EventBits_t bits, BaseType_t *woken);
+EventBits_t        xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear, BaseType_t all, TickType_t ticks);
+
+#endif
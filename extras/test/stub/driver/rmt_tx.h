@@ -0,0 +1,98 @@
+/***************************************************************************************************/
+/*
+   Host stub of ESP-IDF RMT TX driver for tests of the "ESP32_WS281x" library.
+   Channels & encoders come from fixed pools & transmitted symbols are decoded
+   back to bytes, see "stub.h"
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef STUB_RMT_TX_H
+#define STUB_RMT_TX_H
+
+
+#include <Arduino.h>
+
+
+typedef int gpio_num_t;
+
+typedef union
+{
+  struct
+  {
+    uint16_t duration0 : 15;
+    uint16_t level0    : 1;
+    uint16_t duration1 : 15;
+    uint16_t level1    : 1;
+  };
+  uint32_t val;
+} rmt_symbol_word_t;
+
+typedef enum
+{
+  RMT_ENCODING_RESET    = 0,
+  RMT_ENCODING_COMPLETE = (1 << 0),
+  RMT_ENCODING_MEM_FULL = (1 << 1)
+} rmt_encode_state_t;
+
+typedef enum {RMT_CLK_SRC_DEFAULT = 0} rmt_clock_source_t;
+
+typedef struct rmt_channel_t* rmt_channel_handle_t;
+typedef struct rmt_encoder_t  rmt_encoder_t;
+typedef rmt_encoder_t*        rmt_encoder_handle_t;
+
+struct rmt_encoder_t
+{
+  size_t    (*encode)(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primaryData, size_t dataSize, rmt_encode_state_t *retState);
+  esp_err_t (*reset)(rmt_encoder_t *encoder);
+  esp_err_t (*del)(rmt_encoder_t *encoder);
+};
+
+typedef struct
+{
+  gpio_num_t         gpio_num;
+  rmt_clock_source_t clk_src;
+  uint32_t           resolution_hz;
+  size_t             mem_block_symbols;
+  size_t             trans_queue_depth;
+  int                intr_priority;
+  struct
+  {
+    uint32_t invert_out : 1;
+    uint32_t with_dma   : 1;
+  } flags;
+} rmt_tx_channel_config_t;
+
+typedef struct {int reserved;}          rmt_copy_encoder_config_t;
+typedef struct {size_t num_symbols;}    rmt_tx_done_event_data_t;
+
+typedef bool (*rmt_tx_done_callback_t)(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *eventData, void *userCtx);
+
+typedef struct {rmt_tx_done_callback_t on_trans_done;} rmt_tx_event_callbacks_t;
+
+typedef struct
+{
+  int loop_count;
+  struct {uint32_t eot_level : 1;} flags;
+} rmt_transmit_config_t;
+
+#define __containerof(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *channel);
+esp_err_t rmt_del_channel(rmt_channel_handle_t channel);
+esp_err_t rmt_enable(rmt_channel_handle_t channel);
+esp_err_t rmt_disable(rmt_channel_handle_t channel);
+esp_err_t rmt_tx_register_event_callbacks(rmt_channel_handle_t channel, const rmt_tx_event_callbacks_t *callbacks, void *userData);
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *config, rmt_encoder_handle_t *encoder);
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder);
+esp_err_t rmt_encoder_reset(rmt_encoder_handle_t encoder);
+esp_err_t rmt_transmit(rmt_channel_handle_t channel, rmt_encoder_handle_t encoder, const void *payload, size_t payloadBytes, const rmt_transmit_config_t *config);
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t channel, int timeoutMs);
+
+#endif
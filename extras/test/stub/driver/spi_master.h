@@ -0,0 +1,75 @@
+/***************************************************************************************************/
+/*
+   Host stub of ESP-IDF SPI master driver for tests of the "ESP32_WS281x"
+   library. Last transaction is kept for the test, see "stub.h"
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef STUB_SPI_MASTER_H
+#define STUB_SPI_MASTER_H
+
+
+#include <Arduino.h>
+
+
+typedef enum {SPI1_HOST = 0, SPI2_HOST = 1, SPI3_HOST = 2} spi_host_device_t;
+
+#define SPI_DMA_CH_AUTO 3
+
+typedef struct spi_transaction_t spi_transaction_t;
+typedef void (*transaction_cb_t)(spi_transaction_t *trans);
+
+struct spi_transaction_t
+{
+  uint32_t    flags;
+  uint16_t    cmd;
+  uint64_t    addr;
+  size_t      length;
+  size_t      rxlength;
+  void*       user;
+  const void* tx_buffer;
+  void*       rx_buffer;
+};
+
+typedef struct
+{
+  int      mosi_io_num;
+  int      miso_io_num;
+  int      sclk_io_num;
+  int      quadwp_io_num;
+  int      quadhd_io_num;
+  int      max_transfer_sz;
+  uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct
+{
+  uint8_t          command_bits;
+  uint8_t          address_bits;
+  uint8_t          dummy_bits;
+  uint8_t          mode;
+  int              clock_speed_hz;
+  int              spics_io_num;
+  uint32_t         flags;
+  int              queue_size;
+  transaction_cb_t pre_cb;
+  transaction_cb_t post_cb;
+} spi_device_interface_config_t;
+
+typedef struct spi_device_t* spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *config, int dmaChannel);
+esp_err_t spi_bus_free(spi_host_device_t host);
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *config, spi_device_handle_t *device);
+esp_err_t spi_bus_remove_device(spi_device_handle_t device);
+esp_err_t spi_device_queue_trans(spi_device_handle_t device, spi_transaction_t *trans, TickType_t ticks);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t device, spi_transaction_t **trans, TickType_t ticks);
+
+#endif
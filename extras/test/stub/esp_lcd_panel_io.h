@@ -0,0 +1,58 @@
+/***************************************************************************************************/
+/*
+   Host stub of ESP-IDF i80 LCD bus driver for tests of the "ESP32_WS281x"
+   library. Last transfer is kept for the test, see "stub.h"
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef STUB_ESP_LCD_PANEL_IO_H
+#define STUB_ESP_LCD_PANEL_IO_H
+
+
+#include <Arduino.h>
+
+
+typedef enum {LCD_CLK_SRC_DEFAULT = 0} lcd_clock_source_t;
+
+typedef struct esp_lcd_i80_bus_t* esp_lcd_i80_bus_handle_t;
+typedef struct esp_lcd_panel_io_t* esp_lcd_panel_io_handle_t;
+
+typedef struct {int reserved;} esp_lcd_panel_io_event_data_t;
+
+typedef bool (*esp_lcd_panel_io_color_trans_done_cb_t)(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *eventData, void *userCtx);
+
+typedef struct
+{
+  int                dc_gpio_num;
+  int                wr_gpio_num;
+  lcd_clock_source_t clk_src;
+  int                data_gpio_nums[16];
+  size_t             bus_width;
+  size_t             max_transfer_bytes;
+} esp_lcd_i80_bus_config_t;
+
+typedef struct
+{
+  int                                    cs_gpio_num;
+  uint32_t                               pclk_hz;
+  size_t                                 trans_queue_depth;
+  esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+  void*                                  user_ctx;
+  int                                    lcd_cmd_bits;
+  int                                    lcd_param_bits;
+} esp_lcd_panel_io_i80_config_t;
+
+esp_err_t esp_lcd_new_i80_bus(const esp_lcd_i80_bus_config_t *config, esp_lcd_i80_bus_handle_t *bus);
+esp_err_t esp_lcd_del_i80_bus(esp_lcd_i80_bus_handle_t bus);
+esp_err_t esp_lcd_new_panel_io_i80(esp_lcd_i80_bus_handle_t bus, const esp_lcd_panel_io_i80_config_t *config, esp_lcd_panel_io_handle_t *io);
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io);
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int command, const void *color, size_t colorSize);
+
+#endif
@@ -0,0 +1,41 @@
+/***************************************************************************************************/
+/*
+   Host stub of ESP-IDF high resolution timer for tests of the "ESP32_WS281x"
+   library. Timers are created but never fire
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef STUB_ESP_TIMER_H
+#define STUB_ESP_TIMER_H
+
+
+#include <Arduino.h>
+
+
+typedef struct esp_timer_t* esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef enum {ESP_TIMER_TASK = 0} esp_timer_dispatch_t;
+
+typedef struct
+{
+  esp_timer_cb_t       callback;
+  void*                arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char*          name;
+  bool                 skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *timer);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+#endif
@@ -0,0 +1,2 @@
+/* event group API is declared by stub "Arduino.h" */
+#include <Arduino.h>
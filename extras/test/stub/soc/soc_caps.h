@@ -0,0 +1,3 @@
+/* ESP32-S3, has i80 bus for I2S/LCD output, see "ESP32_I2S.cpp" */
+#define SOC_RMT_MEM_WORDS_PER_CHANNEL 48
+#define SOC_LCD_I80_SUPPORTED         1
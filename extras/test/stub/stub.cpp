@@ -0,0 +1,630 @@
+/***************************************************************************************************/
+/*
+   Host stubs of Arduino-ESP32 core & ESP-IDF drivers for tests of the
+   "ESP32_WS281x" library
+
+   NOTE:
+   - nothing here allocates memory, channels, encoders & devices come from
+     fixed pools. So allocator calls seen by a test are made by the library
+
+   - "malloc()", "calloc()", "realloc()" & "free()" of glibc are wrapped to
+     count calls, see "stubAllocs()". Channels, encoders & devices are
+     counted too, ESP-IDF allocates them on the heap
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include <Arduino.h>
+#include <driver/rmt_tx.h>
+#include <driver/spi_master.h>
+#include <esp_lcd_panel_io.h>
+#include <esp_timer.h>
+
+#include "stub.h"
+
+
+/************************************************************************************/
+/*
+   Local defines & variables
+*/
+/************************************************************************************/
+#define STUB_RMT_CHANNELS 8  //TX channels of ESP32
+#define STUB_RMT_ENCODERS 16 //copy encoders, 1 per channel + 1 per RLE encoder
+
+struct rmt_channel_t
+{
+  bool                   used;
+  bool                   enabled;
+  bool                   pending;      //transaction started & not done yet
+  int                    pin;
+  size_t                 memSize;      //RMT memory, in symbols
+  size_t                 memFill;      //symbols written by encoder
+  rmt_symbol_word_t      mem[64];
+  rmt_tx_done_callback_t callback;
+  void*                  userCtx;
+};
+
+typedef struct
+{
+  rmt_encoder_t base;
+  bool          used;
+  size_t        sent;                  //symbols copied, encoding resumes here after "RMT_ENCODING_MEM_FULL"
+} stubCopyEncoder_t;
+
+struct spi_device_t
+{
+  bool                          used;
+  int                           pin;
+  int                           maxSize;
+  spi_device_interface_config_t config;
+  spi_transaction_t*            pending; //queued transaction, NULL if none
+  spi_transaction_t*            result;  //done transaction, NULL if none
+};
+
+struct esp_lcd_i80_bus_t
+{
+  bool                     used;
+  esp_lcd_i80_bus_config_t config;
+};
+
+struct esp_lcd_panel_io_t
+{
+  bool                          used;
+  bool                          pending;
+  esp_lcd_i80_bus_t*            bus;
+  esp_lcd_panel_io_i80_config_t config;
+};
+
+static unsigned long     _micros = 0;
+static bool              _defer  = false;
+static uint32_t          _errors = 0;
+static uint32_t          _allocs = 0;
+static EventBits_t       _bits   = 0;
+
+static rmt_channel_t     _rmtChannels[STUB_RMT_CHANNELS];
+static stubCopyEncoder_t _rmtEncoders[STUB_RMT_ENCODERS];
+static uint8_t           _rmtFrames[STUB_MAX_PINS][STUB_MAX_BYTES];
+static uint32_t          _rmtBits[STUB_MAX_PINS];
+static bool              _rmtSent[STUB_MAX_PINS];
+
+static bool              _spiHosts[3];
+static spi_bus_config_t  _spiBuses[3];
+static spi_device_t      _spiDevices[3];
+static const uint8_t*    _spiFrame      = NULL;
+static uint32_t          _spiFrameBytes = 0;
+static uint32_t          _spiClockHz    = 0;
+
+static esp_lcd_i80_bus_t  _lcdBus;
+static esp_lcd_panel_io_t _lcdIo;
+static const uint8_t*     _lcdFrame      = NULL;
+static uint32_t           _lcdFrameBytes = 0;
+static esp_lcd_i80_bus_config_t _lcdConfig;
+
+
+/************************************************************************************/
+/*
+   Allocator
+*/
+/************************************************************************************/
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t num, size_t size);
+extern "C" void* __libc_realloc(void *ptr, size_t size);
+extern "C" void  __libc_free(void *ptr);
+
+extern "C" void* malloc(size_t size) noexcept             {_allocs++; return __libc_malloc(size);}
+extern "C" void* calloc(size_t num, size_t size) noexcept {_allocs++; return __libc_calloc(num, size);}
+extern "C" void* realloc(void *ptr, size_t size) noexcept {_allocs++; return __libc_realloc(ptr, size);}
+extern "C" void  free(void *ptr) noexcept                 {_allocs++; __libc_free(ptr);}
+
+
+/************************************************************************************/
+/*
+   Arduino core
+*/
+/************************************************************************************/
+void          pinMode(uint8_t pin, uint8_t mode)    {}
+void          digitalWrite(uint8_t pin, uint8_t val) {}
+unsigned long micros()                               {return _micros += 10;}
+unsigned long millis()                               {return micros() / 1000;}
+void          delay(uint32_t ms)                     {_micros += ms * 1000;}
+
+void* heap_caps_malloc(size_t size, uint32_t caps)   {return malloc(size);}
+void  heap_caps_free(void *ptr)                      {free(ptr);}
+
+
+/************************************************************************************/
+/*
+   FreeRTOS
+*/
+/************************************************************************************/
+SemaphoreHandle_t xSemaphoreCreateMutex()                                  {return (SemaphoreHandle_t)1;}
+SemaphoreHandle_t xSemaphoreCreateBinary()                                 {return (SemaphoreHandle_t)1;}
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {return pdTRUE;}
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t semaphore)              {return pdTRUE;}
+void              vSemaphoreDelete(SemaphoreHandle_t semaphore)            {}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stackSize, void *param, UBaseType_t priority, TaskHandle_t *task, BaseType_t core)
+{
+  *task = (TaskHandle_t)1;                           //task never runs
+
+  return pdPASS;
+}
+
+void       vTaskDelete(TaskHandle_t task)                 {}
+void       vTaskDelay(TickType_t ticks)                   {_micros += ticks * 1000;}
+uint32_t   ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {return 0;}
+BaseType_t xTaskNotifyGive(TaskHandle_t task)             {return pdPASS;}
+
+EventGroupHandle_t xEventGroupCreate()                                              {return (EventGroupHandle_t)1;}
+EventBits_t        xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)   {return _bits |= bits;}
+EventBits_t        xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {EventBits_t old = _bits; _bits &= ~bits; return old;}
+
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t group, EventBits_t bits, BaseType_t *woken)
+{
+  _bits |= bits;
+  *woken = pdFALSE;
+
+  return pdPASS;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear, BaseType_t all, TickType_t ticks)
+{
+  bool ready = (all == pdTRUE) ? ((_bits & bits) == bits) : ((_bits & bits) != 0);
+
+  if ((ready != true) && (ticks > 0)) {stubComplete();} //blocking wait, pending transfers end
+
+  EventBits_t result = _bits;
+
+  if (clear == pdTRUE) {_bits &= ~bits;}
+
+  return result;
+}
+
+
+/************************************************************************************/
+/*
+   esp_timer
+*/
+/************************************************************************************/
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *timer) {*timer = (esp_timer_handle_t)1; return ESP_OK;}
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)             {return ESP_OK;}
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)                                        {return ESP_OK;}
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)                                      {return ESP_OK;}
+
+
+/************************************************************************************/
+/*
+   RMT TX
+
+   NOTE:
+   - symbols are decoded with 10MHz resolution of "espAttachSlot()", bit 0 =
+     400ns high + 800ns low, bit 1 = 800ns high + 400ns low, latch is low
+*/
+/************************************************************************************/
+static void stubRmtDecode(rmt_channel_t *channel)
+{
+  uint8_t pin = channel->pin;
+
+  for (size_t i = 0; i < channel->memFill; i++)
+  {
+    rmt_symbol_word_t symbol = channel->mem[i];
+
+    if ((symbol.level0 == 0) && (symbol.level1 == 0)) {continue;} //latch
+
+    if ((symbol.level0 != 1) || (symbol.level1 != 0) || ((symbol.duration0 + symbol.duration1) != 12) || ((symbol.duration0 != 4) && (symbol.duration0 != 8)))
+    {
+      _errors++;
+
+      continue;
+    }
+
+    uint32_t bit = _rmtBits[pin]++;
+
+    if ((bit / 8) >= STUB_MAX_BYTES) {_errors++; continue;}
+
+    if ((bit % 8) == 0) {_rmtFrames[pin][bit / 8] = 0;}
+
+    if (symbol.duration0 == 8) {_rmtFrames[pin][bit / 8] |= 0x80 >> (bit % 8);}
+  }
+
+  channel->memFill = 0;                              //memory is sent
+}
+
+static size_t stubCopyEncode(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primaryData, size_t dataSize, rmt_encode_state_t *retState)
+{
+  stubCopyEncoder_t       *copy    = __containerof(encoder, stubCopyEncoder_t, base);
+  const rmt_symbol_word_t *symbols = (const rmt_symbol_word_t *)primaryData;
+  size_t                   total   = dataSize / sizeof(rmt_symbol_word_t);
+  size_t                   encoded = 0;
+  int                      state   = RMT_ENCODING_RESET;
+
+  while ((copy->sent < total) && (channel->memFill < channel->memSize))
+  {
+    channel->mem[channel->memFill++] = symbols[copy->sent++];
+    encoded++;
+  }
+
+  if (copy->sent >= total)
+  {
+    copy->sent = 0;
+    state     |= RMT_ENCODING_COMPLETE;
+  }
+
+  if (channel->memFill >= channel->memSize) {state |= RMT_ENCODING_MEM_FULL;}
+
+  *retState = (rmt_encode_state_t)state;
+
+  return encoded;
+}
+
+static esp_err_t stubCopyReset(rmt_encoder_t *encoder)
+{
+  __containerof(encoder, stubCopyEncoder_t, base)->sent = 0;
+
+  return ESP_OK;
+}
+
+static esp_err_t stubCopyDelete(rmt_encoder_t *encoder)
+{
+  __containerof(encoder, stubCopyEncoder_t, base)->used = false;
+
+  return ESP_OK;
+}
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *channel)
+{
+  _allocs++;
+
+  for (uint8_t i = 0; i < STUB_RMT_CHANNELS; i++)
+  {
+    if (_rmtChannels[i].used == true) {continue;}
+
+    memset(&_rmtChannels[i], 0, sizeof(rmt_channel_t));
+
+    _rmtChannels[i].used    = true;
+    _rmtChannels[i].pin     = config->gpio_num;
+    _rmtChannels[i].memSize = (config->mem_block_symbols < 64) ? config->mem_block_symbols : 64;
+
+    *channel = &_rmtChannels[i];
+
+    return ESP_OK;
+  }
+
+  return ESP_FAIL;                                   //all channels are in use
+}
+
+esp_err_t rmt_del_channel(rmt_channel_handle_t channel)
+{
+  _allocs++;
+
+  if ((channel->enabled == true) || (channel->pending == true)) {_errors++;}
+
+  channel->used = false;
+
+  return ESP_OK;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t channel)  {channel->enabled = true;  return ESP_OK;}
+esp_err_t rmt_disable(rmt_channel_handle_t channel) {channel->enabled = false; return ESP_OK;}
+
+esp_err_t rmt_tx_register_event_callbacks(rmt_channel_handle_t channel, const rmt_tx_event_callbacks_t *callbacks, void *userData)
+{
+  channel->callback = callbacks->on_trans_done;
+  channel->userCtx  = userData;
+
+  return ESP_OK;
+}
+
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *config, rmt_encoder_handle_t *encoder)
+{
+  _allocs++;
+
+  for (uint8_t i = 0; i < STUB_RMT_ENCODERS; i++)
+  {
+    if (_rmtEncoders[i].used == true) {continue;}
+
+    _rmtEncoders[i].used        = true;
+    _rmtEncoders[i].sent        = 0;
+    _rmtEncoders[i].base.encode = stubCopyEncode;
+    _rmtEncoders[i].base.reset  = stubCopyReset;
+    _rmtEncoders[i].base.del    = stubCopyDelete;
+
+    *encoder = &_rmtEncoders[i].base;
+
+    return ESP_OK;
+  }
+
+  return ESP_FAIL;
+}
+
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder)   {_allocs++; return encoder->del(encoder);}
+esp_err_t rmt_encoder_reset(rmt_encoder_handle_t encoder) {return encoder->reset(encoder);}
+
+esp_err_t rmt_transmit(rmt_channel_handle_t channel, rmt_encoder_handle_t encoder, const void *payload, size_t payloadBytes, const rmt_transmit_config_t *config)
+{
+  if ((channel->enabled != true) || (channel->pending == true) || (channel->pin >= STUB_MAX_PINS)) {_errors++; return ESP_FAIL;}
+
+  _rmtBits[channel->pin] = 0;
+  _rmtSent[channel->pin] = true;
+  channel->memFill       = 0;
+
+  rmt_encoder_reset(encoder);
+
+  for (;;)                                           //RMT memory is sent & refilled until encoder completes
+  {
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+
+    encoder->encode(encoder, channel, payload, payloadBytes, &state);
+
+    stubRmtDecode(channel);
+
+    if (state & RMT_ENCODING_COMPLETE) {break;}
+
+    if ((state & RMT_ENCODING_MEM_FULL) == 0) {_errors++; break;} //encoder stopped without reason
+  }
+
+  channel->pending = true;
+
+  if (_defer != true) {stubComplete();}
+
+  return ESP_OK;
+}
+
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t channel, int timeoutMs)
+{
+  if (channel->pending == true) {stubComplete();}
+
+  return ESP_OK;
+}
+
+
+/************************************************************************************/
+/*
+   SPI master
+*/
+/************************************************************************************/
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *config, int dmaChannel)
+{
+  _allocs++;
+
+  if (_spiHosts[host] == true) {return ESP_FAIL;}
+
+  _spiHosts[host] = true;
+  _spiBuses[host] = *config;
+
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host)
+{
+  _allocs++;
+
+  if ((_spiHosts[host] != true) || (_spiDevices[host].used == true)) {_errors++;}
+
+  _spiHosts[host] = false;
+
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *config, spi_device_handle_t *device)
+{
+  _allocs++;
+
+  if ((_spiHosts[host] != true) || (_spiDevices[host].used == true)) {return ESP_FAIL;}
+
+  _spiDevices[host].used    = true;
+  _spiDevices[host].pin     = _spiBuses[host].mosi_io_num;
+  _spiDevices[host].maxSize = _spiBuses[host].max_transfer_sz;
+  _spiDevices[host].config  = *config;
+  _spiDevices[host].pending = NULL;
+  _spiDevices[host].result  = NULL;
+
+  *device = &_spiDevices[host];
+
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t device)
+{
+  _allocs++;
+
+  if ((device->pending != NULL) || (device->result != NULL)) {_errors++;} //result must be taken first
+
+  device->used = false;
+
+  return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t device, spi_transaction_t *trans, TickType_t ticks)
+{
+  if ((device->pending != NULL) || (device->result != NULL)) {return ESP_FAIL;} //queue of 1
+  if ((int)(trans->length / 8) > device->maxSize)           {return ESP_FAIL;}
+
+  _spiFrame       = (const uint8_t *)trans->tx_buffer;
+  _spiFrameBytes  = trans->length / 8;
+  _spiClockHz     = device->config.clock_speed_hz;
+  device->pending = trans;
+
+  if (_defer != true) {stubComplete();}
+
+  return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t device, spi_transaction_t **trans, TickType_t ticks)
+{
+  if (device->result == NULL) {return ESP_FAIL;}     //ESP_ERR_TIMEOUT
+
+  *trans         = device->result;
+  device->result = NULL;
+
+  return ESP_OK;
+}
+
+
+/************************************************************************************/
+/*
+   i80 LCD bus
+*/
+/************************************************************************************/
+esp_err_t esp_lcd_new_i80_bus(const esp_lcd_i80_bus_config_t *config, esp_lcd_i80_bus_handle_t *bus)
+{
+  _allocs++;
+
+  if (_lcdBus.used == true) {return ESP_FAIL;}
+
+  if ((config->wr_gpio_num < 0) || (config->dc_gpio_num < 0)) {return ESP_ERR_INVALID_ARG;} //IDF 5.1 routes every signal
+
+  for (size_t i = 0; i < config->bus_width; i++)
+  {
+    if (config->data_gpio_nums[i] < 0) {return ESP_ERR_INVALID_ARG;}
+  }
+
+  _lcdBus.used   = true;
+  _lcdBus.config = *config;
+
+  *bus = &_lcdBus;
+
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_del_i80_bus(esp_lcd_i80_bus_handle_t bus)
+{
+  _allocs++;
+
+  if (_lcdIo.used == true) {_errors++;}
+
+  bus->used = false;
+
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_i80(esp_lcd_i80_bus_handle_t bus, const esp_lcd_panel_io_i80_config_t *config, esp_lcd_panel_io_handle_t *io)
+{
+  _allocs++;
+
+  if (_lcdIo.used == true) {return ESP_FAIL;}
+
+  _lcdIo.used    = true;
+  _lcdIo.pending = false;
+  _lcdIo.bus     = bus;
+  _lcdIo.config  = *config;
+
+  *io = &_lcdIo;
+
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_del(esp_lcd_panel_io_handle_t io)
+{
+  _allocs++;
+
+  if (io->pending == true) {_errors++;}
+
+  io->used = false;
+
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int command, const void *color, size_t colorSize)
+{
+  if ((io->pending == true) || (colorSize > io->bus->config.max_transfer_bytes)) {_errors++; return ESP_FAIL;}
+
+  _lcdFrame      = (const uint8_t *)color;
+  _lcdFrameBytes = colorSize;
+  _lcdConfig     = io->bus->config;
+  io->pending    = true;
+
+  if (_defer != true) {stubComplete();}
+
+  return ESP_OK;
+}
+
+
+/************************************************************************************/
+/*
+   Test side, see "stub.h"
+*/
+/************************************************************************************/
+const uint8_t* stubRmtFrame(uint8_t pin, uint32_t *numBytes)
+{
+  if ((pin >= STUB_MAX_PINS) || (_rmtSent[pin] != true)) {return NULL;}
+
+  *numBytes = (_rmtBits[pin] + 7) / 8;
+
+  return _rmtFrames[pin];
+}
+
+const uint8_t* stubSpiFrame(uint32_t *numBytes, uint32_t *clockHz)
+{
+  *numBytes = _spiFrameBytes;
+  *clockHz  = _spiClockHz;
+
+  return _spiFrame;
+}
+
+const uint8_t* stubLcdFrame(uint32_t *numBytes, uint8_t *busWidth, const int **pins)
+{
+  *numBytes = _lcdFrameBytes;
+  *busWidth = _lcdConfig.bus_width;
+  *pins     = _lcdConfig.data_gpio_nums;
+
+  return _lcdFrame;
+}
+
+void stubSetDefer(bool defer)
+{
+  _defer = defer;
+}
+
+void stubComplete()
+{
+  for (uint8_t i = 0; i < STUB_RMT_CHANNELS; i++)
+  {
+    rmt_channel_t *channel = &_rmtChannels[i];
+
+    if ((channel->used != true) || (channel->pending != true)) {continue;}
+
+    rmt_tx_done_event_data_t eventData = {};
+
+    channel->pending = false;
+
+    if (channel->callback != NULL) {channel->callback(channel, &eventData, channel->userCtx);}
+  }
+
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    spi_device_t *device = &_spiDevices[i];
+
+    if ((device->used != true) || (device->pending == NULL)) {continue;}
+
+    device->result  = device->pending;
+    device->pending = NULL;
+
+    if (device->config.post_cb != NULL) {device->config.post_cb(device->result);}
+  }
+
+  if ((_lcdIo.used == true) && (_lcdIo.pending == true))
+  {
+    esp_lcd_panel_io_event_data_t eventData = {};
+
+    _lcdIo.pending = false;
+
+    if (_lcdIo.config.on_color_trans_done != NULL) {_lcdIo.config.on_color_trans_done(&_lcdIo, &eventData, _lcdIo.config.user_ctx);}
+  }
+}
+
+uint32_t stubErrors()
+{
+  return _errors;
+}
+
+uint32_t stubAllocs()
+{
+  return _allocs;
+}
@@ -0,0 +1,76 @@
+/***************************************************************************************************/
+/*
+   Test side of host stubs of the "ESP32_WS281x" library, gives access to
+   frames seen by stub drivers
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef STUB_H
+#define STUB_H
+
+
+#include <Arduino.h>
+
+
+#define STUB_MAX_PINS  49   //GPIO0..48
+#define STUB_MAX_BYTES 8192 //longest RMT frame kept per pin, in bytes
+
+
+/*
+   RMT frame, bytes decoded from symbols of last "rmt_transmit()" of the pin
+
+   NOTE:
+   - numBytes, returned number of bytes, last byte is complete only if number
+     of bits is multiple of 8
+   - return NULL if nothing was sent to the pin
+*/
+const uint8_t* stubRmtFrame(uint8_t pin, uint32_t *numBytes);
+
+
+/*
+   SPI frame, raw bitstream of last "spi_device_queue_trans()", MSB first
+
+   NOTE:
+   - clockHz, returned SPI clock of device
+*/
+const uint8_t* stubSpiFrame(uint32_t *numBytes, uint32_t *clockHz);
+
+
+/*
+   I2S/LCD frame, raw bus words of last "esp_lcd_panel_io_tx_color()"
+
+   NOTE:
+   - busWidth, returned bus width 8 or 16
+   - pins, returned data pin of every bus line, unused lines share D/C pin
+*/
+const uint8_t* stubLcdFrame(uint32_t *numBytes, uint8_t *busWidth, const int **pins);
+
+
+/*
+   Transfers are done at once by default. With defer = true they stay pending
+   until "stubComplete()" or blocking wait on "transaction done" bits
+*/
+void     stubSetDefer(bool defer);
+void     stubComplete();
+
+
+/*
+   Number of driver misuses (e.g. transmit on busy channel, malformed symbol)
+*/
+uint32_t stubErrors();
+
+
+/*
+   Number of allocator calls so far, "free(NULL)" included. Creation &
+   deletion of RMT channels & encoders count as well
+*/
+uint32_t stubAllocs();
+
+#endif
@@ -0,0 +1,85 @@
+/***************************************************************************************************/
+/*
+   Minimal checks & timing for host tests of the "ESP32_WS281x" library
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#ifndef TEST_H
+#define TEST_H
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+static unsigned int testFailures = 0;
+
+#define CHECK(cond) do {if (!(cond)) {printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); testFailures++;}} while (0)
+
+
+/*
+   Pseudo-random numbers (xorshift32), same sequence on every run
+*/
+static inline uint32_t testRandom()
+{
+  static uint32_t state = 2463534242UL;
+
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+
+  return state;
+}
+
+
+/*
+   Monotonic time, in seconds
+*/
+static inline double testSeconds()
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+/*
+   True if test was started as "<test> bench", benchmarks run only then
+*/
+static inline bool testBench(int argc, char **argv)
+{
+  return (argc > 1) && (strcmp(argv[1], "bench") == 0);
+}
+
+
+/*
+   Print benchmark result, bytes processed in seconds
+*/
+static inline void testReport(const char *name, double bytes, double seconds)
+{
+  printf("%-40s %9.1f MB/s\n", name, bytes / seconds / 1e6);
+}
+
+
+/*
+   Print summary, return exit code
+*/
+static inline int testDone(const char *name)
+{
+  printf("%s: %s\n", name, (testFailures == 0) ? "OK" : "FAILED");
+
+  return (testFailures == 0) ? 0 : 1;
+}
+
+#endif
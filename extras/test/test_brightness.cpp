@@ -0,0 +1,235 @@
+/***************************************************************************************************/
+/*
+   Host test of brightness re-scale & read back, see "ESP32_WS281x::setBrightness()"
+
+   NOTE:
+   - strip is checked against a model made of the per-byte formulas of
+     "setBrightness()" & "getPixelColor()" with results saturated at 255.
+     "bench" argument times brightness change & full read back
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN 5
+
+enum {TEST_PLAIN, TEST_DITHERED, TEST_TRIPLE};
+
+
+/*
+   Per-byte model of strip buffers, "hi" is 16-bit working buffer of dithered
+   strip
+*/
+typedef struct
+{
+  uint8_t  brightness; //stored as +1, 0 = 256
+  uint8_t  bytes[100 * 4];
+  uint16_t hi[100 * 4];
+} model_t;
+
+
+static uint32_t saturate(uint32_t value, uint32_t max)
+{
+  return (value > max) ? max : value;
+}
+
+
+static void modelSet(model_t &model, uint32_t i, uint8_t value, bool dithered)
+{
+  uint16_t scale = model.brightness ? model.brightness : 256;
+
+  model.hi[i]    = (value * scale) + ((value * scale) >> 8); //8.8 stretched to 16 bits, 255 -> 0xFFFF
+  model.bytes[i] = dithered ? (model.hi[i] >> 8) : ((value * scale) >> 8);
+}
+
+
+static void modelBrightness(model_t &model, uint32_t numBytes, uint8_t brightness, bool dithered)
+{
+  uint8_t  newBrightness = brightness + 1;
+  uint8_t  oldBrightness = model.brightness - 1;
+  uint16_t scale         = 0;
+
+  if (newBrightness == model.brightness) {return;}
+
+  if      (oldBrightness == 0) {scale = 0;}
+  else if (brightness == 255)  {scale = 65535 / oldBrightness;}
+  else                         {scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;}
+
+  for (uint32_t i = 0; i < numBytes; i++)
+  {
+    if (dithered)
+    {
+      model.hi[i]    = saturate(((uint32_t)model.hi[i] * scale) >> 8, 0xFFFF);
+      model.bytes[i] = model.hi[i] >> 8;
+    }
+    else
+    {
+      model.bytes[i] = saturate(((uint32_t)model.bytes[i] * scale) >> 8, 255);
+    }
+  }
+
+  model.brightness = newBrightness;
+}
+
+
+static uint8_t modelGet(const model_t &model, uint32_t i, bool dithered)
+{
+  uint16_t scale = model.brightness ? model.brightness : 256;
+
+  if (dithered) {return saturate(model.hi[i] / scale, 255);}
+
+  return saturate(((uint32_t)model.bytes[i] << 8) / scale, 255);
+}
+
+
+/*
+   Random mix of writes, brightness changes & commits
+*/
+static void testBrightness(ledPixelType ledType, uint8_t bytesPerPixel, uint8_t mode)
+{
+  const uint16_t numLEDs  = 100;
+  uint32_t       numBytes = numLEDs * bytesPerPixel;
+  bool           dithered = (mode == TEST_DITHERED);
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, ledType);
+  static model_t model;
+
+  memset(&model, 0, sizeof(model));
+
+  if (dithered)            {CHECK(strip.setDithering(true) == true);}
+  if (mode == TEST_TRIPLE) {CHECK(strip.setTripleBuffering(true) == true);}
+
+  strip.begin();
+
+  for (uint32_t n = 0; n < 20000; n++)
+  {
+    uint8_t op = testRandom() % 16;
+
+    if (op == 0)
+    {
+      uint8_t brightness = testRandom();
+
+      if ((testRandom() % 4) == 0) {brightness = (testRandom() & 1) ? 255 : 0;} //ends of range
+
+      strip.setBrightness(brightness);
+      modelBrightness(model, numBytes, brightness, dithered);
+    }
+    else if ((op == 1) && (mode == TEST_TRIPLE))
+    {
+      strip.commit(true);                            //drawing frame keeps its content
+    }
+    else
+    {
+      uint16_t ledIndex = testRandom() % numLEDs;
+      uint32_t color    = testRandom();
+      uint8_t  r        = color >> 16;
+      uint8_t  g        = color >> 8;
+      uint8_t  b        = color;
+      uint8_t  w        = color >> 24;
+
+      strip.setPixelColor(ledIndex, r, g, b, w);
+
+      modelSet(model, ledIndex * bytesPerPixel + 1, r, dithered); //GRB & GRBW
+      modelSet(model, ledIndex * bytesPerPixel + 0, g, dithered);
+      modelSet(model, ledIndex * bytesPerPixel + 2, b, dithered);
+
+      if (bytesPerPixel == 4) {modelSet(model, ledIndex * bytesPerPixel + 3, w, dithered);}
+    }
+
+    if ((n % 100) != 0) {continue;}
+
+    bool equal = (memcmp(strip.getRibbonColor(), model.bytes, numBytes) == 0);
+
+    for (uint16_t i = 0; equal && (i < numLEDs); i++)
+    {
+      uint32_t color = ((uint32_t)modelGet(model, i * bytesPerPixel + 1, dithered) << 16) |
+                       ((uint32_t)modelGet(model, i * bytesPerPixel + 0, dithered) << 8)  |
+                        (uint32_t)modelGet(model, i * bytesPerPixel + 2, dithered);
+
+      if (bytesPerPixel == 4) {color |= (uint32_t)modelGet(model, i * bytesPerPixel + 3, dithered) << 24;}
+
+      equal &= (strip.getPixelColor(i) == color);
+    }
+
+    if (equal != true) {CHECK(equal); break;}
+  }
+
+  strip.end();
+}
+
+
+/*
+   Read back of value too big for current brightness saturates
+*/
+static void testSaturate()
+{
+  ESP32_WS281x strip(1, TEST_PIN, LED_GRB);
+
+  strip.begin();
+  strip.setBrightness(99);                           //scale 100
+  strip.setPixelColor(0, 0x000000);
+
+  ((uint8_t *)strip.getRibbonColor())[0] = 200;      //green, 200 * 256 / 100 > 255
+
+  CHECK(strip.getPixelColor(0) == 0x00FF00);
+
+  strip.setPixelColor(0, 0xFFFFFF);
+  strip.setBrightness(255);                          //scale up from 100
+
+  CHECK(strip.getRibbonColor()[0] == 255);
+
+  strip.end();
+}
+
+
+static void benchBrightness()
+{
+  const uint16_t numLEDs = 30000;
+  const uint16_t rounds  = 200;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+  uint32_t       sum     = 0;
+
+  for (uint16_t i = 0; i < numLEDs; i++) {strip.setPixelColor(i, testRandom());}
+
+  double start = testSeconds();
+
+  for (uint16_t r = 0; r < rounds; r++)
+  {
+    strip.setBrightness(100 + (r & 1) * 50);
+
+    for (uint16_t i = 0; i < numLEDs; i++) {sum += strip.getPixelColor(i);}
+  }
+
+  testReport("setBrightness() & read back 30000 LEDs", (double)numLEDs * 3 * rounds, testSeconds() - start);
+
+  if (sum == 0) {printf("\n");}                      //keep read back from being optimized away
+}
+
+
+int main(int argc, char **argv)
+{
+  testBrightness(LED_GRB,  3, TEST_PLAIN);
+  testBrightness(LED_GRBW, 4, TEST_PLAIN);
+  testBrightness(LED_GRB,  3, TEST_DITHERED);
+  testBrightness(LED_GRBW, 4, TEST_DITHERED);
+  testBrightness(LED_GRB,  3, TEST_TRIPLE);
+  testBrightness(LED_GRBW, 4, TEST_TRIPLE);
+  testSaturate();
+
+  if (testBench(argc, argv) == true)
+  {
+    benchBrightness();
+  }
+
+  return testDone("test_brightness");
+}
@@ -0,0 +1,163 @@
+/***************************************************************************************************/
+/*
+   Host test of RMT encoder cache, see "espSetCache()"
+
+   NOTE:
+   - wire bytes with cache on must equal wire bytes with cache off, hit/miss
+     counters must match content of the frame
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN 5
+
+
+/*
+   Send frame with cache off & on, return true if wire bytes are equal
+*/
+static bool sameWire(ESP32_WS281x &strip)
+{
+  static uint8_t wire[1000 * 5];
+  uint32_t       numBytes    = 0;
+  uint32_t       cachedBytes = 0;
+  const uint8_t *frame       = NULL;
+
+  espSetCache(false);
+  strip.setDirtyRange(0, strip.getLength() - 1);
+  strip.show();
+
+  if ((frame = stubRmtFrame(TEST_PIN, &numBytes)) == NULL) {return false;}
+
+  memcpy(wire, frame, numBytes);
+
+  espSetCache(true);
+  strip.setDirtyRange(0, strip.getLength() - 1);
+  strip.show();
+
+  if ((frame = stubRmtFrame(TEST_PIN, &cachedBytes)) == NULL) {return false;}
+
+  return (numBytes == cachedBytes) && (memcmp(wire, frame, numBytes) == 0);
+}
+
+
+/*
+   Random frames of few colors, plain, with gamma & power limiter & with
+   5-channel pixels
+*/
+static void testWire()
+{
+  const uint16_t numLEDs = 1000;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+  uint32_t       colors[8];
+
+  strip.begin();
+
+  CHECK(espGetCache() == true);                      //enabled by default
+
+  for (uint8_t pass = 0; pass < 30; pass++)
+  {
+    if (pass == 10)
+    {
+      strip.setGamma(2.2);
+      strip.setMaxCurrent(2000);
+    }
+
+    if (pass == 20) {CHECK(strip.setPixelFormat(ESP32_WS281x::strToPixelFormat("grbwc")) == true);}
+
+    for (uint8_t i = 0; i < 8; i++) {colors[i] = testRandom();}
+
+    for (uint16_t i = 0; i < numLEDs; i++)
+    {
+      uint32_t color = colors[testRandom() % 8];
+
+      strip.setPixelColor(i, color >> 16, color >> 8, color, color >> 24, color >> 4);
+    }
+
+    if (sameWire(strip) != true) {CHECK(sameWire(strip) == true); break;}
+  }
+
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+/*
+   Two-tone frame hits on all but first pixel of each color, gradient never
+   hits & turns cache off after ESP_RMT_CACHE_MISSES misses in a row
+*/
+static void testStats()
+{
+  const uint16_t numLEDs = 1000;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+  uint32_t       hits   = 0;
+  uint32_t       misses = 0;
+
+  strip.begin();
+
+  for (uint16_t i = 0; i < numLEDs; i++) {strip.setPixelColor(i, (i & 1) ? 0xFF0000 : 0x0000FF);}
+
+  espGetCacheStats(hits, misses, true);
+  strip.show();
+  espGetCacheStats(hits, misses, true);
+
+  CHECK((hits == 998) && (misses == 2));
+
+  for (uint16_t i = 0; i < numLEDs; i++) {strip.setPixelColor(i, i, i >> 8, 0);}
+
+  strip.show();
+  espGetCacheStats(hits, misses, true);
+
+  CHECK((hits == 0) && (misses == numLEDs));
+
+  for (uint16_t i = 0; i < numLEDs; i++) {strip.setPixelColor(i, (i < 30) ? i : 0xFF0000);} //31 misses in a row, cache stays on
+
+  strip.show();
+  espGetCacheStats(hits, misses, true);
+
+  CHECK((hits == numLEDs - 31) && (misses == 31));
+
+  for (uint16_t i = 0; i < numLEDs; i++) {strip.setPixelColor(i, (i < 31) ? i : 0xFF0000);} //32 misses turn cache off for rest of the part
+
+  strip.show();
+  espGetCacheStats(hits, misses, true);
+
+  CHECK((hits == 0) && (misses == numLEDs));
+  CHECK(sameWire(strip) == true);
+
+  espGetCacheStats(hits, misses, true);
+
+  espSetCache(false);
+
+  CHECK(espGetCache() == false);
+
+  strip.setDirtyRange(0, numLEDs - 1);
+  strip.show();
+  espGetCacheStats(hits, misses, true);
+
+  CHECK((hits == 0) && (misses == 0));                //cache is off
+
+  espSetCache(true);
+  strip.end();
+}
+
+
+int main(int argc, char **argv)
+{
+  testWire();
+  testStats();
+
+  return testDone("test_cache");
+}
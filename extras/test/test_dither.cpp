@@ -0,0 +1,127 @@
+/***************************************************************************************************/
+/*
+   Host test of temporal dithering, see "ESP32_WS281x::setDithering()"
+
+   NOTE:
+   - error of every byte is carried in 8 bits, so sum of bytes sent in 256
+     frames equals 8.8 fixed-point value exactly. "bench" argument measures
+     "ditherFrame()" on 1000 RGB pixels with & without correction tables
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#define private public                               //"ditherFrame()" is timed alone
+#include "ESP32_WS281x.h"
+#undef private
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN 5
+
+
+/*
+   Low brightness fade, dithered bytes average out to full-precision value
+   while plain strip truncates it
+*/
+static void testDitherAverage()
+{
+  const uint16_t numLEDs = 50;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+  uint32_t       sums[numLEDs * 3];
+  uint16_t       expected[numLEDs * 3];
+
+  strip.begin();
+  strip.setBrightness(9);                            //10/256 of full scale
+
+  CHECK(strip.setDithering(true) == true);
+  CHECK(strip.getDithering() == true);
+
+  for (uint16_t i = 0; i < numLEDs; i++)
+  {
+    uint8_t r = testRandom();
+    uint8_t g = testRandom();
+    uint8_t b = testRandom();
+
+    strip.setPixelColor(i, r, g, b);
+
+    expected[i * 3 + 0] = g * 10;                    //GRB on the wire
+    expected[i * 3 + 1] = r * 10;
+    expected[i * 3 + 2] = b * 10;
+  }
+
+  memset(sums, 0, sizeof(sums));
+
+  for (uint16_t frame = 0; frame < 256; frame++)
+  {
+    uint32_t       numBytes = 0;
+    const uint8_t *wire     = NULL;
+
+    strip.show();
+
+    wire = stubRmtFrame(TEST_PIN, &numBytes);
+
+    CHECK((wire != NULL) && (numBytes == numLEDs * 3));
+
+    if (wire == NULL) {return;}
+
+    for (uint16_t b = 0; b < numLEDs * 3; b++) {sums[b] += wire[b];}
+  }
+
+  for (uint16_t b = 0; b < numLEDs * 3; b++)
+  {
+    if (sums[b] != expected[b]) {CHECK(sums[b] == expected[b]); break;}
+  }
+
+  CHECK(strip.setDithering(false) == true);
+  CHECK(strip.getDithering() == false);
+  CHECK(stubErrors() == 0);
+}
+
+
+static void benchDither()
+{
+  const uint16_t numLEDs = 1000;
+  const uint32_t rounds  = 20000;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+
+  strip.begin();
+  strip.setBrightness(100);
+  strip.setDithering(true);
+
+  for (uint16_t i = 0; i < numLEDs; i++) {strip.setPixelColor(i, testRandom());}
+
+  double start = testSeconds();
+
+  for (uint32_t r = 0; r < rounds; r++) {strip.ditherFrame();}
+
+  testReport("ditherFrame() 1000 RGB pixels", (double)numLEDs * 3 * rounds, testSeconds() - start);
+
+  strip.setGamma(2.2);                               //interpolated table lookup per byte
+
+  start = testSeconds();
+
+  for (uint32_t r = 0; r < rounds; r++) {strip.ditherFrame();}
+
+  testReport("ditherFrame() 1000 RGB pixels, gamma", (double)numLEDs * 3 * rounds, testSeconds() - start);
+}
+
+
+int main(int argc, char **argv)
+{
+  testDitherAverage();
+
+  if (testBench(argc, argv) == true)
+  {
+    benchDither();
+  }
+
+  return testDone("test_dither");
+}
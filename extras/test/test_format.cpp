@@ -0,0 +1,234 @@
+/***************************************************************************************************/
+/*
+   Host test of N-channel pixel formats, see "ESP32_WS281x::setPixelFormat()"
+
+   NOTE:
+   - every 3, 4 & 5 channel layout (any wire order of R,G,B & optional W, C)
+     is checked byte by byte on the stubbed RMT wire, in 8-bit, dithered &
+     16-bit mode. Power sums are checked against a full pass
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#define private   public                             //power sums are compared with full pass
+#define protected public
+#include "ESP32_WS281x.h"
+#undef private
+#undef protected
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN 5
+
+enum {TEST_PLAIN, TEST_DITHERED, TEST_WIDE};
+
+
+/*
+   Random wire order of R,G,B, W if numChannels > 3 & C if numChannels > 4 or
+   randomly instead of W
+*/
+static ledPixelFormat_t randomFormat(uint8_t numChannels)
+{
+  ledPixelFormat_t format = {numChannels, {LED_CHANNEL_R, LED_CHANNEL_G, LED_CHANNEL_B, LED_CHANNEL_W, LED_CHANNEL_C}};
+
+  if ((numChannels == 4) && (testRandom() & 1)) {format.order[3] = LED_CHANNEL_C;}
+
+  for (uint8_t i = numChannels - 1; i > 0; i--)     //Fisher-Yates shuffle
+  {
+    uint8_t j    = testRandom() % (i + 1);
+    uint8_t temp = format.order[i];
+
+    format.order[i] = format.order[j];
+    format.order[j] = temp;
+  }
+
+  return format;
+}
+
+
+/*
+   Wire bytes, read back & fill of one layout
+*/
+static void testLayout(const ledPixelFormat_t &format, uint8_t mode)
+{
+  const uint16_t numLEDs = 30;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+  uint8_t        channels[numLEDs][LED_MAX_CHANNELS];
+  uint8_t        has[LED_MAX_CHANNELS] = {1, 1, 1, 0, 0};
+  uint8_t        read[LED_MAX_CHANNELS];
+  uint32_t       numBytes = 0;
+  const uint8_t *wire     = NULL;
+
+  for (uint8_t i = 0; i < format.numChannels; i++) {has[format.order[i]] = 1;}
+
+  CHECK(strip.setPixelFormat(format) == true);
+
+  strip.begin();
+
+  if (mode == TEST_DITHERED) {CHECK(strip.setDithering(true) == true);}
+  if (mode == TEST_WIDE)     {CHECK(strip.setChannelDepth(16) == true);}
+
+  for (uint16_t i = 0; i < numLEDs; i++)
+  {
+    for (uint8_t c = 0; c < LED_MAX_CHANNELS; c++) {channels[i][c] = has[c] ? testRandom() : 0;}
+
+    strip.setPixelColor(i, channels[i][LED_CHANNEL_R], channels[i][LED_CHANNEL_G], channels[i][LED_CHANNEL_B], channels[i][LED_CHANNEL_W], channels[i][LED_CHANNEL_C]);
+  }
+
+  strip.show();
+
+  wire = stubRmtFrame(TEST_PIN, &numBytes);
+
+  CHECK((wire != NULL) && (numBytes == (uint32_t)numLEDs * format.numChannels * ((mode == TEST_WIDE) ? 2 : 1)));
+
+  for (uint16_t i = 0; (wire != NULL) && (i < numLEDs); i++)
+  {
+    bool equal = true;
+
+    for (uint8_t k = 0; k < format.numChannels; k++)
+    {
+      uint8_t value = channels[i][format.order[k]];
+
+      if (mode == TEST_WIDE) {equal &= (wire[(i * format.numChannels + k) * 2] == value) && (wire[(i * format.numChannels + k) * 2 + 1] == value);} //value * 257
+      else                   {equal &= (wire[i * format.numChannels + k] == value);}
+    }
+
+    strip.getPixelChannels(i, read);
+
+    equal &= (memcmp(read, channels[i], LED_MAX_CHANNELS) == 0);
+
+    if (equal != true) {CHECK(equal); break;}
+  }
+
+  uint8_t fill[LED_MAX_CHANNELS] = {11, 22, 33, 44, 55};
+
+  strip.fillChannels(fill, 5, 10);
+  strip.show();
+
+  wire = stubRmtFrame(TEST_PIN, &numBytes);
+
+  for (uint16_t i = 0; (wire != NULL) && (mode != TEST_WIDE) && (i < numLEDs); i++)
+  {
+    const uint8_t *expected = ((i >= 5) && (i < 15)) ? fill : channels[i];
+    bool           equal    = true;
+
+    for (uint8_t k = 0; k < format.numChannels; k++) {equal &= (wire[i * format.numChannels + k] == expected[format.order[k]]);}
+
+    if (equal != true) {CHECK(equal); break;}
+  }
+
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+/*
+   Invalid formats are rejected & parsed strings give expected formats
+*/
+static void testParse()
+{
+  ESP32_WS281x     strip(10, TEST_PIN, LED_GRB);
+  ledPixelFormat_t format = ESP32_WS281x::strToPixelFormat("grbWC");
+
+  CHECK(format.numChannels == 5);
+  CHECK((format.order[0] == LED_CHANNEL_G) && (format.order[1] == LED_CHANNEL_R) && (format.order[2] == LED_CHANNEL_B));
+  CHECK((format.order[3] == LED_CHANNEL_W) && (format.order[4] == LED_CHANNEL_C));
+
+  CHECK(ESP32_WS281x::strToPixelFormat("rxgbcwr").numChannels == 5); //unknown letter skipped, 6-th letter ignored
+  CHECK(ESP32_WS281x::strToPixelFormat(NULL).numChannels == 0);
+  CHECK(ESP32_WS281x::strToPixelFormat("").numChannels == 0);
+
+  CHECK(strip.setPixelFormat(ESP32_WS281x::strToPixelFormat("rgb")) == true);
+  CHECK(strip.setPixelFormat(ESP32_WS281x::strToPixelFormat("rg")) == false);    //too few channels
+  CHECK(strip.setPixelFormat(ESP32_WS281x::strToPixelFormat("rgbw")) == true);
+  CHECK(strip.setPixelFormat(ESP32_WS281x::strToPixelFormat("rgww")) == false);  //no blue, duplicate white
+  CHECK(strip.setPixelFormat(ESP32_WS281x::strToPixelFormat("rgbcw")) == true);
+
+  format          = ESP32_WS281x::strToPixelFormat("rgbwc");
+  format.order[4] = LED_MAX_CHANNELS;                //invalid channel
+
+  CHECK(strip.setPixelFormat(format) == false);
+}
+
+
+/*
+   Power sums kept while drawing 5-channel pixels match full pass, cold white
+   curve is applied to C byte only
+*/
+static void testPowerCurve()
+{
+  const uint16_t numLEDs = 50;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+  static uint8_t invert[256];
+  uint32_t       sum[LED_MAX_CHANNELS];
+  uint32_t       numBytes = 0;
+
+  for (uint16_t i = 0; i < 256; i++) {invert[i] = 255 - i;}
+
+  CHECK(strip.setPixelFormat(ESP32_WS281x::strToPixelFormat("cgrbw")) == true);
+
+  strip.begin();
+  strip.setMaxCurrent(500);
+  strip.setBrightness(150);
+
+  for (uint16_t n = 0; n < 1000; n++)
+  {
+    uint8_t channels[LED_MAX_CHANNELS] = {(uint8_t)testRandom(), (uint8_t)testRandom(), (uint8_t)testRandom(), (uint8_t)testRandom(), (uint8_t)testRandom()};
+
+    switch (testRandom() % 3)
+    {
+      case 0:  strip.setPixelColor(testRandom() % numLEDs, testRandom()); break;
+      case 1:  strip.fillChannels(channels, testRandom() % numLEDs, 1 + testRandom() % 5); break;
+      default: strip.setPixelColor(testRandom() % numLEDs, channels[0], channels[1], channels[2], channels[3], channels[4]); break;
+    }
+  }
+
+  memcpy(sum, strip._powerSum[strip._backFrame], sizeof(sum));
+
+  strip.updatePowerSum(strip._backFrame);
+
+  CHECK(memcmp(sum, strip._powerSum[strip._backFrame], sizeof(sum)) == 0);
+
+  strip.setMaxCurrent(0);
+  strip.setBrightness(255);
+  strip.setChannelCurve(LED_CHANNEL_C, invert);
+  strip.setPixelColor(0, 10, 20, 30, 40, 50);
+  strip.show();
+
+  const uint8_t *wire = stubRmtFrame(TEST_PIN, &numBytes);
+
+  CHECK((wire != NULL) && (numBytes == numLEDs * 5));
+  CHECK((wire != NULL) && (memcmp(wire, "\xCD\x14\x0A\x1E\x28", 5) == 0)); //C inverted, G,R,B,W linear
+
+  strip.end();
+}
+
+
+int main(int argc, char **argv)
+{
+  for (uint8_t numChannels = 3; numChannels <= LED_MAX_CHANNELS; numChannels++)
+  {
+    for (uint8_t n = 0; n < 20; n++)
+    {
+      ledPixelFormat_t format = randomFormat(numChannels);
+
+      testLayout(format, TEST_PLAIN);
+      testLayout(format, TEST_DITHERED);
+      testLayout(format, TEST_WIDE);
+    }
+  }
+
+  testParse();
+  testPowerCurve();
+
+  return testDone("test_format");
+}
@@ -0,0 +1,88 @@
+/***************************************************************************************************/
+/*
+   Host test of compile-time gamma-correction tables, see "ledGammaTable()"
+
+   NOTE:
+   - generated 2.6 table must match hand-typed table it replaced, entry by
+     entry. Tables are generated as constexpr, so the compile-time path is
+     what's tested
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+
+#include "test.h"
+
+
+/* hand-typed 8-bit 2.6 table of previous versions, same as Adafruit_NeoPixel */
+static const uint8_t oldGammaTable[256] =
+{
+  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+  0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,
+  1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   3,
+  3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   5,   6,
+  6,   6,   6,   7,   7,   7,   8,   8,   8,   9,   9,   9,   10,  10,  10,
+  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,
+  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+  25,  26,  27,  27,  28,  29,  29,  30,  31,  31,  32,  33,  34,  34,  35,
+  36,  37,  38,  38,  39,  40,  41,  42,  42,  43,  44,  45,  46,  47,  48,
+  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+  64,  65,  66,  68,  69,  70,  71,  72,  73,  75,  76,  77,  78,  80,  81,
+  82,  84,  85,  86,  88,  89,  90,  92,  93,  94,  96,  97,  99,  100, 102,
+  103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120, 122, 124, 125,
+  127, 129, 130, 132, 134, 136, 137, 139, 141, 143, 145, 146, 148, 150, 152,
+  154, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180, 182,
+  184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
+  218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252,
+  255
+};
+
+
+static void testGamma8()
+{
+  static constexpr auto table = ledGammaTable<uint8_t>(2.6);
+
+  for (uint16_t i = 0; i < 256; i++)
+  {
+    if (table[i] != oldGammaTable[i])                {CHECK(table[i] == oldGammaTable[i]); break;}
+    if (ESP32_WS281x::gamma8(i) != oldGammaTable[i]) {CHECK(ESP32_WS281x::gamma8(i) == oldGammaTable[i]); break;}
+    if (_ledPixelGammaTable[i] != oldGammaTable[i])  {CHECK(_ledPixelGammaTable[i] == oldGammaTable[i]); break;}
+  }
+}
+
+
+/*
+   8->16 table for dithered strips, against "pow()" of host libm
+*/
+static void testGamma16()
+{
+  static constexpr auto table = ledGammaTable<uint16_t>(2.2);
+
+  CHECK(table.size() == 256);
+  CHECK(table[0] == 0);
+  CHECK(table[255] == 0xFFFF);
+
+  for (uint16_t i = 0; i < 256; i++)
+  {
+    uint16_t expected = pow(i / 255.0, 2.2) * 65535 + 0.5;
+
+    if (table[i] != expected)                    {CHECK(table[i] == expected); break;}
+    if ((i > 0) && (table[i] < table[i - 1]))    {CHECK(table[i] >= table[i - 1]); break;}
+  }
+}
+
+
+int main(int argc, char **argv)
+{
+  testGamma8();
+  testGamma16();
+
+  return testDone("test_gamma");
+}
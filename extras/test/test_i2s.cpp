@@ -0,0 +1,193 @@
+/***************************************************************************************************/
+/*
+   Host test of I2S/LCD parallel output, see "ESP32_I2S.h"
+
+   NOTE:
+   - bus words seen by stub driver are decoded line by line: every bit is
+     high, data & low slot, line ends at first slot triplet without high.
+     Bytes of every line must match pixels of its part of virtual strip,
+     with incremental encoding too
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+#include "ESP32_I2S.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_CLOCK_PIN 40
+#define TEST_DC_PIN    41
+#define TEST_FIRST_PIN 1
+
+
+/*
+   Decode bytes of one bus line, return number of bytes or 0xFFFFFFFF if slots
+   are malformed
+*/
+static uint32_t decodeLine(const uint8_t *frame, uint32_t numBytes, uint8_t busWidth, uint8_t line, uint8_t *out)
+{
+  uint8_t  wordSize = busWidth / 8;
+  uint32_t numWords = numBytes / wordSize;
+  uint32_t bits     = 0;
+
+  for (uint32_t w = 0; (w + 2) < numWords; w += 3)
+  {
+    uint16_t high = (wordSize == 1) ? frame[w]     : ((const uint16_t *)frame)[w];
+    uint16_t data = (wordSize == 1) ? frame[w + 1] : ((const uint16_t *)frame)[w + 1];
+    uint16_t low  = (wordSize == 1) ? frame[w + 2] : ((const uint16_t *)frame)[w + 2];
+
+    if (((high >> line) & 1) == 0) {break;}          //end of line, latch or shorter part
+    if (((low  >> line) & 1) != 0) {return 0xFFFFFFFF;}
+
+    if ((bits % 8) == 0) {out[bits / 8] = 0;}
+
+    out[bits / 8] |= ((data >> line) & 1) << (7 - (bits % 8));
+
+    bits++;
+  }
+
+  return ((bits % 8) == 0) ? (bits / 8) : 0xFFFFFFFF;
+}
+
+
+/*
+   Decode last bus frame, every line must match its part of strip & unused
+   lines must be routed to D/C pin
+*/
+static bool checkFrame(ESP32_WS281x &strip, const int8_t *pins, const ledIndexType *lengths, uint8_t numPins)
+{
+  uint32_t       numBytes = 0;
+  uint8_t        busWidth = 0;
+  const int     *busPins  = NULL;
+  const uint8_t *frame    = stubLcdFrame(&numBytes, &busWidth, &busPins);
+  ledIndexType   first    = 0;
+
+  if ((frame == NULL) || (busWidth != ((numPins > 8) ? 16 : 8))) {return false;}
+
+  for (uint8_t line = numPins; line < busWidth; line++)
+  {
+    if (busPins[line] != TEST_DC_PIN) {return false;}  //unused lines share D/C pin
+  }
+
+  for (uint8_t line = 0; line < numPins; line++)
+  {
+    uint8_t bytes[40 * 3];
+
+    if (busPins[line] != pins[line])                                                {return false;}
+    if (decodeLine(frame, numBytes, busWidth, line, bytes) != (lengths[line] * 3u)) {return false;}
+
+    for (ledIndexType i = 0; i < lengths[line]; i++)
+    {
+      uint32_t wire = ((uint32_t)bytes[i * 3 + 1] << 16) | ((uint32_t)bytes[i * 3] << 8) | bytes[i * 3 + 2]; //GRB on the wire
+
+      if (wire != strip.getPixelColor(first + i)) {return false;}
+    }
+
+    first += lengths[line];
+  }
+
+  return true;
+}
+
+
+/*
+   Virtual strip of random part lengths on numPins lines. With incremental
+   encoding a few pixels change between frames
+*/
+static void testLines(uint8_t numPins, bool incremental)
+{
+  int8_t       pins[ESP_I2S_MAX_PINS];
+  ledIndexType lengths[ESP_I2S_MAX_PINS];
+  ledIndexType numLEDs = 0;
+  ESP32_WS281x strip;
+
+  for (uint8_t i = 0; i < numPins; i++)
+  {
+    pins[i]    = TEST_FIRST_PIN + i;
+    lengths[i] = 1 + (testRandom() % 40);
+    numLEDs   += lengths[i];
+  }
+
+  espI2sSetClockPin(TEST_CLOCK_PIN);
+  espI2sSetDcPin(TEST_DC_PIN);
+  espI2sSetIncremental(incremental);
+
+  CHECK(strip.setOutput(&espOutputI2S) == true);
+  CHECK(strip.setPins(pins, lengths, numPins) == true);
+
+  strip.begin();
+
+  for (ledIndexType i = 0; i < numLEDs; i++) {strip.setPixelColor(i, testRandom() & 0xFFFFFF);}
+
+  strip.show();
+
+  CHECK(checkFrame(strip, pins, lengths, numPins) == true);
+
+  for (uint8_t frame = 0; (incremental == true) && (frame < 20); frame++)
+  {
+    for (uint8_t n = testRandom() % 4; n > 0; n--) {strip.setPixelColor(testRandom() % numLEDs, testRandom() & 0xFFFFFF);}
+
+    strip.show();
+
+    if (checkFrame(strip, pins, lengths, numPins) != true) {CHECK(checkFrame(strip, pins, lengths, numPins) == true); break;}
+  }
+
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+/*
+   Bus is not created without D/C pin, frame is dropped
+*/
+static void testDcPin()
+{
+  int8_t       pins[1]    = {TEST_FIRST_PIN};
+  ledIndexType lengths[1] = {10};
+  ESP32_WS281x strip;
+
+  espI2sSetClockPin(TEST_CLOCK_PIN);
+  espI2sSetDcPin(-1);
+
+  CHECK(espI2sGetDcPin() == -1);
+  CHECK(strip.setOutput(&espOutputI2S) == true);
+  CHECK(strip.setPins(pins, lengths, 1) == true);
+
+  strip.begin();
+  strip.fill(0xFFFFFF);
+  strip.show();
+
+  CHECK(strip.getDroppedFrames() == 1);
+
+  espI2sSetDcPin(TEST_DC_PIN);
+
+  strip.show();
+
+  CHECK(checkFrame(strip, pins, lengths, 1) == true);
+
+  strip.end();
+}
+
+
+int main(int argc, char **argv)
+{
+  testLines(3,  false);
+  testLines(8,  false);
+  testLines(10, false);
+  testLines(16, false);
+  testLines(8,  true);
+  testLines(16, true);
+  testDcPin();
+
+  return testDone("test_i2s");
+}
@@ -0,0 +1,180 @@
+/***************************************************************************************************/
+/*
+   Host test of palette-indexed strip, see "ESP32_WS281x_Palette.h"
+
+   NOTE:
+   - wire bytes decoded by RMT stub must match "ESP32_WS281x" strip drawn with
+     the same colors, "bench" argument also times "show()" of both
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+#include "ESP32_WS281x_Palette.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN       5
+#define TEST_OTHER_PIN 6
+
+
+/*
+   Last frames of both pins must be equal
+*/
+static bool sameWire()
+{
+  uint32_t       numBytes      = 0;
+  uint32_t       otherNumBytes = 0;
+  const uint8_t *wire          = stubRmtFrame(TEST_PIN, &numBytes);
+  const uint8_t *other         = stubRmtFrame(TEST_OTHER_PIN, &otherNumBytes);
+
+  return (wire != NULL) && (other != NULL) && (numBytes == otherNumBytes) && (memcmp(wire, other, numBytes) == 0);
+}
+
+
+/*
+   Random palette, indices & fills with odd edges
+*/
+static void testPalette(ledPixelType ledType, uint8_t bitsPerIndex)
+{
+  const uint16_t       numLEDs = 101;                //odd, last 4-bit byte is half used
+  ESP32_WS281x_Palette palette(numLEDs, TEST_PIN, ledType, bitsPerIndex);
+  ESP32_WS281x         strip(numLEDs, TEST_OTHER_PIN, ledType);
+  uint32_t             colors[256];
+  uint8_t              indices[numLEDs];
+  uint16_t             numColors = 1 << bitsPerIndex;
+
+  CHECK(palette.getBitsPerIndex() == bitsPerIndex);
+  CHECK(palette.getPaletteSize() == numColors);
+
+  palette.begin();
+  strip.begin();
+
+  for (uint16_t i = 0; i < numColors; i++) {colors[i] = testRandom();}
+
+  palette.setPaletteColors(0, colors, numColors);
+
+  for (uint16_t i = 0; i < numColors; i++)
+  {
+    if (palette.getPaletteColor(i) != colors[i]) {CHECK(palette.getPaletteColor(i) == colors[i]); break;}
+  }
+
+  for (uint8_t pass = 0; pass < 4; pass++)
+  {
+    if (pass == 1)                                   //odd fill edges
+    {
+      ledIndexType first = 1 + 2 * (testRandom() % 20);
+      ledIndexType count = 1 + 2 * (testRandom() % 20);
+      uint8_t      index = testRandom() % numColors;
+
+      palette.fill(index, first, count);
+
+      for (ledIndexType i = first; i < first + count; i++) {indices[i] = index;}
+    }
+    else if (pass == 2)                              //brightness is applied to pre-encoded colors
+    {
+      palette.setBrightness(77);
+      strip.setBrightness(77);
+    }
+    else if (pass == 3)
+    {
+      palette.setPaletteColor(indices[0], 0x00FF7F01);
+
+      colors[indices[0]] = 0x00FF7F01;
+    }
+    else
+    {
+      for (ledIndexType i = 0; i < numLEDs; i++)
+      {
+        indices[i] = testRandom() % numColors;
+
+        palette.setPixelIndex(i, indices[i]);
+      }
+    }
+
+    for (ledIndexType i = 0; i < numLEDs; i++)
+    {
+      if (palette.getPixelIndex(i) != indices[i]) {CHECK(palette.getPixelIndex(i) == indices[i]); break;}
+
+      strip.setPixelColor(i, colors[indices[i]]);
+    }
+
+    palette.show();
+    strip.show();
+
+    if (sameWire() != true) {CHECK(sameWire() == true); break;}
+  }
+
+  palette.clear();                                   //palette index 0, not black
+  strip.fill(colors[0]);
+  palette.show();
+  strip.show();
+
+  CHECK(sameWire() == true);
+
+  palette.end();
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+static void benchPalette()
+{
+  const uint16_t       numLEDs = 1000;
+  const uint16_t       rounds  = 1000;
+  ESP32_WS281x_Palette palette(numLEDs, TEST_PIN, LED_GRB, 4);
+  ESP32_WS281x         strip(numLEDs, TEST_OTHER_PIN, LED_GRB);
+
+  palette.begin();
+  strip.begin();
+
+  for (uint8_t i = 0; i < 16; i++) {palette.setPaletteColor(i, testRandom());}
+
+  for (ledIndexType i = 0; i < numLEDs; i++)
+  {
+    uint8_t index = testRandom() % 16;
+
+    palette.setPixelIndex(i, index);
+    strip.setPixelColor(i, palette.getPaletteColor(index));
+  }
+
+  double start = testSeconds();
+
+  for (uint16_t r = 0; r < rounds; r++) {palette.show();}
+
+  testReport("palette show() 1000 RGB pixels", (double)numLEDs * 3 * rounds, testSeconds() - start);
+
+  start = testSeconds();
+
+  for (uint16_t r = 0; r < rounds; r++) {strip.setDirtyRange(0, numLEDs - 1); strip.show();}
+
+  testReport("strip show() 1000 RGB pixels", (double)numLEDs * 3 * rounds, testSeconds() - start);
+
+  palette.end();
+  strip.end();
+}
+
+
+int main(int argc, char **argv)
+{
+  testPalette(LED_GRB,  4);
+  testPalette(LED_GRB,  8);
+  testPalette(LED_GRBW, 4);
+  testPalette(LED_GRBW, 8);
+
+  if (testBench(argc, argv) == true)
+  {
+    benchPalette();
+  }
+
+  return testDone("test_palette");
+}
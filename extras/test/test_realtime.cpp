@@ -0,0 +1,139 @@
+/***************************************************************************************************/
+/*
+   Host test of realtime mode, see "ESP32_WS281x::setRealtime()"
+
+   NOTE:
+   - every allocator call & RMT channel (re)configuration is counted by stubs,
+     see "stubAllocs()". "show()" of realtime strip must make none, while
+     other strip time-shares remaining RMT channels
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+#include "ESP32_I2S.h"
+#include "ESP32_SPI.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN       5
+#define TEST_OTHER_PIN 6
+#define TEST_CLOCK_PIN 40
+#define TEST_DC_PIN    41
+
+enum {TEST_PLAIN, TEST_DITHERED, TEST_TRIPLE};
+
+
+/*
+   Frames of realtime strip are sent without allocator calls & match pixels
+*/
+static void testRealtime(uint8_t mode)
+{
+  const uint16_t numLEDs = 100;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRB);
+  ESP32_WS281x   other(numLEDs * 2, TEST_OTHER_PIN, LED_GRB);
+  uint8_t        expected[numLEDs * 3];
+
+  if (mode == TEST_DITHERED) {CHECK(strip.setDithering(true) == true);}
+  if (mode == TEST_TRIPLE)   {CHECK(strip.setTripleBuffering(true) == true);}
+
+  CHECK(strip.setRealtime(true) == true);
+
+  strip.begin();
+  other.begin();
+
+  for (uint16_t frame = 0; frame < 50; frame++)
+  {
+    for (uint16_t i = 0; i < numLEDs; i++)
+    {
+      uint8_t r = testRandom();
+      uint8_t g = testRandom();
+      uint8_t b = testRandom();
+
+      strip.setPixelColor(i, r, g, b);
+
+      expected[i * 3 + 0] = g;                       //GRB on the wire
+      expected[i * 3 + 1] = r;
+      expected[i * 3 + 2] = b;
+    }
+
+    if (mode == TEST_TRIPLE) {strip.commit();}
+
+    uint32_t allocs = stubAllocs();
+
+    strip.show();
+
+    if (stubAllocs() != allocs) {CHECK(stubAllocs() == allocs); break;}
+
+    uint32_t       numBytes = 0;
+    const uint8_t *wire     = stubRmtFrame(TEST_PIN, &numBytes);
+
+    CHECK((wire != NULL) && (numBytes == sizeof(expected)));
+
+    if ((wire == NULL) || (memcmp(wire, expected, sizeof(expected)) != 0)) {CHECK(memcmp(wire, expected, sizeof(expected)) == 0); break;}
+
+    other.fill(0x00FF00);
+    other.show();
+  }
+
+  CHECK(strip.getDroppedFrames() == 0);
+  CHECK(stubErrors() == 0);
+
+  strip.end();
+  other.end();
+}
+
+
+/*
+   Growing realtime strip on output with owned bus of fixed transfer size,
+   bus is created again by "reserve()" & frames are not dropped
+*/
+static void testGrow(const espOutput_t *output)
+{
+  ESP32_WS281x strip(10, TEST_PIN, LED_GRB);
+
+  espI2sSetClockPin(TEST_CLOCK_PIN);
+  espI2sSetDcPin(TEST_DC_PIN);
+
+  CHECK(strip.setOutput(output) == true);
+  CHECK(strip.setRealtime(true) == true);
+
+  strip.begin();
+
+  for (uint16_t numLEDs = 10; numLEDs <= 1000; numLEDs *= 10)
+  {
+    strip.setLength(numLEDs);                        //capacity & DMA buffer grow
+    strip.fill(0x10FF20);
+    strip.show();
+  }
+
+  CHECK(strip.reserve(2000) == true);
+
+  strip.setLength(2000);
+  strip.show();
+
+  CHECK(strip.getDroppedFrames() == 0);
+  CHECK(stubErrors() == 0);
+
+  strip.end();
+}
+
+
+int main(int argc, char **argv)
+{
+  testRealtime(TEST_PLAIN);
+  testRealtime(TEST_DITHERED);
+  testRealtime(TEST_TRIPLE);
+  testGrow(&espOutputI2S);
+  testGrow(&espOutputSPI);
+
+  return testDone("test_realtime");
+}
@@ -0,0 +1,140 @@
+/***************************************************************************************************/
+/*
+   Host test of run-length encoded strip, see "ESP32_WS281x_RLE.h"
+
+   NOTE:
+   - stub RMT channel has 64 symbols of memory, so every frame is resumed
+     across many memory-full refills of the streaming encoder. Wire bytes must
+     match "ESP32_WS281x" strip drawn with the same colors
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+#include "ESP32_WS281x_RLE.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN       5
+#define TEST_OTHER_PIN 6
+
+
+/*
+   Last frames of both pins must be equal
+*/
+static bool sameWire()
+{
+  uint32_t       numBytes      = 0;
+  uint32_t       otherNumBytes = 0;
+  const uint8_t *wire          = stubRmtFrame(TEST_PIN, &numBytes);
+  const uint8_t *other         = stubRmtFrame(TEST_OTHER_PIN, &otherNumBytes);
+
+  return (wire != NULL) && (other != NULL) && (numBytes == otherNumBytes) && (memcmp(wire, other, numBytes) == 0);
+}
+
+
+/*
+   Random fills, single pixels & brightness. Colors come from small set, so
+   neighbour runs often become equal & must be merged
+*/
+static void testRle(ledPixelType ledType)
+{
+  const uint16_t   numLEDs = 300;
+  ESP32_WS281x_RLE rle(numLEDs, TEST_PIN, ledType);
+  ESP32_WS281x     strip(numLEDs, TEST_OTHER_PIN, ledType);
+  uint32_t         colors[numLEDs];
+  uint32_t         palette[6];
+  uint32_t         mask    = (ledType == LED_GRB) ? 0xFFFFFF : 0xFFFFFFFF;
+
+  for (uint8_t i = 0; i < 6; i++) {palette[i] = testRandom() & mask;}
+
+  rle.begin();
+  strip.begin();
+
+  CHECK(rle.getNumRuns() == 1);                      //one black run
+
+  memset(colors, 0, sizeof(colors));
+
+  for (uint16_t n = 0; n < 3000; n++)
+  {
+    uint32_t     color = palette[testRandom() % 6];
+    ledIndexType first = testRandom() % numLEDs;
+
+    switch (testRandom() % 8)
+    {
+      case 0:
+      case 1:
+      case 2:
+      {
+        ledIndexType count = testRandom() % 40;      //0 fills to end of strip
+        ledIndexType end   = ((count == 0) || (count > (numLEDs - first))) ? numLEDs : (first + count);
+
+        rle.fill(color, first, count);
+
+        for (ledIndexType i = first; i < end; i++) {colors[i] = color;}
+
+        break;
+      }
+
+      case 7:
+        rle.setBrightness(((testRandom() % 4) == 0) ? 255 : testRandom()); //255 is stored as 0, see "setBrightness()"
+        strip.setBrightness(rle.getBrightness());
+        break;
+
+      default:
+        rle.setPixelColor(first, color);
+
+        colors[first] = color;
+        break;
+    }
+
+    uint32_t numRuns = 1;                            //minimal number of runs
+
+    for (ledIndexType i = 1; i < numLEDs; i++) {numRuns += (colors[i] != colors[i - 1]);}
+
+    if (rle.getNumRuns() != numRuns) {CHECK(rle.getNumRuns() == numRuns); break;}
+
+    if ((n % 10) != 0) {continue;}
+
+    for (ledIndexType i = 0; i < numLEDs; i++)
+    {
+      if (rle.getPixelColor(i) != colors[i]) {CHECK(rle.getPixelColor(i) == colors[i]); break;}
+    }
+
+    strip.setPixelColors(0, colors, numLEDs);        //brightness premultiply of current level
+    strip.show();
+    rle.show();
+
+    if (sameWire() != true) {CHECK(sameWire() == true); break;}
+  }
+
+  rle.clear();
+  strip.clear();
+  rle.show();
+  strip.show();
+
+  CHECK(rle.getNumRuns() == 1);
+  CHECK(sameWire() == true);
+
+  rle.end();
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+int main(int argc, char **argv)
+{
+  testRle(LED_GRB);
+  testRle(LED_GRBW);
+
+  return testDone("test_rle");
+}
@@ -0,0 +1,127 @@
+/***************************************************************************************************/
+/*
+   Host test of SPI output, see "ESP32_SPI.h"
+
+   NOTE:
+   - SPI bitstream seen by stub driver is decoded pattern by pattern (3 or 4
+     SPI bits per data bit, first one high, second one is data bit) & must
+     give the same bytes as RMT output of the same pixels
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_WS281x.h"
+#include "ESP32_SPI.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_SPI_PIN 5
+#define TEST_RMT_PIN 6
+
+
+/*
+   Decode SPI bitstream, stops at latch (pattern without leading high bit).
+   Return number of bytes or 0xFFFFFFFF if pattern is malformed
+*/
+static uint32_t decodeSpi(const uint8_t *frame, uint32_t numBytes, uint8_t bitsPerBit, uint8_t *out)
+{
+  uint32_t bits = 0;
+
+  for (uint32_t s = 0; (s + bitsPerBit) <= numBytes * 8; s += bitsPerBit)
+  {
+    uint8_t pattern = 0;
+
+    for (uint8_t k = 0; k < bitsPerBit; k++) {pattern = (pattern << 1) | ((frame[(s + k) / 8] >> (7 - ((s + k) % 8))) & 1);}
+
+    if (pattern == 0) {break;}                       //latch
+
+    bool one  = (bitsPerBit == 4) ? (pattern == 0x0E) : (pattern == 0x06);
+    bool zero = (bitsPerBit == 4) ? (pattern == 0x08) : (pattern == 0x04);
+
+    if ((one != true) && (zero != true)) {return 0xFFFFFFFF;}
+
+    if ((bits % 8) == 0) {out[bits / 8] = 0;}
+
+    if (one == true) {out[bits / 8] |= 0x80 >> (bits % 8);}
+
+    bits++;
+  }
+
+  return ((bits % 8) == 0) ? (bits / 8) : 0xFFFFFFFF;
+}
+
+
+/*
+   Same random pixels, brightness & gamma on SPI & RMT strip
+*/
+static void testSpi(ledPixelType ledType, uint8_t bytesPerPixel, uint8_t bitsPerBit)
+{
+  const uint16_t numLEDs = 100;
+  ESP32_WS281x   spi(numLEDs, TEST_SPI_PIN, ledType);
+  ESP32_WS281x   rmt(numLEDs, TEST_RMT_PIN, ledType);
+
+  espSpiSetPattern(bitsPerBit);
+
+  CHECK(espSpiGetPattern() == bitsPerBit);
+  CHECK(spi.setOutput(&espOutputSPI) == true);
+
+  spi.begin();
+  rmt.begin();
+
+  for (uint8_t pass = 0; pass < 3; pass++)
+  {
+    if (pass == 1) {spi.setBrightness(100); rmt.setBrightness(100);}
+    if (pass == 2) {spi.setGamma(2.2);      rmt.setGamma(2.2);}
+
+    for (uint16_t i = 0; i < numLEDs; i++)
+    {
+      uint32_t color = testRandom();
+
+      spi.setPixelColor(i, color);
+      rmt.setPixelColor(i, color);
+    }
+
+    spi.show();
+    rmt.show();
+
+    uint32_t       spiBytes = 0;
+    uint32_t       rmtBytes = 0;
+    uint32_t       clockHz  = 0;
+    const uint8_t *spiFrame = stubSpiFrame(&spiBytes, &clockHz);
+    const uint8_t *rmtFrame = stubRmtFrame(TEST_RMT_PIN, &rmtBytes);
+    uint8_t        bytes[numLEDs * 4];
+
+    CHECK((spiFrame != NULL) && (rmtFrame != NULL));
+
+    if ((spiFrame == NULL) || (rmtFrame == NULL)) {break;}
+
+    CHECK(clockHz == ((bitsPerBit == 4) ? 3200000 : 2400000));
+    CHECK(rmtBytes == numLEDs * bytesPerPixel);
+    CHECK(decodeSpi(spiFrame, spiBytes, bitsPerBit, bytes) == rmtBytes);
+    CHECK(memcmp(bytes, rmtFrame, rmtBytes) == 0);
+  }
+
+  spi.end();
+  rmt.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+int main(int argc, char **argv)
+{
+  testSpi(LED_GRB,  3, 4);
+  testSpi(LED_GRBW, 4, 4);
+  testSpi(LED_GRB,  3, 3);
+  testSpi(LED_GRBW, 4, 3);
+
+  return testDone("test_spi");
+}
@@ -0,0 +1,255 @@
+/***************************************************************************************************/
+/*
+   Host test of bit-plane transposition engine, see "ESP32_Transpose.h"
+
+   NOTE:
+   - kernels are checked bit by bit against plain reference loops, "bench"
+     argument also measures throughput of both
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#include "ESP32_Transpose.h"
+
+#include "test.h"
+
+
+/*
+   Reference 8x8 transpose, plane "k" has bit "7 - k" of every value, bit "i"
+   of plane is values[i]
+*/
+static void refTranspose8x8(uint8_t *planes, const uint8_t *values)
+{
+  for (uint8_t k = 0; k < 8; k++)
+  {
+    planes[k] = 0;
+
+    for (uint8_t i = 0; i < 8; i++) {planes[k] |= ((values[i] >> (7 - k)) & 1) << i;}
+  }
+}
+
+
+/*
+   Reference "espTransposeParts()", one byte index at a time & one bit at a time
+*/
+static void refTransposeParts(uint8_t *out, uint8_t wordSize, uint8_t stride, const uint8_t *const *parts, const uint32_t *numBytes, uint8_t numParts, const espEncoder_t *encoder, uint32_t first, uint32_t last)
+{
+  uint32_t maxBytes      = 0;
+  uint8_t  bytesPerPixel = (encoder != NULL) ? encoder->bytesPerPixel : 3;
+
+  for (uint8_t i = 0; i < numParts; i++)
+  {
+    if (numBytes[i] > maxBytes) {maxBytes = numBytes[i];}
+  }
+
+  for (uint32_t b = first; (b <= last) && (b < maxBytes); b++)
+  {
+    for (uint8_t k = 0; k < 8; k++)
+    {
+      uint16_t word = 0;
+
+      for (uint8_t i = 0; i < numParts; i++)
+      {
+        uint8_t value = (b < numBytes[i]) ? espEncodeValue(encoder, parts[i][b], b % bytesPerPixel) : 0;
+
+        word |= ((value >> (7 - k)) & 1) << i;
+      }
+
+      uint32_t index = (b * 8 + k) * stride;
+
+      if (wordSize == 1) {out[index] = word;}
+      else               {((uint16_t *)out)[index] = word;}
+    }
+  }
+}
+
+
+static void testTranspose8x8()
+{
+  uint8_t values[8];
+  uint8_t planes[8];
+  uint8_t expected[8];
+
+  for (uint32_t n = 0; n < 100000; n++)
+  {
+    for (uint8_t i = 0; i < 8; i++) {values[i] = testRandom();}
+
+    espTranspose8x8(planes, values);
+    refTranspose8x8(expected, values);
+
+    if (memcmp(planes, expected, 8) != 0) {CHECK(memcmp(planes, expected, 8) == 0); break;}
+  }
+}
+
+
+static void testTranspose16x8()
+{
+  uint8_t  values[16];
+  uint16_t planes[8];
+  uint8_t  lo[8];
+  uint8_t  hi[8];
+
+  for (uint32_t n = 0; n < 100000; n++)
+  {
+    for (uint8_t i = 0; i < 16; i++) {values[i] = testRandom();}
+
+    espTranspose16x8(planes, values);
+    refTranspose8x8(lo, &values[0]);
+    refTranspose8x8(hi, &values[8]);
+
+    bool equal = true;
+
+    for (uint8_t k = 0; k < 8; k++) {equal &= (planes[k] == (((uint16_t)hi[k] << 8) | lo[k]));}
+
+    if (equal != true) {CHECK(equal); break;}
+  }
+}
+
+
+/*
+   Random layouts, encoder settings & byte ranges. Words outside transposed
+   range and words between planes must stay untouched
+*/
+static void testTransposeParts()
+{
+  static uint8_t  pixels[16][300];
+  static uint8_t  out[2][300 * 8 * 3 * 2];
+  static uint16_t lut[4 * 256];
+
+  for (uint16_t i = 0; i < 4 * 256; i++) {lut[i] = testRandom() % 0xFF01;}
+
+  for (uint32_t n = 0; n < 2000; n++)
+  {
+    const uint8_t *parts[16];
+    uint32_t       numBytes[16];
+    espEncoder_t   encoder;
+    uint8_t        wordSize = 1 + (testRandom() & 1);
+    uint8_t        stride   = 1 + (testRandom() % 3);
+    uint8_t        numParts = 1 + (testRandom() % (wordSize * 8));
+
+    encoder.lut           = (testRandom() & 1) ? lut : NULL;
+    encoder.bytesPerPixel = 3 + (testRandom() & 1);
+    encoder.scale         = (testRandom() & 1) ? 256 : (testRandom() % 257);
+
+    for (uint8_t i = 0; i < numParts; i++)
+    {
+      parts[i]    = pixels[i];
+      numBytes[i] = (testRandom() % (300 / 12 + 1)) * 12; //whole pixels of 3 or 4 bytes
+
+      for (uint32_t b = 0; b < numBytes[i]; b++) {pixels[i][b] = testRandom();}
+    }
+
+    uint32_t first = testRandom() % 320;
+    uint32_t last  = (testRandom() & 1) ? 0xFFFFFFFF : (first + testRandom() % 64);
+
+    if ((testRandom() % 4) == 0) {first = 0;}
+
+    memset(out[0], 0xA5, sizeof(out[0]));
+    memset(out[1], 0xA5, sizeof(out[1]));
+
+    const espEncoder_t *enc = (testRandom() % 4) ? &encoder : NULL;
+
+    espTransposeParts(out[0], wordSize, stride, parts, numBytes, numParts, enc, first, last);
+    refTransposeParts(out[1], wordSize, stride, parts, numBytes, numParts, enc, first, last);
+
+    if (memcmp(out[0], out[1], sizeof(out[0])) != 0) {CHECK(memcmp(out[0], out[1], sizeof(out[0])) == 0); break;}
+  }
+}
+
+
+static void benchTranspose()
+{
+  static uint8_t values[1 << 20];
+  static uint8_t planes[1 << 20];
+  const uint8_t  rounds = 64;
+
+  for (uint32_t i = 0; i < sizeof(values); i++) {values[i] = testRandom();}
+
+  double start = testSeconds();
+
+  for (uint8_t r = 0; r < rounds; r++)
+  {
+    for (uint32_t i = 0; i < sizeof(values); i += 8) {espTranspose8x8(&planes[i], &values[i]);}
+
+    values[r] ^= planes[r];                          //keep loop from being optimized away
+  }
+
+  testReport("espTranspose8x8()", (double)sizeof(values) * rounds, testSeconds() - start);
+
+  start = testSeconds();
+
+  for (uint8_t r = 0; r < rounds; r++)
+  {
+    for (uint32_t i = 0; i < sizeof(values); i += 8) {refTranspose8x8(&planes[i], &values[i]);}
+
+    values[r] ^= planes[r];
+  }
+
+  testReport("reference 8x8", (double)sizeof(values) * rounds, testSeconds() - start);
+}
+
+
+static void benchTransposeParts()
+{
+  static uint8_t pixels[16][3000];                  //16 strips of 1000 RGB LEDs
+  static uint8_t out[3000 * 8 * 3 * 2];
+  const uint8_t *parts[16];
+  uint32_t       numBytes[16];
+  espEncoder_t   encoder  = {NULL, 3, 200, 0, 0xFFFFFFFF};
+  const uint16_t rounds   = 200;
+
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    parts[i]    = pixels[i];
+    numBytes[i] = sizeof(pixels[i]);
+
+    for (uint32_t b = 0; b < numBytes[i]; b++) {pixels[i][b] = testRandom();}
+  }
+
+  for (uint8_t numParts = 8; numParts <= 16; numParts += 8)
+  {
+    uint8_t wordSize = numParts / 8;
+    char    name[64];
+    double  start    = testSeconds();
+
+    for (uint16_t r = 0; r < rounds; r++) {espTransposeParts(out, wordSize, 3, parts, numBytes, numParts, &encoder);}
+
+    snprintf(name, sizeof(name), "espTransposeParts() %u parts", numParts);
+    testReport(name, (double)sizeof(pixels[0]) * numParts * rounds, testSeconds() - start);
+
+    start = testSeconds();
+
+    for (uint16_t r = 0; r < rounds / 10; r++) {refTransposeParts(out, wordSize, 3, parts, numBytes, numParts, &encoder, 0, 0xFFFFFFFF);}
+
+    snprintf(name, sizeof(name), "reference %u parts", numParts);
+    testReport(name, (double)sizeof(pixels[0]) * numParts * (rounds / 10), testSeconds() - start);
+  }
+
+  double start = testSeconds();
+
+  for (uint16_t r = 0; r < rounds; r++) {espTransposeParts(out, 2, 3, parts, numBytes, 16, &encoder, 1500, 1500 + 29);} //10 dirty LEDs
+
+  testReport("espTransposeParts() 16 parts, 10 dirty", (double)sizeof(pixels[0]) * 16 * rounds, testSeconds() - start);
+}
+
+
+int main(int argc, char **argv)
+{
+  testTranspose8x8();
+  testTranspose16x8();
+  testTransposeParts();
+
+  if (testBench(argc, argv) == true)
+  {
+    benchTranspose();
+    benchTransposeParts();
+  }
+
+  return testDone("test_transpose");
+}
@@ -0,0 +1,240 @@
+/***************************************************************************************************/
+/*
+   Host test of RGB to RGBW white extraction, see "ESP32_WS281x::setWhiteExtraction()"
+
+   NOTE:
+   - min extraction is exact, calibrated extraction is checked for what it
+     promises: subtracted tint never exceeds a channel, the limiting channel
+     is used up & W is clipped to full scale. Bulk writes & fills must give
+     the same pixels as single writes
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#define private   public                             //power sums are compared with full pass
+#define protected public
+#include "ESP32_WS281x.h"
+#undef private
+#undef protected
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN       5
+#define TEST_OTHER_PIN 6
+
+
+static uint8_t min3(uint8_t a, uint8_t b, uint8_t c)
+{
+  uint8_t m = (a < b) ? a : b;
+
+  return (m < c) ? m : c;
+}
+
+
+/*
+   Common part of R,G,B is moved to W, given W is added & clipped
+*/
+static void testMin()
+{
+  ESP32_WS281x strip(1, TEST_PIN, LED_GRBW);
+
+  strip.begin();
+  strip.setWhiteExtraction();
+
+  CHECK(strip.getWhiteExtraction() == LED_WHITE_MIN);
+
+  for (uint32_t n = 0; n < 100000; n++)
+  {
+    uint32_t color = testRandom();
+    uint8_t  r     = color >> 16;
+    uint8_t  g     = color >> 8;
+    uint8_t  b     = color;
+    uint8_t  w     = color >> 24;
+    uint8_t  m     = min3(r, g, b);
+    uint16_t white = m + w;
+
+    strip.setPixelColor(0, r, g, b, w);
+
+    uint32_t expected = ((uint32_t)((white > 255) ? 255 : white) << 24) | ((uint32_t)(r - m) << 16) | ((g - m) << 8) | (b - m);
+
+    if (strip.getPixelColor(0) != expected) {CHECK(strip.getPixelColor(0) == expected); break;}
+  }
+
+  strip.setPixelColor16(0, 0x1234, 0x8000, 0xFFFF);  //8-bit buffer, high bytes are converted
+
+  CHECK(strip.getPixelColor(0) == 0x12006EED);
+  CHECK(strip.setChannelDepth(16) == true);
+
+  strip.setPixelColor16(0, 0x1234, 0x8000, 0xFFFF);  //16-bit buffer, 0x1234 moved to W
+
+  CHECK(strip.getPixelColor(0) == 0x12006DED);
+  CHECK(strip.setChannelDepth(8) == true);
+
+  strip.setWhiteExtraction(LED_WHITE_NONE);
+  strip.setPixelColor(0, 10, 20, 30, 40);
+
+  CHECK(strip.getPixelColor(0) == 0x280A141E);
+
+  strip.end();
+}
+
+
+/*
+   Calibrated die color, e.g. warm white die has less blue than red
+*/
+static void testCalibrated()
+{
+  ESP32_WS281x strip(1, TEST_PIN, LED_GRBW);
+
+  strip.begin();
+
+  for (uint16_t n = 0; n < 200; n++)
+  {
+    uint32_t die     = (n == 0) ? ESP32_WS281x::colorKelvin(3000) : (testRandom() & 0xFFFFFF);
+    uint8_t  tint[3] = {(uint8_t)(die >> 16), (uint8_t)(die >> 8), (uint8_t)die};
+
+    if (die == 0) {continue;}
+
+    strip.setWhiteExtraction(die);
+
+    CHECK(strip.getWhiteExtraction() == die);
+
+    for (uint16_t k = 0; k < 500; k++)
+    {
+      uint32_t color = testRandom() & 0xFFFFFF;
+      uint8_t  in[3] = {(uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color};
+
+      strip.setPixelColor(0, in[0], in[1], in[2], 0);
+
+      uint32_t out    = strip.getPixelColor(0);
+      uint8_t  w      = out >> 24;
+      uint8_t  rgb[3] = {(uint8_t)(out >> 16), (uint8_t)(out >> 8), (uint8_t)out};
+      bool     valid  = true;
+      bool     usedUp = (w == 255);                   //W die is at full scale
+
+      for (uint8_t c = 0; c < 3; c++)
+      {
+        valid  &= (rgb[c] == in[c] - (w * tint[c]) / 255); //exactly the tint of extracted white is subtracted
+        usedUp |= (tint[c] != 0) && ((((uint32_t)w + 2) * tint[c]) >= ((uint32_t)in[c] * 255)); //w is within rounding of in / tint
+      }
+
+      if ((valid != true) || (usedUp != true)) {CHECK(valid && usedUp); break;}
+    }
+  }
+
+  strip.end();
+}
+
+
+/*
+   "setPixelColors()", "fill()" & "fillChannels()" convert same as single writes,
+   extraction is ignored on RGB strip
+*/
+static void testBulk()
+{
+  const uint16_t numLEDs = 100;
+  ESP32_WS281x   bulk(numLEDs, TEST_PIN, LED_GRBW);
+  ESP32_WS281x   single(numLEDs, TEST_OTHER_PIN, LED_GRBW);
+  ESP32_WS281x   rgb(1, TEST_PIN, LED_GRB);
+  uint32_t       colors[numLEDs];
+  uint8_t        channels[LED_MAX_CHANNELS] = {200, 150, 100, 10, 0};
+
+  bulk.begin();
+  single.begin();
+  rgb.begin();
+
+  bulk.setWhiteExtraction(ESP32_WS281x::colorKelvin(4000));
+  single.setWhiteExtraction(ESP32_WS281x::colorKelvin(4000));
+  rgb.setWhiteExtraction();
+
+  for (uint16_t i = 0; i < numLEDs; i++)
+  {
+    colors[i] = testRandom();
+
+    single.setPixelColor(i, colors[i]);
+  }
+
+  bulk.setPixelColors(0, colors, numLEDs);
+
+  for (uint16_t i = 0; i < numLEDs; i++)
+  {
+    if (bulk.getPixelColor(i) != single.getPixelColor(i)) {CHECK(bulk.getPixelColor(i) == single.getPixelColor(i)); break;}
+  }
+
+  bulk.fill(0x20C08040, 10, 20);
+  single.setPixelColor(10, 0x20C08040);
+
+  CHECK(bulk.getPixelColor(29) == single.getPixelColor(10));
+
+  bulk.fillChannels(channels, 50, 5);
+  single.setPixelColor(50, 200, 150, 100, 10);
+
+  CHECK(bulk.getPixelColor(54) == single.getPixelColor(50));
+
+  rgb.setPixelColor(0, 10, 20, 30);
+
+  CHECK(rgb.getPixelColor(0) == 0x0A141E);
+
+  bulk.end();
+  single.end();
+  rgb.end();
+}
+
+
+/*
+   Power sums kept while drawing see converted colors
+*/
+static void testPowerSum()
+{
+  const uint16_t numLEDs = 100;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRBW);
+  uint32_t       colors[10];
+  uint16_t       values[10 * 4];
+  uint32_t       sum[LED_MAX_CHANNELS];
+
+  strip.begin();
+  strip.setMaxCurrent(1000);
+  strip.setBrightness(180);
+  strip.setWhiteExtraction(ESP32_WS281x::colorKelvin(2700));
+
+  for (uint16_t n = 0; n < 1000; n++)
+  {
+    for (uint8_t j = 0; j < 10; j++)     {colors[j] = testRandom();}
+    for (uint8_t j = 0; j < 10 * 4; j++) {values[j] = testRandom();}
+
+    switch (testRandom() % 4)
+    {
+      case 0:  strip.setPixelColor(testRandom() % numLEDs, colors[0]); break;
+      case 1:  strip.setPixelColors(testRandom() % numLEDs, colors, 10); break;
+      case 2:  strip.fill(colors[0], testRandom() % numLEDs, 7); break;
+      default: strip.setPixelColor16(testRandom() % numLEDs, values[0], values[1], values[2], values[3]); break;
+    }
+  }
+
+  memcpy(sum, strip._powerSum[strip._backFrame], sizeof(sum));
+
+  strip.updatePowerSum(strip._backFrame);
+
+  CHECK(memcmp(sum, strip._powerSum[strip._backFrame], sizeof(sum)) == 0);
+
+  strip.end();
+}
+
+
+int main(int argc, char **argv)
+{
+  testMin();
+  testCalibrated();
+  testBulk();
+  testPowerSum();
+
+  return testDone("test_white");
+}
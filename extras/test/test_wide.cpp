@@ -0,0 +1,403 @@
+/***************************************************************************************************/
+/*
+   Host test of 16-bit channels, see "ESP32_WS281x::setChannelDepth()"
+
+   NOTE:
+   - wire bytes of RMT strip & of every line of I2S virtual strip are decoded
+     back to 16-bit values, MSB first. Power sums are checked against a full
+     pass after random edits
+
+   written by : enjoyneering
+   sourse code: https://github.com/enjoyneering/
+
+   GNU GPL license, all text above must be included in any redistribution,
+   see link for details - https://www.gnu.org/licenses/licenses.html
+*/
+/***************************************************************************************************/
+
+
+#define private   public                             //power sums are compared with full pass
+#define protected public
+#include "ESP32_WS281x.h"
+#undef private
+#undef protected
+
+#include "ESP32_I2S.h"
+
+#include "stub.h"
+#include "test.h"
+
+
+#define TEST_PIN       5
+#define TEST_CLOCK_PIN 40
+#define TEST_DC_PIN    41
+#define TEST_FIRST_PIN 1
+
+
+/*
+   Decode bytes of one I2S bus line, see "test_i2s.cpp"
+*/
+static uint32_t decodeLine(const uint8_t *frame, uint32_t numBytes, uint8_t line, uint8_t *out)
+{
+  uint32_t bits = 0;
+
+  for (uint32_t w = 0; (w + 2) < numBytes; w += 3)
+  {
+    if (((frame[w]     >> line) & 1) == 0) {break;}  //end of line
+    if (((frame[w + 2] >> line) & 1) != 0) {return 0xFFFFFFFF;}
+
+    if ((bits % 8) == 0) {out[bits / 8] = 0;}
+
+    out[bits / 8] |= ((frame[w + 1] >> line) & 1) << (7 - (bits % 8));
+
+    bits++;
+  }
+
+  return ((bits % 8) == 0) ? (bits / 8) : 0xFFFFFFFF;
+}
+
+
+/*
+   Compare 16-bit wire values with expected ones in wire order
+*/
+static bool checkWire(const uint8_t *wire, uint32_t numBytes, const uint16_t *expected, uint32_t numValues)
+{
+  if ((wire == NULL) || (numBytes != numValues * 2)) {return false;}
+
+  for (uint32_t i = 0; i < numValues; i++)
+  {
+    if ((((uint16_t)wire[i * 2] << 8) | wire[i * 2 + 1]) != expected[i]) {return false;}
+  }
+
+  return true;
+}
+
+
+/*
+   Compare last RMT frame with expected values
+*/
+static bool checkRmt(const uint16_t *expected, uint32_t numValues)
+{
+  uint32_t       numBytes = 0;
+  const uint8_t *wire     = stubRmtFrame(TEST_PIN, &numBytes);
+
+  return checkWire(wire, numBytes, expected, numValues);
+}
+
+
+/*
+   RMT strip, single pixel, bulk & 8-bit API. Values in wire order, G,R,B(,W)
+*/
+static void testDepth(ledPixelType ledType, uint8_t bytesPerPixel)
+{
+  const uint16_t numLEDs = 60;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, ledType);
+  uint16_t       values[numLEDs * 4];
+  uint16_t       expected[numLEDs * 4];
+  uint32_t       numBytes = 0;
+
+  strip.begin();
+
+  CHECK(strip.getChannelDepth() == 8);
+  CHECK(strip.setChannelDepth(12) == false);
+  CHECK(strip.setChannelDepth(16) == true);
+  CHECK(strip.getChannelDepth() == 16);
+
+  for (uint16_t i = 0; i < numLEDs; i++)
+  {
+    uint16_t r = testRandom();
+    uint16_t g = testRandom();
+    uint16_t b = testRandom();
+    uint16_t w = testRandom();
+
+    if (bytesPerPixel == 4) {strip.setPixelColor16(i, r, g, b, w);}
+    else                    {strip.setPixelColor16(i, r, g, b);}
+
+    expected[i * bytesPerPixel + 0] = g;
+    expected[i * bytesPerPixel + 1] = r;
+    expected[i * bytesPerPixel + 2] = b;
+
+    if (bytesPerPixel == 4) {expected[i * bytesPerPixel + 3] = w;}
+
+    uint32_t color = ((uint32_t)(r >> 8) << 16) | ((g >> 8) << 8) | (b >> 8); //8-bit read back
+
+    if (bytesPerPixel == 4) {color |= (uint32_t)(w >> 8) << 24;}
+
+    if (strip.getPixelColor(i) != color) {CHECK(strip.getPixelColor(i) == color); break;}
+  }
+
+  strip.show();
+
+  CHECK(checkRmt(expected, numLEDs * bytesPerPixel) == true);
+
+  for (uint16_t i = 0; i < numLEDs; i++)            //bulk ingest, R,G,B(,W) order
+  {
+    for (uint8_t j = 0; j < bytesPerPixel; j++) {values[i * bytesPerPixel + j] = testRandom();}
+
+    expected[i * bytesPerPixel + 0] = values[i * bytesPerPixel + 1];
+    expected[i * bytesPerPixel + 1] = values[i * bytesPerPixel + 0];
+    expected[i * bytesPerPixel + 2] = values[i * bytesPerPixel + 2];
+
+    if (bytesPerPixel == 4) {expected[i * bytesPerPixel + 3] = values[i * bytesPerPixel + 3];}
+  }
+
+  strip.setPixelColors16(0, values, numLEDs);
+  strip.show();
+
+  CHECK(checkRmt(expected, numLEDs * bytesPerPixel) == true);
+
+  for (uint16_t i = 0; i < numLEDs; i++)            //8-bit API, value * 257
+  {
+    uint32_t color = testRandom();
+
+    strip.setPixelColor(i, color);
+
+    expected[i * bytesPerPixel + 0] = ((color >> 8)  & 0xFF) * 257;
+    expected[i * bytesPerPixel + 1] = ((color >> 16) & 0xFF) * 257;
+    expected[i * bytesPerPixel + 2] = (color         & 0xFF) * 257;
+
+    if (bytesPerPixel == 4) {expected[i * bytesPerPixel + 3] = (color >> 24) * 257;}
+  }
+
+  strip.show();
+
+  CHECK(checkRmt(expected, numLEDs * bytesPerPixel) == true);
+
+  CHECK(strip.setChannelDepth(8) == true);           //back to 8-bit, colors are kept
+  CHECK(strip.getChannelDepth() == 8);
+
+  strip.show();
+
+  const uint8_t *wire = stubRmtFrame(TEST_PIN, &numBytes);
+
+  CHECK((wire != NULL) && (numBytes == numLEDs * bytesPerPixel));
+
+  for (uint32_t i = 0; (wire != NULL) && (i < numBytes); i++)
+  {
+    if (wire[i] != (expected[i] >> 8)) {CHECK(wire[i] == (expected[i] >> 8)); break;}
+  }
+
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+/*
+   Brightness scales 16-bit values, identity curve gives values back & 8-bit
+   full white is 0xFFFF with & without correction tables
+*/
+static void testCorrection()
+{
+  static uint8_t curve[256];
+  ESP32_WS281x   strip(1, TEST_PIN, LED_GRB);
+  uint16_t       expected[3];
+
+  for (uint16_t i = 0; i < 256; i++) {curve[i] = i;}
+
+  strip.begin();
+  strip.setBrightness(127);                         //128/256
+
+  CHECK(strip.setChannelDepth(16) == true);
+
+  strip.setPixelColor16(0, 0x8000, 0xFFFF, 0x1235);
+
+  expected[0] = 0x7FFF;
+  expected[1] = 0x4000;
+  expected[2] = 0x091A;
+
+  strip.show();
+
+  CHECK(checkRmt(expected, 3) == true);
+
+  strip.setBrightness(255);
+
+  for (uint8_t channel = LED_CHANNEL_R; channel <= LED_CHANNEL_B; channel++) {strip.setChannelCurve(channel, curve);}
+
+  strip.setPixelColor16(0, 0x1234, 0xABCD, 0xFF00);
+
+  expected[0] = 0xABCD;
+  expected[1] = 0x1234;
+  expected[2] = 0xFF00;
+
+  strip.show();
+
+  CHECK(checkRmt(expected, 3) == true);
+
+  for (uint8_t channel = LED_CHANNEL_R; channel <= LED_CHANNEL_B; channel++) {strip.setChannelCurve(channel, (const uint8_t *)NULL);}
+
+  strip.setGamma(2.6);
+
+  strip.setPixelColor16(0, 0xFFFF, 0, 0xFFFF);
+
+  expected[0] = 0;
+  expected[1] = 0xFFFF;
+  expected[2] = 0xFFFF;
+
+  strip.show();
+
+  CHECK(checkRmt(expected, 3) == true);
+
+  strip.setPixelColor(0, 255, 0, 255);              //8-bit ends, gamma table
+
+  expected[0] = 0;
+
+  strip.show();
+
+  CHECK(checkRmt(expected, 3) == true);
+
+  strip.setGamma(1.0);                              //no table
+
+  strip.show();
+
+  CHECK(checkRmt(expected, 3) == true);
+
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+/*
+   Power sums kept while drawing match full pass after random edits
+*/
+static void testPowerSum()
+{
+  const uint16_t numLEDs = 100;
+  ESP32_WS281x   strip(numLEDs, TEST_PIN, LED_GRBW);
+  uint16_t       values[10 * 4];
+  uint32_t       sum[4];
+
+  strip.begin();
+  strip.setMaxCurrent(1000);
+  strip.setBrightness(200);
+
+  CHECK(strip.setChannelDepth(16) == true);
+
+  for (uint16_t n = 0; n < 1000; n++)
+  {
+    switch (testRandom() % 3)
+    {
+      case 0:
+        strip.setPixelColor16(testRandom() % numLEDs, testRandom(), testRandom(), testRandom(), testRandom());
+        break;
+
+      case 1:
+        for (uint8_t j = 0; j < 10 * 4; j++) {values[j] = testRandom();}
+
+        strip.setPixelColors16(testRandom() % numLEDs, values, 10);
+        break;
+
+      default:
+        strip.setPixelColor(testRandom() % numLEDs, testRandom());
+        break;
+    }
+  }
+
+  memcpy(sum, strip._powerSum[strip._backFrame], sizeof(sum));
+
+  strip.updatePowerSum(strip._backFrame);
+
+  CHECK(memcmp(sum, strip._powerSum[strip._backFrame], sizeof(sum)) == 0);
+
+  strip.end();
+}
+
+
+/*
+   Dithering & 16-bit channels are mutually exclusive, see "setChannelDepth()"
+*/
+static void testSwitch()
+{
+  ESP32_WS281x strip(10, TEST_PIN, LED_GRB);
+  ESP32_WS281x empty;
+
+  CHECK(empty.setChannelDepth(16) == false);         //empty strip
+
+  strip.begin();
+  strip.setPixelColor(3, 0x123456);
+
+  CHECK(strip.setDithering(true) == true);
+  CHECK(strip.setChannelDepth(16) == true);          //dithering is turned off
+  CHECK(strip.getDithering() == false);
+  CHECK(strip.getPixelColor(3) == 0x123456);
+  CHECK(strip.setDithering(true) == false);
+  CHECK(strip.setDithering(false) == true);
+  CHECK(strip.setTripleBuffering(true) == false);
+  CHECK(strip.setChannelDepth(8) == true);
+  CHECK(strip.setTripleBuffering(true) == true);
+  CHECK(strip.setChannelDepth(16) == false);         //triple buffering enabled
+
+  strip.end();
+}
+
+
+/*
+   I2S virtual strip, every line carries 2 bytes per color byte
+*/
+static void testI2s()
+{
+  int8_t         pins[3]    = {TEST_FIRST_PIN, TEST_FIRST_PIN + 1, TEST_FIRST_PIN + 2};
+  ledIndexType   lengths[3] = {7, 20, 13};
+  ESP32_WS281x   strip;
+  uint16_t       expected[40 * 3];
+  ledIndexType   first      = 0;
+
+  espI2sSetClockPin(TEST_CLOCK_PIN);
+  espI2sSetDcPin(TEST_DC_PIN);
+  espI2sSetIncremental(false);
+
+  CHECK(strip.setOutput(&espOutputI2S) == true);
+  CHECK(strip.setPins(pins, lengths, 3) == true);
+  CHECK(strip.setChannelDepth(16) == true);
+
+  strip.begin();
+
+  for (ledIndexType i = 0; i < 40; i++)
+  {
+    uint16_t r = testRandom();
+    uint16_t g = testRandom();
+    uint16_t b = testRandom();
+
+    strip.setPixelColor16(i, r, g, b);
+
+    expected[i * 3 + 0] = g;
+    expected[i * 3 + 1] = r;
+    expected[i * 3 + 2] = b;
+  }
+
+  strip.show();
+
+  uint32_t       numBytes = 0;
+  uint8_t        busWidth = 0;
+  const int     *busPins  = NULL;
+  const uint8_t *frame    = stubLcdFrame(&numBytes, &busWidth, &busPins);
+
+  CHECK((frame != NULL) && (busWidth == 8));
+
+  for (uint8_t line = 0; (frame != NULL) && (line < 3); line++)
+  {
+    uint8_t bytes[40 * 3 * 2];
+
+    CHECK(checkWire(bytes, decodeLine(frame, numBytes, line, bytes), &expected[first * 3], lengths[line] * 3) == true);
+
+    first += lengths[line];
+  }
+
+  strip.end();
+
+  CHECK(stubErrors() == 0);
+}
+
+
+int main(int argc, char **argv)
+{
+  testDepth(LED_GRB,  3);
+  testDepth(LED_GRBW, 4);
+  testCorrection();
+  testPowerSum();
+  testSwitch();
+  testI2s();
+
+  return testDone("test_wide");
+}